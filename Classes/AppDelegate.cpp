@@ -1,7 +1,8 @@
 
 #include "AppDelegate.h"
 #include "HelloWorldScene.h"
-#include "GameScene.h"
+#include "LoadingScene.h"
+#include "core/Log.h"
 
 // 音频引擎配置（目前都注释掉了，表示不使用音频）
 // #define USE_AUDIO_ENGINE 1
@@ -42,10 +43,12 @@ AppDelegate::AppDelegate()
 
 /**
  * 析构函数：销毁AppDelegate对象
- * 在程序退出时调用，清理音频引擎资源
+ * 在程序退出时调用，清理音频引擎资源，输出剩下的日志
  */
 AppDelegate::~AppDelegate() 
 {
+    Log::stop();
+    
 #if USE_AUDIO_ENGINE
     AudioEngine::end();  // 结束音频引擎
 #elif USE_SIMPLE_AUDIO_ENGINE
@@ -153,6 +156,9 @@ static void setupResourcePaths()
  * 这是游戏初始化的核心方法，按顺序执行以下步骤：
  */
 bool AppDelegate::applicationDidFinishLaunching() {
+    // 启动日志输出线程（GAME_LOG_xxx在这之前写的日志也会输出）
+    Log::start();
+    
     // 步骤1：初始化Director和OpenGL视图
     cocos2d::Director* director = nullptr;
     cocos2d::GLView* glview = nullptr;
@@ -172,8 +178,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
     // 步骤5：添加资源搜索路径
     setupResourcePaths();
 
-    // 步骤6：创建第一个游戏场景并运行
-    auto scene = GameScene::create();
+    // 步骤6：创建加载场景并运行（预加载所有图片之后再切换到游戏场景）
+    auto scene = LoadingScene::create();
     if (!scene) {
         return false;
     }
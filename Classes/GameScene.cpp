@@ -1,8 +1,12 @@
 #include "GameScene.h"
+#include "core/Log.h"
+#include "core/Trace.h"
 #include "cocos2d.h"
 
 USING_NS_CC;  // 使用cocos2d命名空间
 
+const int GameScene::kTraceDumpSeconds;
+
 /**
  * 创建GameScene对象（静态工厂方法）
  * 
@@ -39,6 +43,13 @@ bool GameScene::init() {
     // 先初始化父类Scene（必须的，否则场景无法正常工作）
     if (!Scene::init()) return false;
     
+    TRACE_THREAD_NAME("main");
+    
+    // 加载卡牌图集（必须在创建卡牌视图之前）
+    // 优先使用预合成卡面（每张牌一个精灵），没有时退回分开的精灵；没有图集时卡牌使用单独的图片
+    // 纹理已经由LoadingScene预加载，这里只建立精灵帧，不解码图片
+    CardView::loadCardImages();
+    
     // 创建游戏视图（GameView）
     // GameView负责显示游戏的所有UI元素：卡牌、按钮等
     _gameView = GameView::create();
@@ -54,13 +65,39 @@ bool GameScene::init() {
     // GameController负责处理游戏逻辑：卡牌点击、匹配、回退等
     _gameController = new GameController(_gameView);
     if (_gameController) {
-        // 启动游戏：初始化卡牌、设置游戏状态等
-        _gameController->startGame();
+        // 映射关卡包：只检查文件头，和关卡数量无关
+        // 注意：Android上关卡包要先从APK拷贝到可写目录才能映射
+        std::string packPath = FileUtils::getInstance()->fullPathForFilename("levels.pack");
+        bool hasLevelPack = !packPath.empty() && _levelPack.open(packPath);
+        if (hasLevelPack) {
+            _gameController->setLevelPack(&_levelPack);
+        }
+        
+        // 启动游戏：有关卡包时从第一关开始，否则（或者第一关读取失败时）使用写死的初始卡牌
+        if (!hasLevelPack || !_gameController->startGame(0)) {
+            _gameController->startGame();
+        }
     }
     
+#if CARDGAME_TRACE
+    createTraceDumpListener();
+#endif
+    
     return true;  // 初始化成功
 }
 
+void GameScene::createTraceDumpListener() {
+    auto listener = EventListenerKeyboard::create();
+    listener->onKeyReleased = [](EventKeyboard::KeyCode keyCode, Event* event) {
+        if (keyCode != EventKeyboard::KeyCode::KEY_F12) return;
+        std::string path = FileUtils::getInstance()->getWritablePath() + "trace.json";
+        int events = Trace::exportChromeJson(path, kTraceDumpSeconds);
+        (void)events;  // 发布版INFO日志不编译
+        GAME_LOG_INFO("trace: %d events -> %s", events, path.c_str());
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+}
+
 /**
  * 析构函数：销毁GameScene对象
  * 
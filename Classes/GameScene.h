@@ -2,6 +2,7 @@
 #include "cocos2d.h"
 #include "views/GameView.h"
 #include "controllers/GameController.h"
+#include "core/LevelPack.h"
 
 /**
  * @brief GameScene - 游戏主场景类
@@ -13,6 +14,7 @@
  * - 创建和管理游戏视图（GameView）
  * - 创建和管理游戏控制器（GameController）
  * - 协调视图和控制器之间的交互
+ * - 启动时映射关卡包（levels.pack），交给控制器按关卡下标开局
  * 
  * 使用场景：
  * - 游戏启动时作为第一个场景
@@ -29,8 +31,16 @@ public:
     virtual bool init();
     virtual ~GameScene();
 
+    static const int kTraceDumpSeconds = 10;   // 按F12导出最近多少秒的追踪记录（CARDGAME_TRACE=1时）
+
 private:
     GameView* _gameView;
     GameController* _gameController;
+    LevelPack _levelPack;       // 关卡包（内存映射，场景销毁时解除映射）
+    
+    /**
+     * 按F12把最近kTraceDumpSeconds秒的追踪记录导出到可写目录的trace.json（只在CARDGAME_TRACE=1时注册）
+     */
+    void createTraceDumpListener();
 };
 
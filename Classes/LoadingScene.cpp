@@ -0,0 +1,80 @@
+#include "LoadingScene.h"
+#include "GameScene.h"
+#include "core/Log.h"
+#include "views/GameView.h"
+
+USING_NS_CC;
+
+static const float kBarWidth = 600.0f;
+static const float kBarHeight = 20.0f;
+
+LoadingScene* LoadingScene::create() {
+    LoadingScene* ret = new (std::nothrow) LoadingScene();
+    if (ret && ret->init()) {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+/**
+ * 界面：屏幕中间一行进度文字，下面一个进度条（设计分辨率1080x2080）
+ */
+bool LoadingScene::init() {
+    if (!Scene::init()) return false;
+
+    _progressLabel = Label::createWithSystemFont("加载中 0%", "", 36);
+    _progressLabel->setPosition(Vec2(540, 1080));
+    this->addChild(_progressLabel);
+
+    auto track = LayerColor::create(Color4B(80, 80, 80, 255), kBarWidth, kBarHeight);
+    track->setPosition(Vec2(540 - kBarWidth / 2, 1000));
+    this->addChild(track);
+
+    _progressBar = LayerColor::create(Color4B(240, 240, 240, 255), kBarWidth, kBarHeight);
+    _progressBar->setAnchorPoint(Vec2(0, 0));
+    _progressBar->setScaleX(0);
+    track->addChild(_progressBar);
+    return true;
+}
+
+/**
+ * 场景显示后才开始加载（第一帧先把加载界面画出来）
+ */
+void LoadingScene::onEnter() {
+    Scene::onEnter();
+    if (_started) return;
+    _started = true;
+
+    std::vector<std::string> paths;
+    GameView::collectPreloadImages(paths);
+    _preloader.start(paths, [this](int loaded, int total) {
+        showProgress(loaded, total);
+    }, [this]() {
+        enterGame();
+    });
+}
+
+void LoadingScene::showProgress(int loaded, int total) {
+    float progress = total > 0 ? (float)loaded / total : 1.0f;
+    _progressBar->setScaleX(progress);
+    _progressLabel->setString("加载中 " + std::to_string((int)(progress * 100)) + "%");
+}
+
+/**
+ * 解码失败的图片不阻止进入游戏（和没有预加载时一样，由用到它的精灵处理）
+ * 切换场景放到下一帧：完成回调可能是在start()里同步调用的，这时场景还没有切换完成
+ */
+void LoadingScene::enterGame() {
+    showProgress(1, 1);
+    if (_preloader.getFailedCount() > 0) {
+        GAME_LOG_WARN("LoadingScene: %d images failed to load", _preloader.getFailedCount());
+    }
+    scheduleOnce([](float) {
+        auto scene = GameScene::create();
+        if (scene) {
+            Director::getInstance()->replaceScene(scene);
+        }
+    }, 0, "enterGame");
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "cocos2d.h"
+#include "managers/TexturePreloader.h"
+
+/**
+ * @brief LoadingScene - 加载场景
+ *
+ * 启动时的第一个场景：后台线程并行解码游戏界面用到的所有图片（背景、卡牌图集），
+ * 显示加载进度，全部放进TextureCache之后才切换到GameScene。
+ * 这样GameScene创建卡牌、第一次updateView时纹理都已经在缓存里，主线程不再解码图片。
+ *
+ * 使用场景：
+ * - AppDelegate启动时作为第一个场景运行
+ */
+class LoadingScene : public cocos2d::Scene {
+public:
+    static LoadingScene* create();
+    virtual bool init();
+    virtual void onEnter();
+
+private:
+    cocos2d::Label* _progressLabel;         // 进度文字
+    cocos2d::LayerColor* _progressBar;      // 进度条（按进度横向缩放）
+    TexturePreloader _preloader;
+    bool _started = false;
+
+    /**
+     * 更新进度显示
+     */
+    void showProgress(int loaded, int total);
+
+    /**
+     * 全部加载完成，切换到游戏场景
+     */
+    void enterGame();
+};
@@ -1,10 +1,18 @@
 #include "GameController.h"
+#include "core/Log.h"
+#include "core/Trace.h"
 #include "views/CardView.h"
 #include "views/StackView.h"
 #include "cocos2d.h"
 
 USING_NS_CC;  // 使用cocos2d命名空间
 
+static const char* kReplayScheduleKey = "GameController::replay";
+static const char* kFrameScheduleKey = "GameController::frame";
+static const int kMaxQueuedCommands = 16;         // 一帧最多排队的输入（超出的丢掉）
+static const float kMoveAnimationSeconds = 0.3f;  // 和CardView::playMoveAnimation的时长一致
+static const int kCardViewPoolSize = 64;          // 预先创建的卡牌视图数（一局最多52张，留一些余量）
+
 /**
  * 构造函数：创建游戏控制器
  * 
@@ -16,8 +24,26 @@ USING_NS_CC;  // 使用cocos2d命名空间
  * 
  * @param view 游戏视图指针，控制器通过它来更新UI
  */
-GameController::GameController(GameView* view) : _gameView(view) {
+GameController::GameController(GameView* view)
+    : _gameView(view), _levelPack(nullptr), _hasReplayEvent(false), _replaying(false), _replaySpeed(1.0f),
+      _replayClockMs(0.0), _replayAnimationCooldown(0.0f), _latencyInput(-1), _redoing(false) {
+    // 游戏逻辑执行/回退操作后，通过GameObserver接口通知控制器更新视图
+    _gameLogic.setObserver(this);
+    
     if (_gameView) {
+        // 预先创建卡牌视图，之后开局、回退都从对象池取
+        _cardViewPool.prewarm(kCardViewPoolSize);
+        _commands.reserve(kMaxQueuedCommands);
+        _retiringViews.reserve(kMaxQueuedCommands);
+        
+        // 每帧执行排队的输入
+        Director::getInstance()->getScheduler()->schedule([this](float dt) {
+            updateFrame(dt);
+        }, this, 0.0f, false, kFrameScheduleKey);
+        
+        // 触摸到卡牌时开始一次输入，统计到动画完成的延迟
+        _gameView->setLatencyTracker(&_latencyTracker);
+        
         // 设置卡牌点击回调
         // 当玩家点击任何卡牌时，会调用onCardClicked方法
         // 使用lambda表达式捕获this指针，这样可以在回调中访问GameController的成员
@@ -30,6 +56,11 @@ GameController::GameController(GameView* view) : _gameView(view) {
         _gameView->setOnUndoClickCallback([this]() {
             onUndoClicked();
         });
+        
+        // 设置重做按钮点击回调
+        _gameView->setOnRedoClickCallback([this]() {
+            onRedoClicked();
+        });
     }
 }
 
@@ -41,7 +72,20 @@ GameController::GameController(GameView* view) : _gameView(view) {
  */
 GameController::~GameController() {
     // 视图由场景管理，不需要手动释放
-    // GameModel和UndoManager是栈对象，会自动释放
+    // GameLogic是栈对象，会自动释放
+    stopReplay();
+    _gameLogic.setObserver(nullptr);
+    
+    // 退出时保存输入延迟统计
+    if (_gameView) {
+        Director::getInstance()->getScheduler()->unschedule(kFrameScheduleKey, this);
+        _gameView->setLatencyTracker(nullptr);
+        saveLatencyReport(FileUtils::getInstance()->getWritablePath() + "latency.csv");
+    }
+}
+
+bool GameController::saveLatencyReport(const std::string& path) const {
+    return FileUtils::getInstance()->writeStringToFile(_latencyTracker.formatReport(), path);
 }
 
 /**
@@ -55,11 +99,9 @@ GameController::~GameController() {
  * 注意：这里硬编码了初始卡牌配置，实际项目中应该从配置文件读取
  */
 void GameController::startGame() {
-    // 清空游戏模型（移除所有卡牌，重置ID计数器）
-    _gameModel.clear();
-    
-    // 清空回退管理器（移除所有历史记录）
-    _undoManager.clear();
+    // 清空游戏模型（移除所有卡牌，重置ID计数器）和回退记录，还没执行的输入属于上一局
+    _gameLogic.reset();
+    _commands.clear();
     
     // 初始化主牌区卡牌
     initializePlayfieldCards();
@@ -67,264 +109,626 @@ void GameController::startGame() {
     // 初始化底牌堆卡牌
     initializeStackCards();
     
+    // 开始录制回放：这个开局是写死的，所以把所有卡牌写进回放
+    _recorder.beginWithModel(_gameLogic.getModel());
+    _startTime = std::chrono::steady_clock::now();
+    
     // 创建视图：根据模型数据创建所有卡牌的UI显示
     updateView();
 }
 
 /**
- * 更新视图
+ * 用种子开始游戏
+ *
+ * 和startGame()一样，只是卡牌不是写死的，而是由DealGenerator根据种子生成。
+ * 同一个种子和参数总是得到同一局牌，所以关卡只需要保存种子
+ */
+void GameController::startGameWithSeed(uint64_t seed, const DealOptions& options) {
+    _gameLogic.reset();
+    _commands.clear();
+
+    Deal deal;
+    DealGenerator::generate(seed, options, deal);
+    deal.applyTo(_gameLogic.getModel());
+
+    // 种子开局的回放只需要保存种子和参数
+    _recorder.beginWithSeed(seed, options);
+    _startTime = std::chrono::steady_clock::now();
+
+    updateView();
+}
+
+/**
+ * 从关卡包开始一关
+ * 先读出这一关（校验失败时不修改当前游戏），再像startGame()一样开局
+ * 关卡包里的关卡没有种子，回放里保存完整的开局卡牌
+ */
+bool GameController::startGame(int levelIndex) {
+    // 没有关卡包是正常情况（使用写死的初始卡牌），不输出警告
+    if (!_levelPack) return false;
+    Deal deal;
+    if (!_levelPack->getLevel(levelIndex, deal)) {
+        GAME_LOG_WARN("关卡读取失败: levelIndex=%d", levelIndex);
+        return false;
+    }
+
+    _gameLogic.reset();
+    _commands.clear();
+    deal.applyTo(_gameLogic.getModel());
+
+    _recorder.beginWithModel(_gameLogic.getModel());
+    _startTime = std::chrono::steady_clock::now();
+
+    updateView();
+    return true;
+}
+
+/**
+ * 更新视图（按卡牌ID对比模型和现有视图，只修改有变化的部分）
  * 
  * 这个方法根据游戏模型（GameModel）的数据，更新游戏视图（GameView）
- * 当游戏状态改变时（比如添加/移除卡牌），需要调用这个方法来同步视图
+ * 当游戏状态整体改变时（开局、跳转、回放），需要调用这个方法来同步视图
  * 
  * 流程：
- * 1. 清空所有现有的卡牌视图
- * 2. 根据模型数据重新创建所有卡牌视图
- * 3. 更新回退按钮的显示状态
+ * 1. 回收退场的视图；现有的卡牌视图按卡牌ID建立索引，并停止它们的动画
+ * 2. 模型中的每张牌找到同ID的视图复用：牌不同就原地重置，区域不同就移过去，正反面不同就修改，
+ *    主牌区的坐标交给主牌区在绘制前统一设置（只设置有变化的）；
+ *    找不到才从对象池取视图
+ * 3. 没有被复用的视图还给对象池
+ * 4. 底牌堆一次性按模型顺序排列，绘制前统一布局一次
+ * 5. 更新回退、重做按钮的显示状态
+ * 
+ * 重新开局、回退很多步之后，卡牌视图都不需要重新创建
  */
 void GameController::updateView() {
+    TRACE_ZONE("GameController::updateView");
     if (!_gameView) return;  // 如果视图为空，直接返回
     
     // 获取主牌区视图和底牌堆视图
     auto playfieldView = _gameView->getPlayfieldView();
     auto stackView = _gameView->getStackView();
-    
-    // 步骤1：清空视图 - 移除所有现有卡牌视图
-    // 先移除主牌区的所有卡牌
-    for (auto* card : playfieldView->getCards()) {
-        playfieldView->removeCard(card);
+    const GameModel& model = _gameLogic.getModel();
+    
+    // 步骤1：现有视图按卡牌ID建立索引（退场的视图直接回收）
+    releaseRetiringViews(true);
+    // ID超出范围或者重复的视图直接作废
+    _viewsById.assign(model.peekNextCardId(), nullptr);
+    _staleViews.clear();
+    auto indexView = [this](CardView* cardView) {
+        cardView->stopMoveAnimation();
+        int cardId = cardView->getCardId();
+        if (cardId >= 0 && cardId < (int)_viewsById.size() && !_viewsById[cardId]) {
+            _viewsById[cardId] = cardView;
+        } else {
+            _staleViews.push_back(cardView);
+        }
+    };
+    for (auto* cardView : playfieldView->getCards()) indexView(cardView);
+    for (auto* cardView : stackView->getCards()) indexView(cardView);
+    
+    // 步骤2：主牌区卡牌，复用或创建视图
+    for (const auto& cardModel : model.getPlayfieldCards()) {
+        CardView* cardView = takeCardView(cardModel);
+        if (!cardView) {
+            cardView = createCardView(cardModel);
+            if (!cardView) continue;
+            playfieldView->addCard(cardView);
+        } else if (cardView->getParent() != playfieldView) {
+            // 原来在底牌堆（先retain，防止removeChild时被释放）
+            cardView->retain();
+            stackView->removeCard(cardView);
+            playfieldView->addCard(cardView);
+            cardView->release();
+        }
+        syncCardView(cardView, cardModel);
+        playfieldView->setCardPosition(cardView, Vec2(cardModel.posX, cardModel.posY));
     }
-    // 再移除底牌堆的所有卡牌
-    for (auto* card : stackView->getCards()) {
-        stackView->removeCard(card);
+    
+    // 步骤3：底牌堆卡牌，复用或创建视图，并记下模型中的顺序
+    _stackOrder.clear();
+    for (const auto& cardModel : model.getStackCards()) {
+        CardView* cardView = takeCardView(cardModel);
+        if (!cardView) {
+            cardView = createCardView(cardModel);
+            if (!cardView) continue;
+            stackView->addCard(cardView);
+        } else if (cardView->getParent() != stackView) {
+            cardView->retain();
+            playfieldView->removeCard(cardView);
+            stackView->addCard(cardView);
+            cardView->release();
+        }
+        syncCardView(cardView, cardModel);
+        _stackOrder.push_back(cardView);
     }
     
-    // 步骤2：创建主牌区卡牌视图
-    // 遍历模型中的每张主牌区卡牌，创建对应的视图
-    for (const auto& cardModel : _gameModel.playfieldCards) {
-        // 创建卡牌视图（传入点数、花色、是否正面朝上）
-        auto* cardView = CardView::create(cardModel.face, cardModel.suit, cardModel.isFaceUp);
-        cardView->setCardId(cardModel.id);  // 设置卡牌ID（用于识别卡牌）
-        cardView->setPosition(Vec2(cardModel.posX, cardModel.posY));  // 设置卡牌位置
-        playfieldView->addCard(cardView);  // 添加到主牌区视图
+    // 步骤4：没有被复用的视图还给对象池
+    for (auto* cardView : _viewsById) {
+        if (cardView) _staleViews.push_back(cardView);
+    }
+    for (auto* cardView : _staleViews) {
+        recycleCardView(cardView);
     }
     
-    // 步骤3：创建底牌堆卡牌视图
-    // 遍历模型中的每张底牌堆卡牌，创建对应的视图
-    for (const auto& cardModel : _gameModel.stackCards) {
-        // 创建卡牌视图
-        auto* cardView = CardView::create(cardModel.face, cardModel.suit, cardModel.isFaceUp);
-        cardView->setCardId(cardModel.id);  // 设置卡牌ID
+    // 步骤5：底牌堆按模型顺序排列，绘制前统一布局
+    stackView->setCardOrder(_stackOrder);
+    
+    // 步骤6：更新回退、重做按钮的显示状态
+    // 如果可以回退/重做，显示按钮；否则隐藏按钮
+    updateTimelineButtons();
+    
+    TRACE_COUNTER("playfield.cards", model.getPlayfieldCards().size());
+    TRACE_COUNTER("stack.cards", model.getStackCards().size());
+    TRACE_COUNTER("cardViewPool.idle", _cardViewPool.getIdleCount());
+}
+
+/**
+ * 取出可以复用的视图：ID相同
+ * ID相同但是牌不同（比如重新开局后ID重新分配）的视图原地重置成模型中的牌
+ */
+CardView* GameController::takeCardView(const CardModel& cardModel) {
+    if (cardModel.id < 0 || cardModel.id >= (int)_viewsById.size()) return nullptr;
+    CardView* cardView = _viewsById[cardModel.id];
+    _viewsById[cardModel.id] = nullptr;
+    if (cardView && (cardView->getCardFace() != cardModel.face || cardView->getCardSuit() != cardModel.suit)) {
+        cardView->reset(cardModel.face, cardModel.suit, cardModel.isFaceUp);
+    }
+    return cardView;
+}
+
+/**
+ * 从对象池取卡牌视图（传入点数、花色、是否正面朝上、ID），并设置位置
+ */
+CardView* GameController::createCardView(const CardModel& cardModel) {
+    auto* cardView = _cardViewPool.acquire(cardModel.face, cardModel.suit, cardModel.isFaceUp, cardModel.id);
+    if (cardView) {
         cardView->setPosition(Vec2(cardModel.posX, cardModel.posY));  // 设置卡牌位置
-        stackView->addCard(cardView);  // 添加到底牌堆视图（会自动布局）
     }
-    
-    // 步骤4：更新回退按钮的显示状态
-    // 如果可以回退，显示按钮；如果不能回退，隐藏按钮
-    _gameView->showUndoButton(_undoManager.canUndo());
+    return cardView;
+}
+
+/**
+ * 先还给对象池（池子持有引用，removeChild时不会被释放），再从区域移除
+ * removeCard会忽略不在自己区域里的视图；退场的视图不在区域的列表里，直接从父节点移除
+ */
+void GameController::recycleCardView(CardView* cardView) {
+    _cardViewPool.release(cardView);
+    _gameView->getPlayfieldView()->removeCard(cardView);
+    _gameView->getStackView()->removeCard(cardView);
+    if (cardView->getParent()) {
+        cardView->removeFromParent();
+    }
+}
+
+/**
+ * 让复用的视图和模型一致：只在不同的时候修改正反面
+ * 坐标由区域的布局决定（主牌区用模型中的坐标，底牌堆按顺序计算）
+ */
+void GameController::syncCardView(CardView* cardView, const CardModel& cardModel) {
+    if (cardView->isFaceUp() != cardModel.isFaceUp) {
+        cardView->setFaceUp(cardModel.isFaceUp);
+    }
 }
 
 /**
  * 处理卡牌点击事件
  * 
  * 当玩家点击任何卡牌时，会调用这个方法
- * 这个方法会判断：
- * 1. 卡牌来自哪里（主牌区还是底牌堆）
- * 2. 执行什么操作（匹配还是换底牌）
+ * 点击先放进命令队列，这一帧统一执行（executeCardClick）；
+ * 同一帧里对同一张牌的重复点击（手指抖动、连点）只执行一次
  * 
  * @param cardId 被点击的卡牌ID
  */
 void GameController::onCardClicked(int cardId) {
-    // 检查视图是否有效
-    if (!_gameView) {
-        CCLOG("GameView为空");
+    TRACE_ZONE("GameController::onCardClicked");
+    GAME_LOG_DEBUG("========== 卡牌点击: cardId=%d ==========", cardId);
+    if (_replaying) {
+        _latencyTracker.cancelInput();
         return;
     }
     
-    CCLOG("========== 卡牌点击: cardId=%d ==========", cardId);
-    
-    // 获取主牌区视图和底牌堆视图
-    auto playfieldView = _gameView->getPlayfieldView();
-    auto stackView = _gameView->getStackView();
+    // 触摸时开始的输入跟着命令排队，执行时再放回统计
+    uint64_t inputTime = 0;
+    _latencyTracker.takeInput(inputTime);
     
-    // 检查视图是否有效
-    if (!playfieldView || !stackView) {
-        CCLOG("视图为空");
+    for (const auto& command : _commands) {
+        if (command.type == CommandType::CARD_CLICK && command.cardId == cardId) {
+            GAME_LOG_DEBUG("合并同一帧的重复点击: cardId=%d", cardId);
+            return;
+        }
+    }
+    enqueueCommand(CommandType::CARD_CLICK, cardId, inputTime, InputLatencyTracker::now());
+}
+
+/**
+ * 处理回退按钮点击事件（放进命令队列）
+ * 回退由GameLogic完成，完成后会回调onMoveUndone播放回退动画
+ */
+void GameController::onUndoClicked() {
+    if (_replaying) return;
+    uint64_t inputTime = InputLatencyTracker::now();
+    enqueueCommand(CommandType::UNDO, -1, inputTime, inputTime);
+}
+
+/**
+ * 处理重做按钮点击事件（放进命令队列）
+ * 重做由GameLogic完成，完成后会像普通操作一样回调onMoveApplied播放动画
+ */
+void GameController::onRedoClicked() {
+    if (_replaying) return;
+    uint64_t inputTime = InputLatencyTracker::now();
+    enqueueCommand(CommandType::REDO, -1, inputTime, inputTime);
+}
+
+void GameController::enqueueCommand(CommandType type, int cardId, uint64_t inputTime, uint64_t clickTime) {
+    if ((int)_commands.size() >= kMaxQueuedCommands) {
+        GAME_LOG_WARN("输入太多，丢掉: type=%d, cardId=%d", type, cardId);
         return;
     }
-    
-    // 检查卡牌来源并执行相应操作
-    CardView* clickedCard = playfieldView->findCardById(cardId);
-    if (clickedCard) {
-        // 主牌区卡牌点击：尝试与底牌堆顶部卡牌匹配
-        CCLOG("卡牌来自主牌区，处理主牌区卡牌匹配");
-        handlePlayfieldCardMatch(cardId);
-    } else {
-        // 在底牌堆查找
-        clickedCard = stackView->findCardById(cardId);
-        if (clickedCard) {
-            CCLOG("卡牌来自底牌堆，处理底牌堆卡牌替换");
-            handleStackCardReplace(cardId);
-        } else {
-            CCLOG("未找到卡牌: cardId=%d", cardId);
+    Command command;
+    command.type = type;
+    command.cardId = cardId;
+    command.inputTime = inputTime;
+    command.clickTime = clickTime;
+    _commands.push_back(command);
+}
+
+/**
+ * 每帧更新（绘制前）
+ * 1. 按顺序执行这一帧排队的输入：每个输入都立即修改模型、同步视图结构、开始动画，不等上一个动画播完
+ * 2. 盖住退场视图的卡牌已经落下时，回收退场的视图
+ */
+void GameController::updateFrame(float dt) {
+    if (!_commands.empty()) {
+        TRACE_ZONE("GameController::executeCommands");
+        TRACE_COUNTER("input.commands", _commands.size());
+        for (size_t i = 0; i < _commands.size(); ++i) {
+            executeCommand(_commands[i]);
         }
+        _commands.clear();
+    }
+    if (!_retiringViews.empty()) {
+        releaseRetiringViews(false);
     }
 }
 
-void GameController::handleStackCardReplace(int clickedCardId) {
-    auto stackView = _gameView->getStackView();
-    auto topCard = stackView->getTopCard();
-    
-    if (!topCard) {
-        CCLOG("没有顶部底牌");
-        return;
+/**
+ * 执行一个输入：先把排队时取走的输入放回延迟统计（提交时算到这个输入上），执行后放弃没有提交的
+ */
+void GameController::executeCommand(const Command& command) {
+    if (command.inputTime != 0) {
+        _latencyTracker.beginInput(command.inputTime);
+        _latencyTracker.markClick(command.clickTime);
     }
-    
-    CCLOG("处理底牌点击: clickedCardId=%d, topCardId=%d", clickedCardId, topCard->getCardId());
-    
-    // 如果点击的是顶部牌，不允许操作（顶部牌只能用于匹配）
-    if (topCard->getCardId() == clickedCardId) {
-        CCLOG("点击的是顶部底牌，不能换底牌");
-        return;
+    switch (command.type) {
+        case CommandType::CARD_CLICK:
+            executeCardClick(command.cardId);
+            break;
+        case CommandType::UNDO:
+            executeUndo();
+            break;
+        case CommandType::REDO:
+            executeRedo();
+            break;
     }
-    
-    // 检查顶部底牌是否可以与主牌区匹配
-    CardModel topCardModel = _gameModel.getCardById(topCard->getCardId());
-    if (checkTopCardCanMatch(topCardModel)) {
-        CCLOG("顶部底牌可以匹配，不允许换底牌");
+    // 成功时已经在onMoveApplied/onMoveUndone里提交，这里只放弃不合法的输入
+    _latencyTracker.cancelInput();
+}
+
+/**
+ * 执行卡牌点击
+ * 卡牌来自哪里（主牌区还是底牌堆）直接查询模型，
+ * 然后把点击转换成一步操作交给GameLogic执行，
+ * 执行成功后GameLogic会回调onMoveApplied同步视图、播放动画
+ */
+void GameController::executeCardClick(int cardId) {
+    TRACE_ZONE("GameController::executeCardClick");
+    // 记录的是点击本身，不合法的点击也记录，回放时按同样的规则重新判断
+    _recorder.recordClick(cardId, getElapsedMs());
+    
+    Move move = _gameLogic.getMoveForCard(cardId);
+    if (!move.isValid()) {
+        GAME_LOG_INFO("未找到卡牌: cardId=%d", cardId);
         return;
     }
     
-    CCLOG("顶部底牌无法匹配，允许换底牌");
-    
-    // 找到被点击的卡牌
-    CardView* clickedCard = stackView->findCardById(clickedCardId);
-    if (!clickedCard) return;
-    
-    // 获取卡牌信息
-    CardModel clickedCardModel = _gameModel.getCardById(clickedCardId);
+    if (move.type == MoveType::PLAYFIELD_MATCH) {
+        GAME_LOG_DEBUG("卡牌来自主牌区，处理主牌区卡牌匹配");
+    } else {
+        GAME_LOG_DEBUG("卡牌来自底牌堆，处理底牌堆卡牌替换");
+    }
     
-    // 找到被点击卡牌在底牌堆中的索引
-    int clickedIndex = -1;
-    for (size_t i = 0; i < _gameModel.stackCards.size(); i++) {
-        if (_gameModel.stackCards[i].id == clickedCardId) {
-            clickedIndex = (int)i;
-            break;
+    if (!_gameLogic.applyMove(move)) {
+        GAME_LOG_INFO("操作不合法: cardId=%d, 顶部底牌ID=%d", cardId, _gameLogic.getModel().getStackTopCard().id);
+    }
+}
+
+void GameController::executeUndo() {
+    TRACE_ZONE("GameController::executeUndo");
+    _recorder.recordUndo(getElapsedMs());
+    _gameLogic.undo();
+}
+
+void GameController::executeRedo() {
+    TRACE_ZONE("GameController::executeRedo");
+    _recorder.recordRedo(getElapsedMs());
+    _redoing = true;
+    _gameLogic.redo();
+    _redoing = false;
+}
+
+/**
+ * 跳到时间线上的第position步（复盘、回放时使用）
+ * GameLogic从最近的检查点恢复模型，完成后回调onGameReset刷新整个视图
+ */
+bool GameController::seekToMove(int position) {
+    TRACE_ZONE("GameController::seekToMove");
+    if (_replaying) return false;
+    _commands.clear();
+    _recorder.recordSeek(position, getElapsedMs());
+    return _gameLogic.seek(position);
+}
+
+bool GameController::saveReplay(const std::string& path) {
+    if (!_recorder.isRecording()) return false;
+    _recorder.finish(_gameLogic.getModel(), getElapsedMs());
+    return ReplayFormat::saveFile(path, _recorder.getData());
+}
+
+/**
+ * 播放回放
+ * 1. 按回放的开局重置游戏（GameLogic会回调onGameReset刷新视图）
+ * 2. 读出第一个事件，每帧推进回放时钟，到时间的事件交给ReplayPlayer执行
+ */
+bool GameController::playReplay(const std::vector<uint8_t>& data, float speed) {
+    stopReplay();
+    _replayData = data;
+    if (!_replayReader.open(_replayData.data(), _replayData.size())) {
+        _replayData.clear();
+        return false;
+    }
+
+    _recorder.clear();
+    _commands.clear();
+    ReplayPlayer::setupGame(_replayReader, _gameLogic);
+    updateView();
+
+    _replaying = true;
+    _replaySpeed = speed > 0.0f ? speed : 1.0f;
+    _replayClockMs = 0.0;
+    _replayAnimationCooldown = 0.0f;
+    _hasReplayEvent = _replayReader.next(_replayEvent);
+
+    Director::getInstance()->getScheduler()->schedule([this](float dt) {
+        updateReplay(dt);
+    }, this, 0.0f, false, kReplayScheduleKey);
+    return true;
+}
+
+void GameController::stopReplay() {
+    if (!_replaying) return;
+    _replaying = false;
+    _hasReplayEvent = false;
+    Director::getInstance()->getScheduler()->unschedule(kReplayScheduleKey, this);
+}
+
+/**
+ * 回放的每帧更新
+ * 倍速高的时候，一帧里可能有多个事件到时间，或者上一个动画还没播完；
+ * 这时逐个播放动画会互相冲突，所以这些事件只修改模型（暂时不通知观察者），
+ * 这一帧结束时整体重建一次视图
+ */
+void GameController::updateReplay(float dt) {
+    TRACE_ZONE("GameController::updateReplay");
+    _replayClockMs += dt * 1000.0 * _replaySpeed;
+    _replayAnimationCooldown -= dt;
+
+    bool skippedAnimation = false;
+    while (_hasReplayEvent && _replayEvent.timeMs <= _replayClockMs) {
+        ReplayEvent event = _replayEvent;
+        _hasReplayEvent = _replayReader.next(_replayEvent);
+
+        bool nextDue = _hasReplayEvent && _replayEvent.timeMs <= _replayClockMs;
+        bool animate = !nextDue && !skippedAnimation && _replayAnimationCooldown <= 0.0f;
+        if (!animate) {
+            _gameLogic.setObserver(nullptr);
+        }
+        if (ReplayPlayer::applyEvent(event, _gameLogic, nullptr) && animate) {
+            _replayAnimationCooldown = kMoveAnimationSeconds;
+        }
+        if (!animate) {
+            _gameLogic.setObserver(this);
+            skippedAnimation = true;
         }
     }
+
+    if (skippedAnimation) {
+        updateView();
+    }
+    if (!_hasReplayEvent) {
+        stopReplay();
+    }
+}
+
+uint32_t GameController::getElapsedMs() const {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _startTime).count();
+}
+
+/**
+ * 模型被整体替换（GameObserver回调），比如时间线跳转
+ * 没有逐步的动画可以播放，直接根据模型重建视图
+ */
+void GameController::onGameReset() {
+    updateView();
+}
+
+/**
+ * 根据时间线的状态显示/隐藏回退、重做按钮
+ */
+void GameController::updateTimelineButtons() {
+    if (!_gameView) return;
+    _gameView->showUndoButton(_gameLogic.canUndo());
+    _gameView->showRedoButton(_gameLogic.canRedo());
+}
+
+/**
+ * 一步操作执行完成（GameObserver回调）
+ * 模型已经修改完成，根据操作类型同步视图、播放对应的动画
+ */
+void GameController::onMoveApplied(const Move& move, const UndoRecord& record) {
+    if (!_gameView) return;
+    
+    // 模型已经修改完成：提交这次输入（回放、没有触摸的操作返回-1，不统计）
+    LatencyAction action = _redoing ? LatencyAction::REDO
+        : move.type == MoveType::STACK_REPLACE ? LatencyAction::STACK_REPLACE : LatencyAction::PLAYFIELD_MATCH;
+    _latencyInput = _latencyTracker.commit(action, InputLatencyTracker::now());
+    
+    if (move.type == MoveType::STACK_REPLACE) {
+        animateStackReplace(record);
+    } else if (move.type == MoveType::PLAYFIELD_MATCH) {
+        animatePlayfieldMatch(record);
+    }
+    updateTimelineButtons();
+}
+
+/**
+ * 一步操作被回退（GameObserver回调）
+ * 模型已经恢复完成，根据操作类型播放对应的回退动画
+ */
+void GameController::onMoveUndone(const UndoRecord& record) {
+    if (!_gameView) return;
     
-    // 记录回退信息
-    UndoRecord record = createStackReplaceRecord(clickedCardId, clickedCardModel, clickedIndex, topCard->getCardId());
+    _latencyInput = _latencyTracker.commit(LatencyAction::UNDO, InputLatencyTracker::now());
     
-    // 更新底牌堆中的卡牌顺序
-    moveCardToStackTop(clickedCardId, clickedIndex);
+    if (record.moveType == MoveType::STACK_REPLACE) {
+        undoStackReplace(record);
+    } else if (record.moveType == MoveType::PLAYFIELD_MATCH) {
+        undoPlayfieldMatch(record);
+    }
+    updateTimelineButtons();
+}
+
+/**
+ * 底牌替换：被点击的备用底牌立即排到底牌堆顶部，再移动到顶部的位置
+ * 其他备用底牌在绘制前重新布局
+ */
+void GameController::animateStackReplace(const UndoRecord& record) {
+    TRACE_ZONE("GameController::animateStackReplace");
+    auto stackView = _gameView->getStackView();
+    CardView* clickedCard = stackView->findCardById(record.cardId);
+    if (!clickedCard) {
+        // 视图和模型不一致（不应该发生）：整体同步
+        updateView();
+        return;
+    }
     
-    // 记录回退
-    _undoManager.push(record);
+    GAME_LOG_DEBUG("处理底牌点击: clickedCardId=%d, topCardId=%d", record.cardId, record.targetCardId);
     
-    // 获取顶部卡牌位置（主底牌在右边）
-    Vec2 topPos = Vec2(StackView::kStackWidth - 200, StackView::kStackHeight / 2);
+    // 同步更新视图中的卡牌顺序：将卡牌移到视图的最后（成为顶部）
+    stackView->moveCardToIndex(clickedCard, -1);
+    stackView->setNeedsLayout();
     
-    // 播放移动动画
-    clickedCard->playMoveAnimation(topPos, [this, clickedCard, stackView, clickedCardId]() {
-        // 动画完成后，重新布局
-        stackView->layoutCards();
-        _gameView->showUndoButton(true);
-        
-        // 验证顶部卡牌是否正确更新
-        auto newTopCard = stackView->getTopCard();
-        if (newTopCard) {
-            CCLOG("换底牌完成，新的顶部卡牌ID: %d, 点数: %d", 
-                  newTopCard->getCardId(), 
-                  _gameModel.getCardById(newTopCard->getCardId()).face);
-        } else {
-            CCLOG("换底牌完成，但没有顶部卡牌");
-        }
-    });
+    // 移动到顶部卡牌位置（主底牌在右边）
+    playCardMove(clickedCard, stackView->getLayoutPosition((int)stackView->getCards().size() - 1));
 }
 
-void GameController::handlePlayfieldCardMatch(int playfieldCardId) {
+/**
+ * 主牌区匹配：卡牌立即从主牌区换到底牌堆顶部，再移动到顶部的位置；
+ * 原顶部牌立即离开底牌堆，继续显示到被盖住为止
+ */
+void GameController::animatePlayfieldMatch(const UndoRecord& record) {
+    TRACE_ZONE("GameController::animatePlayfieldMatch");
     auto playfieldView = _gameView->getPlayfieldView();
     auto stackView = _gameView->getStackView();
-    auto topCard = stackView->getTopCard();
-    
-    if (!topCard) return;
-    
-    CardModel playfieldCard = _gameModel.getCardById(playfieldCardId);
-    CardModel stackCard = _gameModel.getCardById(topCard->getCardId());
-    
-    if (playfieldCard.id == -1 || stackCard.id == -1) return;
     
-    // 检查是否可以匹配（点数差1）
-    if (!canMatch(playfieldCard.face, stackCard.face)) {
-        CCLOG("卡牌不匹配: %d 和 %d", playfieldCard.face, stackCard.face);
+    // 找到卡牌视图
+    CardView* cardView = playfieldView->findCardById(record.cardId);
+    CardView* oldTopCardView = stackView->findCardById(record.targetCardId);
+    if (!cardView || !oldTopCardView) {
+        updateView();
         return;
     }
     
-    // 记录回退信息
-    UndoRecord record = createPlayfieldMatchRecord(playfieldCardId, playfieldCard, stackCard);
-    
-    // 找到卡牌视图
-    CardView* cardView = playfieldView->findCardById(playfieldCardId);
-    if (!cardView) return;
-    
-    // 获取顶部卡牌位置
-    Vec2 topPos = topCard->getPosition();
-    
-    // 更新模型：
-    // 1. 将主牌区的卡牌移到底牌堆（成为新的顶部）
-    // 2. 将原来的顶部卡牌从底牌堆移除（直接消失）
-    _gameModel.removeCardFromPlayfield(playfieldCardId);
-    
-    // 原顶部卡牌ID，用于从视图中移除
-    int oldTopCardId = stackCard.id;
-    
-    // 从底牌堆中移除原顶部卡牌（直接消失）
-    _gameModel.removeCardFromStack(oldTopCardId);
-    
-    // 将主牌区的卡牌添加到底牌堆（成为新的顶部）
-    CardModel newTopCard = playfieldCard;
-    newTopCard.posX = 800;  // 主底牌位置
-    newTopCard.posY = 290;
-    _gameModel.addCardToStack(newTopCard);
+    retireCardView(oldTopCardView, cardView);
+    moveCardViewToZone(cardView, true);
+    stackView->setNeedsLayout();
     
-    // 记录回退
-    _undoManager.push(record);
+    playCardMove(cardView, stackView->getLayoutPosition((int)stackView->getCards().size() - 1));
+    GAME_LOG_DEBUG("卡牌匹配: 主牌区卡牌移到底牌区顶部，原顶部卡牌退场");
+}
+
+/**
+ * 播放移动动画并记录输入延迟的动画阶段；动画被这张牌的下一次移动打断时回调不调用，不记录ANIMATION_END
+ */
+void GameController::playCardMove(CardView* cardView, const Vec2& targetPos) {
+    int input = _latencyInput;
+    _latencyTracker.markStage(input, LatencyStage::ANIMATION_START, InputLatencyTracker::now());
+    cardView->playMoveAnimation(targetPos, [this, input]() {
+        _latencyTracker.markStage(input, LatencyStage::ANIMATION_END, InputLatencyTracker::now());
+    });
+}
+
+/**
+ * 换区域时先把位置换算到屏幕坐标，加入新区域后再换算回来（两个区域的原点不同）
+ */
+void GameController::moveCardViewToZone(CardView* cardView, bool toStack) {
+    auto playfieldView = _gameView->getPlayfieldView();
+    auto stackView = _gameView->getStackView();
+    Node* from = toStack ? (Node*)playfieldView : (Node*)stackView;
+    Node* to = toStack ? (Node*)stackView : (Node*)playfieldView;
     
-    // 播放移动动画
-    cardView->playMoveAnimation(topPos, [this, cardView, playfieldView, stackView, oldTopCardId]() {
-        // 动画完成后：
-        // 1. 从主牌区移除
+    Vec2 worldPos = from->convertToWorldSpace(cardView->getPosition());
+    cardView->retain();  // 防止removeChild时被释放
+    if (toStack) {
         playfieldView->removeCard(cardView);
-        
-        // 2. 从底牌堆移除原顶部卡牌（直接消失）
-        CardView* oldTopCardView = stackView->findCardById(oldTopCardId);
-        if (oldTopCardView) {
-            stackView->removeCard(oldTopCardView);
-        }
-        
-        // 3. 将新卡牌添加到底牌堆（成为顶部）
         stackView->addCard(cardView);
-        stackView->layoutCards();
-        
-        _gameView->showUndoButton(true);
-        CCLOG("卡牌匹配完成，主牌区卡牌已移到底牌区顶部，原顶部卡牌已消失");
-    });
+    } else {
+        stackView->removeCard(cardView);
+        playfieldView->addCard(cardView);
+    }
+    cardView->setPosition(to->convertToNodeSpace(worldPos));
+    cardView->release();
 }
 
-void GameController::onUndoClicked() {
-    if (!_undoManager.canUndo()) {
-        return;
+/**
+ * 退场的视图留在底牌堆节点下显示，但不在卡牌列表里（不参与布局、查找），也不参与点击检测
+ */
+void GameController::retireCardView(CardView* cardView, CardView* cover) {
+    auto stackView = _gameView->getStackView();
+    cardView->retain();
+    stackView->removeCard(cardView);
+    cardView->setHitIndex(nullptr, 0);
+    stackView->addChild(cardView, cardView->getLocalZOrder());
+    cardView->release();
+    _retiringViews.push_back(RetiringView{ cardView, cover });
+}
+
+CardView* GameController::takeRetiringView(int cardId) {
+    for (auto it = _retiringViews.begin(); it != _retiringViews.end(); ++it) {
+        CardView* cardView = it->view;
+        if (cardView->getCardId() == cardId) {
+            _retiringViews.erase(it);
+            cardView->retain();
+            cardView->removeFromParent();
+            cardView->autorelease();
+            return cardView;
+        }
     }
-    
-    UndoRecord record = _undoManager.undo();
-    
-    // 根据操作类型执行相应的回退操作
-    if (record.moveType == MoveType::STACK_REPLACE) {
-        undoStackReplace(record);
-    } else if (record.moveType == MoveType::PLAYFIELD_MATCH) {
-        undoPlayfieldMatch(record);
+    return nullptr;
+}
+
+void GameController::releaseRetiringViews(bool all) {
+    size_t kept = 0;
+    for (size_t i = 0; i < _retiringViews.size(); ++i) {
+        RetiringView entry = _retiringViews[i];
+        if (all || !entry.cover->isMoving()) {
+            recycleCardView(entry.view);
+        } else {
+            _retiringViews[kept++] = entry;
+        }
     }
+    _retiringViews.resize(kept);
 }
 
 /**
@@ -338,9 +742,16 @@ void GameController::onUndoClicked() {
  * @return true=可以匹配, false=不能匹配
  */
 bool GameController::canMatch(int card1Face, int card2Face) const {
-    // 点数差1即可匹配（无花色要求）
-    // std::abs()计算绝对值，确保无论哪个大哪个小都能匹配
-    return std::abs(card1Face - card2Face) == 1;
+    // 规则在GameLogic中实现，这里直接转发
+    return GameLogic::canMatch(card1Face, card2Face);
+}
+
+/**
+ * 是否还有可以走的步
+ * 直接交给模型判断（点数掩码 + 底牌数量），O(1)
+ */
+bool GameController::hasMovesLeft() const {
+    return _gameLogic.hasMovesLeft();
 }
 
 /**
@@ -349,14 +760,14 @@ bool GameController::canMatch(int card1Face, int card2Face) const {
  */
 void GameController::initializePlayfieldCards() {
     // 主牌区左侧（3张卡牌）
-    _gameModel.addCardToPlayfield(createCard(12, 0, 250, 1000));  // 梅花Q
-    _gameModel.addCardToPlayfield(createCard(2, 0, 300, 800));   // 梅花2
-    _gameModel.addCardToPlayfield(createCard(2, 1, 350, 600));   // 方块2
+    _gameLogic.getModel().addCardToPlayfield(createCard(12, 0, 250, 1000));  // 梅花Q
+    _gameLogic.getModel().addCardToPlayfield(createCard(2, 0, 300, 800));   // 梅花2
+    _gameLogic.getModel().addCardToPlayfield(createCard(2, 1, 350, 600));   // 方块2
     
     // 主牌区右侧（3张卡牌）
-    _gameModel.addCardToPlayfield(createCard(2, 0, 850, 1000));  // 梅花2
-    _gameModel.addCardToPlayfield(createCard(2, 0, 800, 800));   // 梅花2
-    _gameModel.addCardToPlayfield(createCard(1, 3, 750, 600));   // 黑桃A
+    _gameLogic.getModel().addCardToPlayfield(createCard(2, 0, 850, 1000));  // 梅花2
+    _gameLogic.getModel().addCardToPlayfield(createCard(2, 0, 800, 800));   // 梅花2
+    _gameLogic.getModel().addCardToPlayfield(createCard(1, 3, 750, 600));   // 黑桃A
 }
 
 /**
@@ -366,14 +777,14 @@ void GameController::initializePlayfieldCards() {
  */
 void GameController::initializeStackCards() {
     // 第一张备用底牌（最左边，最底层）
-    _gameModel.addCardToStack(createCard(3, 0, 200, 290));  // 梅花3
+    _gameLogic.getModel().addCardToStack(createCard(3, 0, 200, 290));  // 梅花3
     
     // 第二张备用底牌（中间）
-    _gameModel.addCardToStack(createCard(1, 2, 200, 290));  // 红桃A
+    _gameLogic.getModel().addCardToStack(createCard(1, 2, 200, 290));  // 红桃A
     
     // 主底牌（最右边，当前使用的顶部卡牌）
     // 注意：这是最后添加的，所以是顶部卡牌（vector的最后一个元素）
-    _gameModel.addCardToStack(createCard(4, 0, 800, 290));  // 梅花4
+    _gameLogic.getModel().addCardToStack(createCard(4, 0, 800, 290));  // 梅花4
 }
 
 /**
@@ -386,7 +797,7 @@ void GameController::initializeStackCards() {
  */
 CardModel GameController::createCard(int face, int suit, float posX, float posY) {
     CardModel card;
-    card.id = _gameModel.getNextCardId();
+    card.id = _gameLogic.getModel().getNextCardId();
     card.face = face;
     card.suit = suit;
     card.isFaceUp = true;
@@ -396,199 +807,53 @@ CardModel GameController::createCard(int face, int suit, float posX, float posY)
 }
 
 /**
- * 检查顶部底牌是否可以与主牌区匹配
- * @param topCardModel 顶部底牌模型
- * @return true=可以匹配, false=不能匹配
- */
-bool GameController::checkTopCardCanMatch(const CardModel& topCardModel) const {
-    auto playfieldView = _gameView->getPlayfieldView();
-    if (!playfieldView) return false;
-    
-    for (auto* playfieldCard : playfieldView->getCards()) {
-        CardModel playfieldCardModel = _gameModel.getCardById(playfieldCard->getCardId());
-        if (canMatch(playfieldCardModel.face, topCardModel.face)) {
-            return true;
-        }
-    }
-    return false;
-}
-
-/**
- * 更新底牌堆中的卡牌顺序（将指定卡牌移到底部）
- * @param clickedCardId 被点击的卡牌ID
- * @param clickedIndex 卡牌在底牌堆中的索引
- */
-void GameController::moveCardToStackTop(int clickedCardId, int clickedIndex) {
-    auto stackView = _gameView->getStackView();
-    if (!stackView) return;
-    
-    // 更新模型：将点击的卡牌移到底牌堆末尾（成为顶部）
-    if (clickedIndex >= 0 && clickedIndex < (int)_gameModel.stackCards.size() - 1) {
-        // 将卡牌移到最后
-        CardModel temp = _gameModel.stackCards[clickedIndex];
-        _gameModel.stackCards.erase(_gameModel.stackCards.begin() + clickedIndex);
-        _gameModel.stackCards.push_back(temp);
-        
-        // 同步更新视图中的卡牌顺序
-        CardView* clickedCard = stackView->findCardById(clickedCardId);
-        if (clickedCard) {
-            auto& cards = stackView->getCards();
-            auto it = std::find(cards.begin(), cards.end(), clickedCard);
-            if (it != cards.end() && it != cards.end() - 1) {
-                // 将卡牌移到视图的最后（成为顶部）
-                CardView* tempCard = *it;
-                cards.erase(it);
-                cards.push_back(tempCard);
-            }
-        }
-    }
-}
-
-/**
- * 记录底牌替换的回退信息
- * @param clickedCardId 被点击的卡牌ID
- * @param clickedCardModel 被点击的卡牌模型
- * @param clickedIndex 卡牌在底牌堆中的索引
- * @param topCardId 顶部卡牌ID
- * @return 回退记录
- */
-UndoRecord GameController::createStackReplaceRecord(int clickedCardId, const CardModel& clickedCardModel, 
-                                                     int clickedIndex, int topCardId) {
-    auto stackView = _gameView->getStackView();
-    CardView* clickedCard = stackView ? stackView->findCardById(clickedCardId) : nullptr;
-    
-    UndoRecord record;
-    record.cardId = clickedCardId;
-    record.moveType = MoveType::STACK_REPLACE;
-    record.originalPos = clickedCard ? clickedCard->getPosition() : Vec2::ZERO;
-    record.originalParent = 1; // 底牌堆
-    record.targetCardId = topCardId;
-    record.cardFace = clickedCardModel.face;
-    record.cardSuit = clickedCardModel.suit;
-    record.originalStackIndex = clickedIndex;
-    return record;
-}
-
-/**
- * 记录主牌区匹配的回退信息
- * @param playfieldCardId 主牌区卡牌ID
- * @param playfieldCard 主牌区卡牌模型
- * @param stackCard 顶部底牌模型
- * @return 回退记录
- */
-UndoRecord GameController::createPlayfieldMatchRecord(int playfieldCardId, const CardModel& playfieldCard, 
-                                                       const CardModel& stackCard) {
-    UndoRecord record;
-    record.cardId = playfieldCardId;
-    record.moveType = MoveType::PLAYFIELD_MATCH;
-    record.originalPos = Vec2(playfieldCard.posX, playfieldCard.posY);
-    record.originalParent = 0; // 主牌区
-    record.targetCardId = stackCard.id;
-    record.cardFace = playfieldCard.face;
-    record.cardSuit = playfieldCard.suit;
-    record.oldTopCardFace = stackCard.face;
-    record.oldTopCardSuit = stackCard.suit;
-    return record;
-}
-
-/**
- * 执行底牌替换的回退操作
+ * 执行底牌替换的回退动画
+ * 模型中卡牌已经移回原来的位置，这里同步视图中的顺序并播放动画
  * @param record 回退记录
  */
 void GameController::undoStackReplace(const UndoRecord& record) {
+    TRACE_ZONE("GameController::undoStackReplace");
     auto stackView = _gameView->getStackView();
-    if (!stackView) return;
-    
     CardView* cardView = stackView->findCardById(record.cardId);
-    if (!cardView) return;
-    
-    // 恢复底牌堆中的顺序：将卡牌移回原来的索引位置
-    if (record.originalStackIndex >= 0) {
-        int currentIndex = -1;
-        for (size_t i = 0; i < _gameModel.stackCards.size(); i++) {
-            if (_gameModel.stackCards[i].id == record.cardId) {
-                currentIndex = (int)i;
-                break;
-            }
-        }
-        
-        if (currentIndex >= 0 && record.originalStackIndex < (int)_gameModel.stackCards.size()) {
-            CardModel temp = _gameModel.stackCards[currentIndex];
-            _gameModel.stackCards.erase(_gameModel.stackCards.begin() + currentIndex);
-            if (record.originalStackIndex <= (int)_gameModel.stackCards.size()) {
-                _gameModel.stackCards.insert(_gameModel.stackCards.begin() + record.originalStackIndex, temp);
-            } else {
-                _gameModel.stackCards.push_back(temp);
-            }
-        }
+    if (!cardView) {
+        updateView();
+        return;
     }
     
-    // 播放动画回到原位置
-    Vec2 originalPos = record.originalPos;
-    cardView->playMoveAnimation(originalPos, [this, cardView, stackView]() {
-        stackView->layoutCards();
-        _gameView->showUndoButton(_undoManager.canUndo());
-    });
+    // 恢复视图中的顺序：将卡牌移回原来的索引位置
+    stackView->moveCardToIndex(cardView, record.originalStackIndex);
+    stackView->setNeedsLayout();
+    
+    // 播放动画回到原位置（布局后的位置）
+    playCardMove(cardView, stackView->getLayoutPosition(record.originalStackIndex));
 }
 
 /**
- * 执行主牌区匹配的回退操作
+ * 执行主牌区匹配的回退动画
+ * 模型已经恢复完成：卡牌立即换回主牌区并移回原位置，原顶部卡牌回到底牌堆顶部
  * @param record 回退记录
  */
 void GameController::undoPlayfieldMatch(const UndoRecord& record) {
-    auto playfieldView = _gameView->getPlayfieldView();
+    TRACE_ZONE("GameController::undoPlayfieldMatch");
     auto stackView = _gameView->getStackView();
-    if (!playfieldView || !stackView) return;
-    
     CardView* cardView = stackView->findCardById(record.cardId);
-    if (!cardView) return;
-    
-    // 恢复主牌区的卡牌模型
-    CardModel originalCard;
-    originalCard.id = record.cardId;
-    originalCard.face = record.cardFace;
-    originalCard.suit = record.cardSuit;
-    originalCard.posX = record.originalPos.x;
-    originalCard.posY = record.originalPos.y;
-    originalCard.isFaceUp = true;
-    
-    // 恢复原顶部卡牌模型（被移除的卡牌）
-    CardModel oldTopCard;
-    oldTopCard.id = record.targetCardId;
-    oldTopCard.face = record.oldTopCardFace;
-    oldTopCard.suit = record.oldTopCardSuit;
-    oldTopCard.posX = 800;  // 主底牌位置
-    oldTopCard.posY = 290;
-    oldTopCard.isFaceUp = true;
-    
-    // 从底牌堆移除当前顶部卡牌（主牌区的卡牌）
-    _gameModel.removeCardFromStack(record.cardId);
-    
-    // 恢复原顶部卡牌到底牌堆
-    _gameModel.addCardToStack(oldTopCard);
-    
-    // 恢复主牌区的卡牌
-    _gameModel.addCardToPlayfield(originalCard);
-    
-    // 将主牌区的卡牌移回主牌区
-    Vec2 originalPos = record.originalPos;
-    cardView->playMoveAnimation(originalPos, [this, cardView, playfieldView, stackView, oldTopCard]() {
-        // 从底牌堆移除主牌区的卡牌
-        stackView->removeCard(cardView);
-        
-        // 创建并恢复原顶部卡牌到底牌堆
-        CardView* oldTopCardView = CardView::create(oldTopCard.face, oldTopCard.suit, oldTopCard.isFaceUp);
-        if (oldTopCardView) {
-            oldTopCardView->setCardId(oldTopCard.id);
-            oldTopCardView->setPosition(Vec2(oldTopCard.posX, oldTopCard.posY));
-            stackView->addCard(oldTopCardView);
-        }
-        
-        // 将主牌区的卡牌添加回主牌区
-        playfieldView->addCard(cardView);
-        
-        stackView->layoutCards();
-        _gameView->showUndoButton(_undoManager.canUndo());
-    });
+    if (!cardView) {
+        updateView();
+        return;
+    }
+    
+    moveCardViewToZone(cardView, false);
+    _gameView->getPlayfieldView()->setCardPosition(cardView, Vec2(record.originalPosX, record.originalPosY));
+    
+    // 原顶部卡牌：还在退场时直接取回，否则从对象池取视图（数据从模型中读取，模型已经恢复了它）
+    CardView* oldTopCardView = takeRetiringView(record.targetCardId);
+    if (!oldTopCardView) {
+        oldTopCardView = createCardView(_gameLogic.getModel().getCardById(record.targetCardId));
+    }
+    if (oldTopCardView) {
+        stackView->addCard(oldTopCardView);
+    }
+    stackView->setNeedsLayout();
+    
+    playCardMove(cardView, Vec2(record.originalPosX, record.originalPosY));
 }
-
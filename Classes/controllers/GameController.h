@@ -1,56 +1,145 @@
 #pragma once
 #include "views/GameView.h"
-#include "models/GameModel.h"
-#include "managers/UndoManager.h"
-#include "models/UndoModel.h"
+#include "views/CardViewPool.h"
+#include "core/GameLogic.h"
+#include "core/GameObserver.h"
+#include "core/DealGenerator.h"
+#include "core/LevelPack.h"
+#include "core/Replay.h"
+#include "core/InputLatencyTracker.h"
+#include <chrono>
 #include <functional>
+#include <string>
+#include <vector>
 
 /**
  * @brief GameController - 游戏控制器类
- * 
- * 这是MVC架构中的Controller层，负责处理游戏的核心逻辑和用户交互。
- * 它连接了视图层（GameView）和模型层（GameModel），协调两者之间的交互。
- * 
+ *
+ * 这是MVC架构中的Controller层，负责处理用户交互，并把游戏逻辑的结果同步到视图上。
+ * 游戏规则、模型修改和回退都在GameLogic（core库，不依赖cocos2d）里，
+ * 控制器只负责"把点击翻译成操作"和"把操作结果变成动画"。
+ *
  * 职责：
- * - 处理用户输入（卡牌点击、回退按钮点击）
- * - 管理游戏逻辑（卡牌匹配规则、换底牌规则）
- * - 更新游戏模型（GameModel）的状态
- * - 更新游戏视图（GameView）的显示
- * - 管理回退功能（UndoManager）
- * 
+ * - 处理用户输入（卡牌点击、回退/重做按钮点击）
+ * - 把点击转换成Move交给GameLogic执行
+ * - 作为GameObserver接收操作结果，更新游戏视图（GameView）的显示
+ *
  * 使用场景：
  * - 游戏运行时处理所有用户交互
- * - 执行游戏规则和逻辑判断
  * - 协调视图和模型的同步
- * 
+ *
  * 架构说明：
  * - 持有GameView指针，用于更新UI
- * - 持有GameModel对象，用于存储游戏数据
- * - 持有UndoManager对象，用于管理回退功能
+ * - 持有GameLogic对象（内部包含GameModel和UndoManager）
+ * - 判断卡牌在哪个区域、能否操作都查询模型，不依赖视图
+ * - 每局开始时自动录制回放（玩家的每次点击），playReplay()按倍速通过视图重新播放
+ *
+ * 输入流水线：
+ * - 点击、回退、重做先放进命令队列，每帧统一执行（同一帧里对同一张牌的重复点击合并成一次）
+ * - 执行时立即修改模型，并同步修改视图的结构（卡牌在哪个区域、底牌堆的顺序），动画只改位置；
+ *   所以动画播放期间的点击、回退都能马上执行，查找视图时视图和模型总是一致
+ * - 同一张牌在动画中又要移动时，从当前位置改去新的目标
  */
-class GameController {
+class GameController : public GameObserver {
 public:
     GameController(GameView* view);
     ~GameController();
-    
+
     /**
      * 开始游戏
      * 初始化游戏模型、创建初始卡牌并更新视图
      */
     void startGame();
-    
+
+    /**
+     * 用种子开始游戏（牌局由DealGenerator生成）
+     * @param seed 种子（关卡只需要保存这8个字节）
+     * @param options 发牌参数，必须和生成关卡时使用的参数相同
+     */
+    void startGameWithSeed(uint64_t seed, const DealOptions& options = DealOptions());
+
+    /**
+     * 设置关卡包（由场景在启动时打开，控制器不持有）
+     * @param pack 关卡包，nullptr表示没有关卡包
+     */
+    void setLevelPack(const LevelPack* pack) { _levelPack = pack; }
+
     /**
-     * 处理卡牌点击事件
+     * 从关卡包开始第levelIndex关
+     * @param levelIndex 关卡下标，从0开始
+     * @return false=没有关卡包、下标超出范围或者这一关的数据损坏（游戏状态不变）
+     */
+    bool startGame(int levelIndex);
+
+    /**
+     * 处理卡牌点击事件（放进命令队列，这一帧执行）
      * @param cardId 被点击的卡牌ID
      */
     void onCardClicked(int cardId);
-    
+
     /**
-     * 处理回退按钮点击事件
+     * 处理回退按钮点击事件（放进命令队列，这一帧执行）
      * 撤销上一步操作，恢复游戏状态
      */
     void onUndoClicked();
-    
+
+    /**
+     * 处理重做按钮点击事件（放进命令队列，这一帧执行）
+     * 重新执行上一次被回退的操作
+     */
+    void onRedoClicked();
+
+    /**
+     * 跳到时间线上的某一步（0表示开局），完成后整体刷新视图
+     * @param position 目标步数
+     * @return false=超出时间线范围
+     */
+    bool seekToMove(int position);
+
+    /**
+     * 结束录制并保存这一局的回放（玩家反馈bug时附带）
+     * 保存后这一局不再继续录制
+     * @param path 保存路径（一般放在FileUtils::getWritablePath()下）
+     * @return false=没有在录制或者写文件失败
+     */
+    bool saveReplay(const std::string& path);
+
+    /**
+     * 通过视图播放回放：按回放开局，再按录制时的时间间隔逐个执行事件
+     * 播放期间忽略玩家的点击，也不录制
+     * @param data 回放数据（会拷贝一份）
+     * @param speed 倍速，比如4表示4倍速
+     * @return false=数据不是有效的回放
+     */
+    bool playReplay(const std::vector<uint8_t>& data, float speed = 1.0f);
+
+    /**
+     * 停止播放回放，停在当前局面，可以继续玩
+     */
+    void stopReplay();
+
+    /**
+     * 是否正在播放回放
+     */
+    bool isReplaying() const { return _replaying; }
+
+    /**
+     * 卡牌视图对象池（查看命中、未命中计数）
+     */
+    const CardViewPool& getCardViewPool() const { return _cardViewPool; }
+
+    /**
+     * 输入延迟统计（每种操作从触摸到点击、模型修改、动画开始、动画完成的延迟）
+     */
+    const InputLatencyTracker& getLatencyTracker() const { return _latencyTracker; }
+
+    /**
+     * 把输入延迟统计写到文件（CSV，格式见InputLatencyTracker::formatReport）
+     * 控制器销毁时（退出游戏）自动写到可写目录的latency.csv
+     * @return false=文件无法写入
+     */
+    bool saveLatencyReport(const std::string& path) const;
+
     /**
      * 检查两张卡牌是否可以匹配
      * 匹配规则：点数差1即可匹配
@@ -60,43 +149,186 @@ public:
      */
     bool canMatch(int card1Face, int card2Face) const;
 
+    /**
+     * 是否还有可以走的步（O(1)）
+     * @return false=没有可走的步了（已经赢了或者卡死）
+     */
+    bool hasMovesLeft() const;
+
+    // GameObserver接口：游戏逻辑执行/回退操作后，由这里播放动画、同步视图
+    virtual void onMoveApplied(const Move& move, const UndoRecord& record);
+    virtual void onMoveUndone(const UndoRecord& record);
+    virtual void onGameReset();
+
 private:
+    /**
+     * 排队的输入
+     */
+    enum class CommandType : uint8_t {
+        CARD_CLICK = 0,
+        UNDO = 1,
+        REDO = 2,
+    };
+
+    struct Command {
+        CommandType type;
+        int cardId;             // CARD_CLICK：被点击的卡牌ID
+        uint64_t inputTime;     // 输入延迟统计：触摸时间，0表示不统计
+        uint64_t clickTime;     // 输入延迟统计：控制器收到点击的时间
+    };
+
+    /**
+     * 被匹配掉的原顶部牌：已经不在底牌堆里（不参与布局和点击），
+     * 继续显示到盖住它的卡牌落下为止，再还给对象池
+     */
+    struct RetiringView {
+        CardView* view;
+        CardView* cover;
+    };
+
     GameView* _gameView;
-    GameModel _gameModel;
-    UndoManager _undoManager;
-    
+    GameLogic _gameLogic;
+    const LevelPack* _levelPack;        // 关卡包（不持有）
+
+    ReplayRecorder _recorder;                           // 录制这一局的回放
+    std::chrono::steady_clock::time_point _startTime;   // 开局时间，回放事件的时间从这里算起
+
+    std::vector<uint8_t> _replayData;   // 正在播放的回放数据（读取器引用它）
+    ReplayReader _replayReader;
+    ReplayEvent _replayEvent;           // 下一个要执行的事件
+    bool _hasReplayEvent;               // _replayEvent是否有效
+    bool _replaying;                    // 是否正在播放回放
+    float _replaySpeed;                 // 倍速
+    double _replayClockMs;              // 回放时钟（按倍速推进，和事件时间比较）
+    float _replayAnimationCooldown;     // 上一个动画还要播放多久（秒）
+
+    CardViewPool _cardViewPool;         // 卡牌视图对象池，所有卡牌视图都从这里取、还到这里
+
+    std::vector<Command> _commands;             // 这一帧收到、还没执行的输入
+    std::vector<RetiringView> _retiringViews;   // 正在被盖住、还没还给对象池的视图
+
+    InputLatencyTracker _latencyTracker;    // 输入延迟统计（GameView在触摸到卡牌时开始一次输入）
+    int _latencyInput;                      // 刚提交的输入编号，动画开始、完成时使用（-1表示不统计）
+    bool _redoing;                          // 正在执行重做（提交时按重做统计）
+
+    // updateView对比视图时使用的临时数组（成员变量，避免每次刷新都分配内存）
+    std::vector<CardView*> _viewsById;  // 卡牌ID -> 还没有被复用的视图
+    std::vector<CardView*> _staleViews; // 要移除的视图
+    std::vector<CardView*> _stackOrder; // 底牌堆视图按模型的顺序
+
+    /**
+     * 从开局到现在的毫秒数
+     */
+    uint32_t getElapsedMs() const;
+
+    /**
+     * 回放的每帧更新：执行所有到时间的事件
+     */
+    void updateReplay(float dt);
+
+    /**
+     * 每帧更新：执行排队的输入，回收已经被盖住的视图
+     */
+    void updateFrame(float dt);
+
+    /**
+     * 把一个输入放进命令队列（队列满时丢掉）
+     */
+    void enqueueCommand(CommandType type, int cardId, uint64_t inputTime, uint64_t clickTime);
+
+    /**
+     * 执行一个排队的输入
+     */
+    void executeCommand(const Command& command);
+    void executeCardClick(int cardId);
+    void executeUndo();
+    void executeRedo();
+
+    /**
+     * 把卡牌视图换到另一个区域，屏幕上的位置不变（之后的移动动画从这里开始）
+     * @param toStack true=从主牌区换到底牌堆，false=从底牌堆换到主牌区
+     */
+    void moveCardViewToZone(CardView* cardView, bool toStack);
+
+    /**
+     * 播放移动动画，并记录输入延迟的动画开始、完成阶段
+     */
+    void playCardMove(CardView* cardView, const cocos2d::Vec2& targetPos);
+
+    /**
+     * 让底牌堆里的视图退场：从底牌堆移除，继续显示到cover不再移动时回收
+     */
+    void retireCardView(CardView* cardView, CardView* cover);
+
+    /**
+     * 取回还在退场的视图（回退时原顶部牌又回来了）
+     * @return 没有这张牌的退场视图时返回nullptr
+     */
+    CardView* takeRetiringView(int cardId);
+
+    /**
+     * 回收退场的视图
+     * @param all true=全部回收（整体刷新视图时），false=只回收cover已经停下的
+     */
+    void releaseRetiringViews(bool all);
+
     /**
      * 更新视图
-     * 根据游戏模型数据同步更新游戏视图显示
+     * 按卡牌ID对比模型和现有视图，只添加、移除、移动、翻转有变化的卡牌
      */
     void updateView();
-    
+
+    /**
+     * 取出ID和模型一致的现有视图，点数、花色不同时原地重置；没有返回nullptr
+     */
+    CardView* takeCardView(const CardModel& cardModel);
+
+    /**
+     * 根据模型从对象池取一个卡牌视图（还没有添加到区域里）
+     */
+    CardView* createCardView(const CardModel& cardModel);
+
+    /**
+     * 把卡牌视图从所在的区域移除并还给对象池
+     */
+    void recycleCardView(CardView* cardView);
+
     /**
-     * 处理底牌堆卡牌替换
-     * 当玩家点击备用底牌时，将其替换为顶部底牌
-     * @param clickedCardId 被点击的卡牌ID
+     * 让复用的视图的正反面和模型一致（坐标由区域布局）
      */
-    void handleStackCardReplace(int clickedCardId);
-    
+    void syncCardView(CardView* cardView, const CardModel& cardModel);
+
+    /**
+     * 根据能否回退/重做显示或隐藏对应的按钮
+     */
+    void updateTimelineButtons();
+
+    /**
+     * 播放底牌替换的动画
+     * 模型已经修改完成，这里把被点击的备用底牌移到顶部
+     * @param record 这一步的回退记录
+     */
+    void animateStackReplace(const UndoRecord& record);
+
     /**
-     * 处理主牌区卡牌匹配
-     * 当玩家点击主牌区卡牌时，尝试与顶部底牌匹配
-     * @param playfieldCardId 主牌区卡牌ID
+     * 播放主牌区匹配的动画
+     * 模型已经修改完成，这里把主牌区的卡牌移到底牌堆顶部，原顶部牌消失
+     * @param record 这一步的回退记录
      */
-    void handlePlayfieldCardMatch(int playfieldCardId);
-    
+    void animatePlayfieldMatch(const UndoRecord& record);
+
     /**
      * 初始化主牌区卡牌
      * 根据游戏配置创建主牌区的所有卡牌
      */
     void initializePlayfieldCards();
-    
+
     /**
      * 初始化底牌堆卡牌
      * 根据游戏配置创建底牌堆的所有卡牌
      */
     void initializeStackCards();
-    
+
     /**
      * 创建卡牌模型
      * @param face 卡牌点数（1-13）
@@ -106,52 +338,16 @@ private:
      * @return 创建的卡牌模型
      */
     CardModel createCard(int face, int suit, float posX, float posY);
-    
-    /**
-     * 检查顶部底牌是否可以与主牌区匹配
-     * @param topCardModel 顶部底牌模型
-     * @return true=可以匹配, false=不能匹配
-     */
-    bool checkTopCardCanMatch(const CardModel& topCardModel) const;
-    
-    /**
-     * 更新底牌堆中的卡牌顺序（将指定卡牌移到底部）
-     * @param clickedCardId 被点击的卡牌ID
-     * @param clickedIndex 卡牌在底牌堆中的索引
-     */
-    void moveCardToStackTop(int clickedCardId, int clickedIndex);
-    
-    /**
-     * 记录底牌替换的回退信息
-     * @param clickedCardId 被点击的卡牌ID
-     * @param clickedCardModel 被点击的卡牌模型
-     * @param clickedIndex 卡牌在底牌堆中的索引
-     * @param topCardId 顶部卡牌ID
-     * @return 回退记录
-     */
-    UndoRecord createStackReplaceRecord(int clickedCardId, const CardModel& clickedCardModel, 
-                                         int clickedIndex, int topCardId);
-    
-    /**
-     * 记录主牌区匹配的回退信息
-     * @param playfieldCardId 主牌区卡牌ID
-     * @param playfieldCard 主牌区卡牌模型
-     * @param stackCard 顶部底牌模型
-     * @return 回退记录
-     */
-    UndoRecord createPlayfieldMatchRecord(int playfieldCardId, const CardModel& playfieldCard, 
-                                          const CardModel& stackCard);
-    
+
     /**
-     * 执行底牌替换的回退操作
+     * 执行底牌替换的回退动画
      * @param record 回退记录
      */
     void undoStackReplace(const UndoRecord& record);
-    
+
     /**
-     * 执行主牌区匹配的回退操作
+     * 执行主牌区匹配的回退动画
      * @param record 回退记录
      */
     void undoPlayfieldMatch(const UndoRecord& record);
 };
-
@@ -0,0 +1,84 @@
+#include "CardAssets.h"
+
+const int CardAssets::kCardWidth;
+const int CardAssets::kCornerInsetX;
+const int CardAssets::kCornerInsetY;
+const int CardAssets::kBackgroundId;
+const int CardAssets::kBigNumberFirstId;
+const int CardAssets::kSmallNumberFirstId;
+const int CardAssets::kSuitFirstId;
+const int CardAssets::kBakedFaceFirstId;
+const int CardAssets::kBakedBackId;
+const int CardAssets::kAssetCount;
+
+// 一组13个点数的路径：prefix + A/2-10/J/Q/K + .png
+#define CARD_ASSET_FACES(prefix) \
+    prefix "A.png", prefix "2.png", prefix "3.png", prefix "4.png", prefix "5.png", prefix "6.png", \
+    prefix "7.png", prefix "8.png", prefix "9.png", prefix "10.png", prefix "J.png", prefix "Q.png", prefix "K.png"
+
+/**
+ * 按资源编号排列的路径表，顺序和CardAssets.h里的编号一致
+ */
+static const char* const kAssetPaths[] = {
+    "res1/card_general.png",
+    CARD_ASSET_FACES("res1/number/big_red_"),
+    CARD_ASSET_FACES("res1/number/big_black_"),
+    CARD_ASSET_FACES("res1/number/small_red_"),
+    CARD_ASSET_FACES("res1/number/small_black_"),
+    "res1/suits/club.png", "res1/suits/diamond.png", "res1/suits/heart.png", "res1/suits/spade.png",
+    CARD_ASSET_FACES("res1/baked/club_"),
+    CARD_ASSET_FACES("res1/baked/diamond_"),
+    CARD_ASSET_FACES("res1/baked/heart_"),
+    CARD_ASSET_FACES("res1/baked/spade_"),
+    "res1/baked/back.png",
+};
+
+#undef CARD_ASSET_FACES
+
+static_assert(sizeof(kAssetPaths) / sizeof(kAssetPaths[0]) == CardAssets::kAssetCount, "asset table size");
+static_assert(CardAssets::getBigNumberId(13, 0) + 1 == CardAssets::kSmallNumberFirstId, "big number ids");
+static_assert(CardAssets::getSmallNumberId(13, 0) + 1 == CardAssets::kSuitFirstId, "small number ids");
+static_assert(CardAssets::getSuitId(3) + 1 == CardAssets::kBakedFaceFirstId, "suit ids");
+static_assert(CardAssets::getBakedFaceId(13, 3) + 1 == CardAssets::kBakedBackId, "baked face ids");
+
+const char* CardAssets::getPath(int assetId) {
+    return (assetId >= 0 && assetId < kAssetCount) ? kAssetPaths[assetId] : nullptr;
+}
+
+std::string CardAssets::getFaceName(int cardFace) {
+    static const char* kFaceNames[14] = { "A", "A", "2", "3", "4", "5", "6", "7", "8", "9", "10", "J", "Q", "K" };
+    return (cardFace >= 1 && cardFace <= 13) ? kFaceNames[cardFace] : "A";
+}
+
+std::string CardAssets::getSuitName(int cardSuit) {
+    static const char* kSuitNames[4] = { "club", "diamond", "heart", "spade" };
+    return (cardSuit >= 0 && cardSuit <= 3) ? kSuitNames[cardSuit] : "club";
+}
+
+std::string CardAssets::getColorName(int cardSuit) {
+    return (cardSuit == 1 || cardSuit == 2) ? "red" : "black";
+}
+
+std::string CardAssets::getBackgroundPath() {
+    return kAssetPaths[kBackgroundId];
+}
+
+std::string CardAssets::getBigNumberPath(int cardFace, int cardSuit) {
+    return kAssetPaths[getBigNumberId(cardFace, cardSuit)];
+}
+
+std::string CardAssets::getSmallNumberPath(int cardFace, int cardSuit) {
+    return kAssetPaths[getSmallNumberId(cardFace, cardSuit)];
+}
+
+std::string CardAssets::getSuitPath(int cardSuit) {
+    return kAssetPaths[getSuitId(cardSuit)];
+}
+
+std::string CardAssets::getBakedFacePath(int cardFace, int cardSuit) {
+    return kAssetPaths[getBakedFaceId(cardFace, cardSuit)];
+}
+
+std::string CardAssets::getBakedBackPath() {
+    return kAssetPaths[kBakedBackId];
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+
+/**
+ * @brief CardAssets - 卡牌图片的路径和卡面布局（不依赖cocos2d）
+ *
+ * CardView运行时按这里的路径取精灵帧，离线工具（卡面预合成card_baker）按同样的路径读写图片，
+ * 两边的命名和布局只在这里定义一次。路径都相对于资源根目录，也是图集里精灵帧的名字。
+ *
+ * 卡面布局（原图像素，y轴向上，和CardView中子精灵的位置一致）：
+ * - 小数字：中心在(kCornerInsetX, 高 - kCornerInsetY)
+ * - 花色：中心在(宽 - kCornerInsetX, 高 - kCornerInsetY)
+ * - 大数字：中心在卡牌中心
+ * 背面就是不带数字、花色的底图。
+ *
+ * 资源编号：每张卡牌图片有一个固定的编号（0 ~ kAssetCount-1），路径表在编译时就确定。
+ * 编号由点数、花色直接算出来（constexpr），运行时按编号查表，不用拼接路径字符串：
+ *   底图 | 大数字[红/黑][A-K] | 小数字[红/黑][A-K] | 花色[4] | 预合成卡面[花色][A-K] | 预合成背面
+ */
+struct CardAssets {
+    static const int kCardWidth = 120;      // 卡牌显示宽度（设计分辨率），底图按这个宽度缩放
+    static const int kCornerInsetX = 50;    // 小数字、花色中心离左右边缘的距离
+    static const int kCornerInsetY = 60;    // 小数字、花色中心离顶部的距离
+
+    static const int kBackgroundId = 0;                         // 底图
+    static const int kBigNumberFirstId = 1;                     // 大数字，2种颜色 x 13个点数
+    static const int kSmallNumberFirstId = 27;                  // 小数字，2种颜色 x 13个点数
+    static const int kSuitFirstId = 53;                         // 花色，4种
+    static const int kBakedFaceFirstId = 57;                    // 预合成卡面，4种花色 x 13个点数
+    static const int kBakedBackId = 109;                        // 预合成背面
+    static const int kAssetCount = 110;
+
+    /**
+     * 点数、花色的下标（超出范围按A、梅花，和路径函数一致）
+     */
+    static constexpr int faceIndex(int cardFace) { return (cardFace >= 1 && cardFace <= 13) ? cardFace - 1 : 0; }
+    static constexpr int suitIndex(int cardSuit) { return (cardSuit >= 0 && cardSuit <= 3) ? cardSuit : 0; }
+
+    /**
+     * 数字颜色的下标：0=红（方块、红桃），1=黑
+     */
+    static constexpr int colorIndex(int cardSuit) { return (cardSuit == 1 || cardSuit == 2) ? 0 : 1; }
+
+    static constexpr int getBigNumberId(int cardFace, int cardSuit) {
+        return kBigNumberFirstId + colorIndex(cardSuit) * 13 + faceIndex(cardFace);
+    }
+
+    static constexpr int getSmallNumberId(int cardFace, int cardSuit) {
+        return kSmallNumberFirstId + colorIndex(cardSuit) * 13 + faceIndex(cardFace);
+    }
+
+    static constexpr int getSuitId(int cardSuit) { return kSuitFirstId + suitIndex(cardSuit); }
+
+    static constexpr int getBakedFaceId(int cardFace, int cardSuit) {
+        return kBakedFaceFirstId + suitIndex(cardSuit) * 13 + faceIndex(cardFace);
+    }
+
+    /**
+     * 资源编号对应的图片路径（编译时的常量表）
+     * @return 编号超出范围时返回nullptr
+     */
+    static const char* getPath(int assetId);
+
+    /**
+     * 点数的名字：A、2-10、J、Q、K（超出范围按A）
+     */
+    static std::string getFaceName(int cardFace);
+
+    /**
+     * 花色的名字：club、diamond、heart、spade（超出范围按club）
+     */
+    static std::string getSuitName(int cardSuit);
+
+    /**
+     * 数字的颜色：方块、红桃是red，其余是black
+     */
+    static std::string getColorName(int cardSuit);
+
+    /**
+     * 卡牌底图，如"res1/card_general.png"
+     */
+    static std::string getBackgroundPath();
+
+    /**
+     * 大数字图片，如"res1/number/big_red_A.png"
+     */
+    static std::string getBigNumberPath(int cardFace, int cardSuit);
+
+    /**
+     * 小数字图片，如"res1/number/small_red_A.png"
+     */
+    static std::string getSmallNumberPath(int cardFace, int cardSuit);
+
+    /**
+     * 花色图片，如"res1/suits/heart.png"
+     */
+    static std::string getSuitPath(int cardSuit);
+
+    /**
+     * 预合成的整张卡面，如"res1/baked/heart_A.png"
+     */
+    static std::string getBakedFacePath(int cardFace, int cardSuit);
+
+    /**
+     * 预合成的卡牌背面，"res1/baked/back.png"
+     */
+    static std::string getBakedBackPath();
+};
@@ -0,0 +1,149 @@
+#include "DealGenerator.h"
+#include "GameLogic.h"
+#include "Random.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+// 主牌区的摆放格子（主牌区坐标，宽1080高1500）
+static const int kSlotColumns = 5;
+static const int kSlotRows = 11;
+static const float kSlotLeft = 160.0f;
+static const float kSlotTop = 1350.0f;
+static const float kSlotStepX = 190.0f;
+static const float kSlotStepY = 100.0f;
+
+// 底牌堆的位置（底牌堆坐标，和GameController原来的固定布局一致）
+static const float kReserveX = 200.0f;
+static const float kTopX = 800.0f;
+static const float kStackY = 290.0f;
+
+// 批量模式每个任务检查的种子数
+static const uint64_t kBatchChunk = 4096;
+
+void Deal::applyTo(GameModel& model) const {
+    for (int i = 0; i < playfieldCount; i++) {
+        CardModel card;
+        card.id = model.getNextCardId();
+        card.face = playfield[i].face;
+        card.suit = playfield[i].suit;
+        card.isFaceUp = true;
+        card.posX = playfield[i].posX;
+        card.posY = playfield[i].posY;
+        model.addCardToPlayfield(card);
+    }
+    for (int i = 0; i < stackCount; i++) {
+        CardModel card;
+        card.id = model.getNextCardId();
+        card.face = stack[i].face;
+        card.suit = stack[i].suit;
+        card.isFaceUp = true;
+        card.posX = stack[i].posX;
+        card.posY = stack[i].posY;
+        model.addCardToStack(card);
+    }
+}
+
+bool DealGenerator::generate(uint64_t seed, const DealOptions& options, Deal& deal) {
+    Random random(seed);
+    deal.seed = seed;
+
+    // 1. 张数
+    int minCards = std::max(2, std::min(options.minCards, (int)Deal::kMaxCards));
+    int maxCards = std::max(minCards, std::min(options.maxCards, (int)Deal::kMaxCards));
+    int total = random.nextInt(minCards, maxCards);
+    int minPercent = std::max(0, std::min(options.minPlayfieldPercent, 100));
+    int maxPercent = std::max(minPercent, std::min(options.maxPlayfieldPercent, 100));
+    int percent = random.nextInt(minPercent, maxPercent);
+    int playfieldCount = (total * percent + 50) / 100;
+    playfieldCount = std::max(1, std::min(playfieldCount, total - 1));
+    deal.playfieldCount = playfieldCount;
+    deal.stackCount = total - playfieldCount;
+
+    // 2. 洗牌：只需要前total张
+    uint8_t deck[Deal::kMaxCards];
+    for (int i = 0; i < Deal::kMaxCards; i++) {
+        deck[i] = (uint8_t)i;
+    }
+    for (int i = 0; i < total; i++) {
+        int j = i + random.nextInt(Deal::kMaxCards - i);
+        std::swap(deck[i], deck[j]);
+    }
+
+    // 3. 主牌区：随机选格子，按格子顺序（从上到下、从左到右）添加
+    uint8_t slots[kSlotColumns * kSlotRows];
+    for (int i = 0; i < kSlotColumns * kSlotRows; i++) {
+        slots[i] = (uint8_t)i;
+    }
+    for (int i = 0; i < playfieldCount; i++) {
+        int j = i + random.nextInt(kSlotColumns * kSlotRows - i);
+        std::swap(slots[i], slots[j]);
+    }
+    std::sort(slots, slots + playfieldCount);
+
+    for (int i = 0; i < playfieldCount; i++) {
+        DealCard& card = deal.playfield[i];
+        card.face = (int8_t)(deck[i] % 13 + 1);
+        card.suit = (int8_t)(deck[i] / 13);
+        card.posX = kSlotLeft + (slots[i] % kSlotColumns) * kSlotStepX;
+        card.posY = kSlotTop - (slots[i] / kSlotColumns) * kSlotStepY;
+    }
+
+    // 4. 底牌堆：最后一张是顶部牌
+    for (int i = 0; i < deal.stackCount; i++) {
+        DealCard& card = deal.stack[i];
+        int cardIndex = deck[playfieldCount + i];
+        card.face = (int8_t)(cardIndex % 13 + 1);
+        card.suit = (int8_t)(cardIndex / 13);
+        card.posX = i == deal.stackCount - 1 ? kTopX : kReserveX;
+        card.posY = kStackY;
+    }
+
+    return accepts(deal, options);
+}
+
+bool DealGenerator::accepts(const Deal& deal, const DealOptions& options) {
+    int total = deal.playfieldCount + deal.stackCount;
+    if (total < options.minCards || total > options.maxCards) return false;
+    if (deal.playfieldCount * 100 < options.minPlayfieldPercent * total) return false;
+    if (deal.playfieldCount * 100 > options.maxPlayfieldPercent * total) return false;
+
+    if (options.requireFirstMove) {
+        if (deal.stackCount == 0) return false;
+        int topFace = deal.stack[deal.stackCount - 1].face;
+        bool hasMove = false;
+        for (int i = 0; i < deal.playfieldCount && !hasMove; i++) {
+            hasMove = GameLogic::canMatch(deal.playfield[i].face, topFace);
+        }
+        if (!hasMove) return false;
+    }
+    return true;
+}
+
+/**
+ * 种子范围切成每段kBatchChunk个，每段一个任务，各自把结果放在自己的数组里，
+ * 最后按段的顺序拼起来，所以输出顺序和线程数无关
+ */
+void DealGenerator::generateBatch(WorkStealingPool& pool, uint64_t firstSeed, uint64_t seedCount,
+                                  const DealOptions& options, std::vector<uint64_t>& acceptedSeeds) {
+    acceptedSeeds.clear();
+    if (seedCount == 0) return;
+
+    int chunkCount = (int)((seedCount + kBatchChunk - 1) / kBatchChunk);
+    std::vector<std::vector<uint64_t>> chunks(chunkCount);
+
+    pool.run(chunkCount, [&](int chunkIndex, int) {
+        uint64_t begin = (uint64_t)chunkIndex * kBatchChunk;
+        uint64_t end = std::min(begin + kBatchChunk, seedCount);
+        std::vector<uint64_t>& accepted = chunks[chunkIndex];
+        Deal deal;
+        for (uint64_t i = begin; i < end; i++) {
+            if (generate(firstSeed + i, options, deal)) {
+                accepted.push_back(firstSeed + i);
+            }
+        }
+    });
+
+    for (const auto& chunk : chunks) {
+        acceptedSeeds.insert(acceptedSeeds.end(), chunk.begin(), chunk.end());
+    }
+}
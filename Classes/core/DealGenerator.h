@@ -0,0 +1,94 @@
+#pragma once
+#include "models/GameModel.h"
+#include <cstdint>
+#include <vector>
+
+class WorkStealingPool;
+
+/**
+ * DealOptions - 发牌参数和筛选条件
+ *
+ * 同一个种子配合同一组参数总是得到同一局牌，所以一个关卡只需要保存8字节的种子
+ * （参数改了以后，同一个种子生成的牌局也会变）
+ */
+struct DealOptions {
+    int minCards = 12;              // 总张数下限（主牌区+底牌堆，最多52张）
+    int maxCards = 20;              // 总张数上限
+    int minPlayfieldPercent = 60;   // 主牌区张数占总张数的百分比下限
+    int maxPlayfieldPercent = 75;   // 主牌区张数占总张数的百分比上限
+    bool requireFirstMove = true;   // 筛选条件：开局顶部牌至少能匹配一张主牌区的牌
+};
+
+/**
+ * DealCard - 发出的一张牌
+ */
+struct DealCard {
+    int8_t face;    // 点数（1-13）
+    int8_t suit;    // 花色（0-3）
+    float posX;     // 坐标X
+    float posY;     // 坐标Y
+};
+
+/**
+ * Deal - 一局牌的初始布局
+ * 卡牌不带ID，放进GameModel时才分配ID（和GameController::createCard一样）
+ */
+struct Deal {
+    static const int kMaxCards = 52;
+
+    uint64_t seed = 0;              // 生成这局牌的种子
+    int playfieldCount = 0;         // 主牌区张数
+    int stackCount = 0;             // 底牌堆张数（最后一张是顶部牌）
+    DealCard playfield[kMaxCards];  // 主牌区的牌（按添加顺序，后添加的显示在上面）
+    DealCard stack[kMaxCards];      // 底牌堆的牌（最后一张是顶部牌）
+
+    /**
+     * 把这局牌添加到模型中（不会清空模型，开局时先调用GameLogic::reset）
+     */
+    void applyTo(GameModel& model) const;
+};
+
+/**
+ * @brief DealGenerator - 根据种子生成牌局
+ *
+ * 算法（只用Random的整数运算，结果和平台无关）：
+ * 1. 在[minCards, maxCards]中选总张数，在百分比范围内选主牌区张数，底牌堆至少1张
+ * 2. 一副52张的牌洗牌（Fisher-Yates只洗需要的前N张），不会出现重复的牌
+ * 3. 主牌区的牌放在5列x11行的格子里随机选出的位置，从上往下添加（下面的牌盖住上面的牌）
+ * 4. 底牌堆：备用底牌在左边，顶部牌在右边（和原来的固定布局一样）
+ *
+ * 批量模式：多线程扫描一段连续的种子，留下满足筛选条件的种子，
+ * 输出顺序和线程数无关。
+ *
+ * 使用示例：
+ * Deal deal;
+ * DealGenerator::generate(seed, DealOptions(), deal);
+ * deal.applyTo(gameLogic.getModel());
+ */
+class DealGenerator {
+public:
+    /**
+     * 根据种子生成一局牌
+     * @param seed 种子
+     * @param options 发牌参数
+     * @param deal 输出：牌局
+     * @return true=满足筛选条件（不满足时deal仍然是完整的牌局）
+     */
+    static bool generate(uint64_t seed, const DealOptions& options, Deal& deal);
+
+    /**
+     * 检查一局牌是否满足筛选条件
+     */
+    static bool accepts(const Deal& deal, const DealOptions& options);
+
+    /**
+     * 批量生成：检查[firstSeed, firstSeed + seedCount)范围内的所有种子
+     * @param pool 线程池
+     * @param firstSeed 第一个种子
+     * @param seedCount 种子数量
+     * @param options 发牌参数和筛选条件
+     * @param acceptedSeeds 输出：满足条件的种子（从小到大，会先清空）
+     */
+    static void generateBatch(WorkStealingPool& pool, uint64_t firstSeed, uint64_t seedCount,
+                              const DealOptions& options, std::vector<uint64_t>& acceptedSeeds);
+};
@@ -0,0 +1,390 @@
+#include "GameLogic.h"
+#include "Trace.h"
+#include <cstdlib>
+
+GameLogic::GameLogic() : _observer(nullptr), _layoutReady(false), _packedCheckpoints(true), _startNextCardId(0) {
+}
+
+/**
+ * 重置游戏
+ * 清空模型（移除所有卡牌，重置ID计数器）和回退记录
+ */
+void GameLogic::reset() {
+    _gameModel.clear();
+    _undoManager.clear();
+    _layoutReady = false;
+    if (_observer) {
+        _observer->onGameReset();
+    }
+}
+
+/**
+ * 检查两张卡牌是否可以匹配
+ *
+ * 匹配规则：两张卡牌的点数差1即可匹配（无花色要求）
+ * 例如：A(1)和2可以匹配，2和3可以匹配，Q(12)和K(13)可以匹配
+ */
+bool GameLogic::canMatch(int card1Face, int card2Face) {
+    return std::abs(card1Face - card2Face) == 1;
+}
+
+/**
+ * 根据被点击的卡牌得到对应的操作
+ * 卡牌在哪个区域直接查模型的索引表，不需要查视图
+ */
+Move GameLogic::getMoveForCard(int cardId) const {
+    CardZone zone = _gameModel.getCardZone(cardId);
+    if (zone == CardZone::PLAYFIELD) {
+        return Move(MoveType::PLAYFIELD_MATCH, cardId);
+    }
+    if (zone == CardZone::STACK) {
+        return Move(MoveType::STACK_REPLACE, cardId);
+    }
+    return Move();
+}
+
+/**
+ * 检查一步操作是否合法
+ * - 匹配：卡牌在主牌区，并且和顶部底牌点数差1
+ * - 换底牌：卡牌是底牌堆中的备用底牌（不是顶部牌），并且顶部底牌和主牌区没有能匹配的牌
+ */
+bool GameLogic::isLegal(const Move& move) const {
+    if (!move.isValid()) return false;
+
+    const CardModel& topCard = _gameModel.getStackTopCard();
+    if (topCard.id == -1) return false;  // 没有顶部底牌，什么都不能做
+
+    if (move.type == MoveType::PLAYFIELD_MATCH) {
+        if (_gameModel.getCardZone(move.cardId) != CardZone::PLAYFIELD) return false;
+        return canMatch(_gameModel.getCardById(move.cardId).face, topCard.face);
+    }
+
+    if (move.type == MoveType::STACK_REPLACE) {
+        if (_gameModel.getCardZone(move.cardId) != CardZone::STACK) return false;
+        if (move.cardId == topCard.id) return false;  // 顶部牌只能用于匹配
+        return !_gameModel.hasPlayfieldMatchFor(topCard.face);  // 顶部牌能匹配时不允许换底牌
+    }
+    return false;
+}
+
+/**
+ * 列出当前所有合法操作
+ * 顶部牌能匹配时只有匹配操作，不能匹配时只有换底牌操作
+ */
+int GameLogic::legalMoves(std::vector<Move>& moves) const {
+    moves.clear();
+
+    const CardModel& topCard = _gameModel.getStackTopCard();
+    if (topCard.id == -1) return 0;
+
+    if (_gameModel.hasPlayfieldMatchFor(topCard.face)) {
+        for (const auto& card : _gameModel.getPlayfieldCards()) {
+            if (canMatch(card.face, topCard.face)) {
+                moves.push_back(Move(MoveType::PLAYFIELD_MATCH, card.id));
+            }
+        }
+    } else {
+        const auto& stackCards = _gameModel.getStackCards();
+        for (size_t i = 0; i + 1 < stackCards.size(); i++) {
+            moves.push_back(Move(MoveType::STACK_REPLACE, stackCards[i].id));
+        }
+    }
+    return (int)moves.size();
+}
+
+/**
+ * 执行一步操作
+ * 回退日志里只保存紧凑的UndoDelta，通知观察者时再展开成完整的UndoRecord
+ */
+bool GameLogic::applyMove(const Move& move) {
+    TRACE_ZONE("GameLogic::applyMove");
+    if (!isLegal(move)) return false;
+    // 回退日志用16位保存卡牌ID和底牌堆下标，超出范围的关卡不能执行（否则回退到错误的位置）
+    if (move.cardId >= UndoDelta::kInvalidCardId ||
+        _gameModel.getStackTopCard().id >= UndoDelta::kInvalidCardId) return false;
+
+    saveCheckpointIfNeeded();
+
+    UndoDelta delta;
+    if (move.type == MoveType::STACK_REPLACE) {
+        delta = applyStackReplace(move.cardId);
+    } else {
+        delta = applyPlayfieldMatch(move.cardId);
+    }
+
+    // 记录回退
+    _undoManager.push(delta);
+
+    if (_observer) {
+        _observer->onMoveApplied(move, expandRecord(delta));
+    }
+    return true;
+}
+
+/**
+ * 回退上一步操作
+ * 先展开记录（展开需要回退前的模型），再根据操作类型执行相应的回退，然后通知观察者
+ */
+bool GameLogic::undo() {
+    TRACE_ZONE("GameLogic::undo");
+    if (!_undoManager.canUndo()) return false;
+
+    UndoDelta delta = _undoManager.undo();
+    UndoRecord record = expandRecord(delta);
+    undoDelta(delta);
+
+    if (_observer) {
+        _observer->onMoveUndone(record);
+    }
+    return true;
+}
+
+/**
+ * 重做下一步操作
+ * 时间线上的记录本身就包含操作（卡牌ID和类型），直接重新执行，然后像普通操作一样通知观察者
+ */
+bool GameLogic::redo() {
+    TRACE_ZONE("GameLogic::redo");
+    if (!_undoManager.canRedo()) return false;
+
+    saveCheckpointIfNeeded();
+    UndoDelta delta = _undoManager.redo();
+    redoDelta(delta);
+
+    if (_observer) {
+        _observer->onMoveApplied(Move((MoveType)delta.moveType, delta.cardId), expandRecord(delta));
+    }
+    return true;
+}
+
+/**
+ * 跳到时间线上的某个位置
+ *
+ * 可选的起点：
+ * 1. 当前位置，逐步回退/重做
+ * 2. 目标位置之前最近的检查点，往后重做
+ * 3. 目标位置之后最近的检查点，往前回退
+ * 选需要执行步数最少的起点，所以有检查点时最多执行kCheckpointInterval步，和时间线多长无关。
+ * 跳转过程中不通知每一步，跳完后通知一次onGameReset，由视图整体刷新
+ */
+bool GameLogic::seek(int position) {
+    TRACE_ZONE("GameLogic::seek");
+    if (position < _undoManager.getFirstPosition() || position > _undoManager.getEndPosition()) return false;
+    if (position == _undoManager.getPosition()) return true;
+
+    const int interval = UndoManager::kCheckpointInterval;
+    int bestStart = _undoManager.getPosition();
+    int bestCost = std::abs(position - bestStart);
+    bool useCheckpoint = false;
+
+    if (_layoutReady) {
+        int before = position - position % interval;
+        if (before >= _undoManager.getFirstPosition() && position - before < bestCost &&
+            _undoManager.hasCheckpoint(before)) {
+            bestStart = before;
+            bestCost = position - before;
+            useCheckpoint = true;
+        }
+        int after = before + interval;
+        if (after <= _undoManager.getEndPosition() && after - position < bestCost &&
+            _undoManager.hasCheckpoint(after)) {
+            bestStart = after;
+            bestCost = after - position;
+            useCheckpoint = true;
+        }
+    }
+
+    if (useCheckpoint) {
+        restoreCheckpoint(bestStart);
+        _undoManager.setPosition(bestStart);
+    }
+    while (_undoManager.getPosition() < position) {
+        saveCheckpointIfNeeded();
+        redoDelta(_undoManager.redo());
+    }
+    while (_undoManager.getPosition() > position) {
+        undoDelta(_undoManager.undo());
+    }
+
+    if (_observer) {
+        _observer->onGameReset();
+    }
+    return true;
+}
+
+UndoDelta GameLogic::applyStackReplace(int clickedCardId) {
+    UndoDelta delta;
+    delta.cardId = (uint16_t)clickedCardId;
+    delta.moveType = (uint8_t)MoveType::STACK_REPLACE;
+    delta.data = (uint16_t)_gameModel.getStackIndex(clickedCardId);
+
+    // 将点击的卡牌移到底牌堆末尾（成为顶部，-1表示放到顶部）
+    _gameModel.moveStackCard(clickedCardId, -1);
+    return delta;
+}
+
+UndoDelta GameLogic::applyPlayfieldMatch(int playfieldCardId) {
+    // 这里需要拷贝：下面修改模型后，getCardById返回的引用会失效
+    CardModel playfieldCard = _gameModel.getCardById(playfieldCardId);
+    CardModel stackCard = _gameModel.getStackTopCard();
+
+    UndoDelta delta;
+    delta.cardId = (uint16_t)playfieldCardId;
+    delta.oldTopCardId = (uint16_t)stackCard.id;
+    delta.moveType = (uint8_t)MoveType::PLAYFIELD_MATCH;
+    delta.data = (uint16_t)(stackCard.face | (stackCard.suit << 4));
+
+    // 更新模型：
+    // 1. 将主牌区的卡牌移出主牌区
+    // 2. 将原来的顶部卡牌从底牌堆移除（直接消失）
+    // 3. 将主牌区的卡牌添加到底牌堆（成为新的顶部）
+    // 注意：posX/posY保留卡牌在主牌区的原始位置，底牌堆中的显示位置由StackView布局决定
+    _gameModel.removeCardFromPlayfield(playfieldCardId);
+    _gameModel.removeCardFromStack(stackCard.id);
+    _gameModel.addCardToStack(playfieldCard);
+    return delta;
+}
+
+/**
+ * 把紧凑记录展开成完整的回退记录
+ * 必须在"操作刚执行完/回退之前"的模型上调用：这时被操作的卡牌一定是底牌堆的顶部牌
+ */
+UndoRecord GameLogic::expandRecord(const UndoDelta& delta) const {
+    const CardModel& card = _gameModel.getCardById(delta.cardId);
+
+    UndoRecord record;
+    record.cardId = delta.cardId;
+    record.moveType = (MoveType)delta.moveType;
+    record.originalPosX = card.posX;
+    record.originalPosY = card.posY;
+    record.cardFace = card.face;
+    record.cardSuit = card.suit;
+
+    if (record.moveType == MoveType::STACK_REPLACE) {
+        // 原来的顶部牌在被点击的卡牌下面一格
+        const auto& stackCards = _gameModel.getStackCards();
+        record.targetCardId = stackCards.size() >= 2 ? stackCards[stackCards.size() - 2].id : -1;
+        record.originalStackIndex = delta.data;
+        record.oldTopCardFace = 0;
+        record.oldTopCardSuit = 0;
+    } else {
+        record.targetCardId = delta.oldTopCardId;
+        record.originalStackIndex = -1;
+        record.oldTopCardFace = delta.data & 0x0F;
+        record.oldTopCardSuit = delta.data >> 4;
+    }
+    return record;
+}
+
+/**
+ * 按记录重新执行一步（不检查合法性，记录本来就是合法操作留下的）
+ */
+void GameLogic::redoDelta(const UndoDelta& delta) {
+    if ((MoveType)delta.moveType == MoveType::STACK_REPLACE) {
+        applyStackReplace(delta.cardId);
+    } else {
+        applyPlayfieldMatch(delta.cardId);
+    }
+}
+
+/**
+ * 按记录回退一步
+ */
+void GameLogic::undoDelta(const UndoDelta& delta) {
+    if ((MoveType)delta.moveType == MoveType::STACK_REPLACE) {
+        undoStackReplace(delta);
+    } else {
+        undoPlayfieldMatch(delta);
+    }
+}
+
+/**
+ * 当前位置是检查点位置时保存局面
+ * 第一次保存时（开局，所有卡牌都在）生成布局，之后的检查点都用这个布局压缩；
+ * 卡牌超过64张无法压缩时改为保存两个区域的完整数组（开局时记下所有卡牌的坐标，恢复时用），
+ * 所以大关卡的跳转同样最多执行kCheckpointInterval步
+ */
+void GameLogic::saveCheckpointIfNeeded() {
+    if (!_undoManager.needsCheckpoint()) return;
+
+    PackedGameState state;
+    if (!_layoutReady) {
+        if (_undoManager.getPosition() != 0) return;
+        _packedCheckpoints = PackedGameState::fromModel(_gameModel, state, _layout);
+        if (!_packedCheckpoints) {
+            const auto& playfieldCards = _gameModel.getPlayfieldCards();
+            const auto& stackCards = _gameModel.getStackCards();
+            _startCards.assign(playfieldCards.begin(), playfieldCards.end());
+            _startCards.insert(_startCards.end(), stackCards.begin(), stackCards.end());
+            _startNextCardId = _gameModel.peekNextCardId();
+        }
+        _layoutReady = true;
+    } else if (_packedCheckpoints && !PackedGameState::fromModel(_gameModel, _layout, state)) {
+        return;
+    }
+
+    if (_packedCheckpoints) {
+        _undoManager.saveCheckpoint(state);
+    } else {
+        _undoManager.saveCheckpoint(_gameModel);
+    }
+}
+
+/**
+ * 从检查点恢复模型
+ * 完整检查点和PackedGameState::toModel一样：先清空模型，记住开局时所有卡牌的坐标，再按保存的顺序添加卡牌
+ */
+void GameLogic::restoreCheckpoint(int position) {
+    if (_packedCheckpoints) {
+        PackedGameState state;
+        if (_undoManager.findCheckpoint(position, state)) {
+            state.toModel(_layout, _gameModel);
+        }
+        return;
+    }
+
+    if (!_undoManager.findCheckpoint(position, _checkpointPlayfield, _checkpointStack)) return;
+    _gameModel.clear();
+    _gameModel.setNextCardId(_startNextCardId);
+    for (const auto& card : _startCards) {
+        _gameModel.rememberPosition(card.id, card.posX, card.posY);
+    }
+    for (const auto& card : _checkpointPlayfield) {
+        _gameModel.addCardToPlayfield(card);
+    }
+    for (const auto& card : _checkpointStack) {
+        _gameModel.addCardToStack(card);
+    }
+}
+
+/**
+ * 执行底牌替换的回退操作
+ * 将卡牌移回底牌堆中原来的索引位置
+ */
+void GameLogic::undoStackReplace(const UndoDelta& delta) {
+    _gameModel.moveStackCard(delta.cardId, delta.data);
+}
+
+/**
+ * 执行主牌区匹配的回退操作
+ * 1. 从底牌堆移除当前顶部卡牌（原来主牌区的卡牌，坐标仍然是它在主牌区的位置）
+ * 2. 恢复原顶部卡牌到底牌堆（坐标从模型的索引表里查）
+ * 3. 恢复主牌区的卡牌
+ */
+void GameLogic::undoPlayfieldMatch(const UndoDelta& delta) {
+    CardModel originalCard = _gameModel.getCardById(delta.cardId);
+
+    CardModel oldTopCard;
+    oldTopCard.id = delta.oldTopCardId;
+    oldTopCard.face = delta.data & 0x0F;
+    oldTopCard.suit = delta.data >> 4;
+    oldTopCard.isFaceUp = true;
+    if (!_gameModel.getLastPosition(oldTopCard.id, oldTopCard.posX, oldTopCard.posY)) {
+        oldTopCard.posX = 800;  // 主底牌位置
+        oldTopCard.posY = 290;
+    }
+
+    _gameModel.removeCardFromStack(delta.cardId);
+    _gameModel.addCardToStack(oldTopCard);
+    _gameModel.addCardToPlayfield(originalCard);
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include "models/GameModel.h"
+#include "models/MoveModel.h"
+#include "models/PackedGameState.h"
+#include "managers/UndoManager.h"
+#include "GameObserver.h"
+#include <vector>
+
+/**
+ * @brief GameLogic - 游戏核心逻辑（不依赖cocos2d）
+ *
+ * 这个类包含游戏规则、模型修改和回退，是从GameController中拆出来的纯C++部分。
+ * 它可以单独编译成core库（见core/CMakeLists.txt），在没有图形环境的服务器上
+ * 跑大量模拟对局、求解器等。
+ *
+ * 职责：
+ * - 持有GameModel和UndoManager
+ * - 判断一步操作是否合法，列出所有合法操作
+ * - 执行操作、回退操作，并通知观察者
+ *
+ * 使用示例：
+ * GameLogic logic;
+ * // ...往logic.getModel()里添加卡牌...
+ * std::vector<Move> moves;
+ * if (logic.legalMoves(moves) > 0) {
+ *     logic.applyMove(moves[0]);
+ *     logic.undo();
+ * }
+ */
+class GameLogic {
+public:
+    GameLogic();
+
+    /**
+     * 设置观察者（比如GameController），传nullptr表示不通知
+     */
+    void setObserver(GameObserver* observer) { _observer = observer; }
+
+    /**
+     * 获取游戏模型
+     * 注意：直接修改模型（比如添加卡牌）只应该在开局时进行，开局后请通过applyMove修改
+     */
+    GameModel& getModel() { return _gameModel; }
+    const GameModel& getModel() const { return _gameModel; }
+
+    /**
+     * 重置游戏：清空模型和回退记录，并通知观察者
+     */
+    void reset();
+
+    /**
+     * 检查两张卡牌是否可以匹配（点数差1，无花色要求）
+     */
+    static bool canMatch(int card1Face, int card2Face);
+
+    /**
+     * 根据被点击的卡牌得到对应的操作
+     * 卡牌在主牌区 -> PLAYFIELD_MATCH，在底牌堆 -> STACK_REPLACE
+     * @param cardId 被点击的卡牌ID
+     * @return 对应的操作，卡牌不存在时返回无效操作（不检查是否合法）
+     */
+    Move getMoveForCard(int cardId) const;
+
+    /**
+     * 检查一步操作在当前状态下是否合法
+     */
+    bool isLegal(const Move& move) const;
+
+    /**
+     * 列出当前所有合法操作
+     * @param moves 输出：合法操作列表（会先清空）
+     * @return 合法操作的数量
+     */
+    int legalMoves(std::vector<Move>& moves) const;
+
+    /**
+     * 执行一步操作
+     * 检查合法性 -> 修改模型 -> 记录回退 -> 通知观察者
+     * @return true=执行成功, false=操作不合法
+     */
+    bool applyMove(const Move& move);
+
+    /**
+     * 设置时间线长度（最多能回退多少步），会清空回退记录，只在开局前调用
+     */
+    void setUndoCapacity(int capacity) { _undoManager.setCapacity(capacity); }
+
+    /**
+     * 是否可以回退
+     */
+    bool canUndo() const { return _undoManager.canUndo(); }
+
+    /**
+     * 回退上一步操作
+     * @return true=回退成功, false=没有可以回退的操作
+     */
+    bool undo();
+
+    /**
+     * 是否可以重做
+     */
+    bool canRedo() const { return _undoManager.canRedo(); }
+
+    /**
+     * 重做被回退的下一步操作（通知观察者onMoveApplied）
+     * @return true=重做成功, false=没有可以重做的操作
+     */
+    bool redo();
+
+    /**
+     * 跳到时间线上的第position步之后（0表示开局）
+     * 从最近的检查点恢复再重放，最多执行UndoManager::kCheckpointInterval步；
+     * 跳转完成后通知观察者onGameReset（不逐步通知）
+     * @param position 目标位置，范围[getFirstMovePosition(), getLastMovePosition()]
+     * @return false=位置超出范围
+     */
+    bool seek(int position);
+
+    /**
+     * 时间线：当前位置、最早能回到的位置、最后能重做到的位置
+     */
+    int getMovePosition() const { return _undoManager.getPosition(); }
+    int getFirstMovePosition() const { return _undoManager.getFirstPosition(); }
+    int getLastMovePosition() const { return _undoManager.getEndPosition(); }
+
+    /**
+     * 是否还有可以走的步（O(1)）
+     */
+    bool hasMovesLeft() const { return _gameModel.hasMovesLeft(); }
+
+    /**
+     * 是否已经赢了（主牌区清空）
+     */
+    bool isWon() const { return _gameModel.getPlayfieldCards().empty(); }
+
+private:
+    GameModel _gameModel;
+    UndoManager _undoManager;
+    GameObserver* _observer;
+    PackedLayout _layout;       // 开局时生成的布局，所有检查点共用
+    bool _layoutReady;          // 开局的检查点是否已经保存（之后才保存其他检查点）
+    bool _packedCheckpoints;    // true=检查点是PackedGameState，false=卡牌太多，保存完整数组
+    std::vector<CardModel> _startCards;         // 完整检查点：开局时所有卡牌（恢复时记住已移除卡牌的坐标）
+    int _startNextCardId;                       // 完整检查点：开局时的卡牌ID计数器
+    std::vector<CardModel> _checkpointPlayfield;    // 恢复完整检查点时的临时数组（复用）
+    std::vector<CardModel> _checkpointStack;
+
+    /**
+     * 执行换底牌：备用底牌移到顶部
+     */
+    UndoDelta applyStackReplace(int clickedCardId);
+
+    /**
+     * 执行匹配：主牌区卡牌替换顶部底牌，原顶部牌消失
+     */
+    UndoDelta applyPlayfieldMatch(int playfieldCardId);
+
+    /**
+     * 根据紧凑记录和当前模型生成完整的回退记录（给观察者用）
+     */
+    UndoRecord expandRecord(const UndoDelta& delta) const;
+
+    /**
+     * 按记录重新执行/回退一步（重做、跳转时使用，不通知观察者）
+     */
+    void redoDelta(const UndoDelta& delta);
+    void undoDelta(const UndoDelta& delta);
+
+    /**
+     * 当前位置需要检查点时保存一个
+     */
+    void saveCheckpointIfNeeded();
+
+    /**
+     * 从第position步的检查点恢复模型（检查点必须存在）
+     */
+    void restoreCheckpoint(int position);
+
+    /**
+     * 执行换底牌的回退
+     */
+    void undoStackReplace(const UndoDelta& delta);
+
+    /**
+     * 执行匹配的回退
+     */
+    void undoPlayfieldMatch(const UndoDelta& delta);
+};
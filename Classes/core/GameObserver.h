@@ -0,0 +1,35 @@
+#pragma once
+#include "models/MoveModel.h"
+#include "models/UndoModel.h"
+
+/**
+ * @brief GameObserver - 游戏逻辑观察者接口
+ *
+ * GameLogic修改完模型后，通过这个接口通知外部"发生了什么"。
+ * 逻辑层只负责规则和数据，不知道界面的存在；界面（GameController）实现这个接口，
+ * 在回调里播放动画、更新视图。没有界面时（求解器、模拟对局）可以不设置观察者。
+ *
+ * 注意：回调时模型已经是修改之后的状态
+ */
+class GameObserver {
+public:
+    virtual ~GameObserver() {}
+
+    /**
+     * 一步操作执行完成
+     * @param move 执行的操作
+     * @param record 这一步的回退记录（包含操作前的信息，比如原顶部牌）
+     */
+    virtual void onMoveApplied(const Move& move, const UndoRecord& record) = 0;
+
+    /**
+     * 一步操作被回退
+     * @param record 被回退的操作记录
+     */
+    virtual void onMoveUndone(const UndoRecord& record) = 0;
+
+    /**
+     * 游戏被重置（模型被清空或整体替换）
+     */
+    virtual void onGameReset() {}
+};
@@ -0,0 +1,248 @@
+#include "GameSolver.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * 哈希值0表示置换表中的空位，遇到真正为0的哈希换成1
+ */
+static inline uint64_t tableKey(uint64_t hash) {
+    return hash == 0 ? 1 : hash;
+}
+
+TranspositionTable::TranspositionTable(size_t initialCapacity, size_t maxBytes)
+    : _size(0), _maxBytes(maxBytes) {
+    size_t capacity = 16;
+    while (capacity < initialCapacity) {
+        capacity <<= 1;
+    }
+    _keys.assign(capacity, 0);
+}
+
+int TranspositionTable::insert(uint64_t key) {
+    key = tableKey(key);
+    // 装载率超过一半时扩容，保证线性探测的链很短
+    if ((_size + 1) * 2 > _keys.size() && !grow()) {
+        if (contains(key)) return 0;
+        return -1;
+    }
+
+    size_t mask = _keys.size() - 1;
+    size_t index = (size_t)(key ^ (key >> 32)) & mask;
+    while (_keys[index] != 0) {
+        if (_keys[index] == key) return 0;
+        index = (index + 1) & mask;
+    }
+    _keys[index] = key;
+    _size++;
+    return 1;
+}
+
+bool TranspositionTable::contains(uint64_t key) const {
+    key = tableKey(key);
+    size_t mask = _keys.size() - 1;
+    size_t index = (size_t)(key ^ (key >> 32)) & mask;
+    while (_keys[index] != 0) {
+        if (_keys[index] == key) return true;
+        index = (index + 1) & mask;
+    }
+    return false;
+}
+
+void TranspositionTable::clear() {
+    std::fill(_keys.begin(), _keys.end(), 0);
+    _size = 0;
+}
+
+/**
+ * 容量翻倍并重新插入所有键
+ * @return false=翻倍后会超过内存上限
+ */
+bool TranspositionTable::grow() {
+    size_t newCapacity = _keys.size() * 2;
+    if (newCapacity * sizeof(uint64_t) > _maxBytes) return false;
+
+    std::vector<uint64_t> oldKeys(newCapacity, 0);
+    oldKeys.swap(_keys);
+
+    size_t mask = newCapacity - 1;
+    for (uint64_t key : oldKeys) {
+        if (key == 0) continue;
+        size_t index = (size_t)(key ^ (key >> 32)) & mask;
+        while (_keys[index] != 0) {
+            index = (index + 1) & mask;
+        }
+        _keys[index] = key;
+    }
+    return true;
+}
+
+GameSolver::GameSolver(const SolverOptions& options)
+    : _options(options), _table(1 << 16, options.maxTableBytes) {
+}
+
+SolverResult GameSolver::solve(const GameModel& model) {
+    SolverResult result;
+
+    PackedGameState state;
+    PackedLayout layout;
+    if (!PackedGameState::fromModel(model, state, layout)) {
+        result.status = SolveStatus::INVALID;
+        return result;
+    }
+
+    std::vector<PackedMove> path;
+    solvePacked(state, path, result);
+    if (result.status == SolveStatus::SOLVED) {
+        toMoves(layout, path, result.moves);
+    }
+    return result;
+}
+
+/**
+ * 深度优先搜索
+ *
+ * 每一层保存一个Frame：这一层的所有走法和下一个要尝试的走法。
+ * 进入一个新局面时先查置换表，访问过就直接回溯。
+ * 找到主牌区清空的局面时，栈里每一层正在尝试的走法连起来就是答案。
+ */
+void GameSolver::solvePacked(const PackedGameState& start, std::vector<PackedMove>& path, SolverResult& result) {
+    struct Frame {
+        PackedMove moves[PackedGameState::kMaxMoves];
+        int count;
+        int next;
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    _table.clear();
+    path.clear();
+    result.nodes = 0;
+    result.peakTableBytes = 0;
+    result.status = SolveStatus::UNSOLVABLE;
+
+    PackedGameState state = start;
+    std::vector<Frame> stack;
+    stack.reserve(256);
+
+    // 把当前局面作为新的一层压栈；返回false表示这个局面不用再展开
+    auto enter = [&]() -> bool {
+        result.nodes++;
+        int inserted = _table.insert(state.hash());
+        if (inserted == 0) return false;
+        if (inserted < 0) {
+            result.status = SolveStatus::LIMIT_REACHED;
+            return false;
+        }
+        stack.push_back(Frame());
+        Frame& frame = stack.back();
+        frame.count = pruneMoves(state, frame.moves, state.generateMoves(frame.moves));
+        frame.next = 0;
+        orderMoves(state, frame.moves, frame.count);
+        return true;
+    };
+
+    if (state.isWon()) {
+        result.status = SolveStatus::SOLVED;
+    } else {
+        enter();
+    }
+
+    while (!stack.empty() && result.status == SolveStatus::UNSOLVABLE) {
+        if (_options.maxNodes > 0 && result.nodes >= _options.maxNodes) {
+            result.status = SolveStatus::LIMIT_REACHED;
+            break;
+        }
+
+        Frame& frame = stack.back();
+        if (frame.next >= frame.count) {
+            // 这一层的走法都试完了，回溯到上一层
+            stack.pop_back();
+            if (!stack.empty()) {
+                Frame& parent = stack.back();
+                state.unapply(parent.moves[parent.next - 1]);
+            }
+            continue;
+        }
+
+        PackedMove move = frame.moves[frame.next++];
+        state.apply(move);
+        if (state.isWon()) {
+            result.status = SolveStatus::SOLVED;
+            break;
+        }
+        if (!enter()) {
+            state.unapply(move);
+        }
+    }
+
+    if (result.status == SolveStatus::SOLVED) {
+        for (const auto& frame : stack) {
+            path.push_back(frame.moves[frame.next - 1]);
+        }
+    }
+
+    result.peakTableBytes = _table.getBytes();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * 去掉没有意义的换底牌操作
+ * 换上来的牌如果也不能匹配，下一步还是只能换底牌，而那些局面从当前局面一步就能到达，
+ * 所以只保留"换上来以后能匹配"的换底牌操作；一个都没有时这个局面就是死局
+ */
+int GameSolver::pruneMoves(const PackedGameState& state, PackedMove* moves, int count) {
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (moves[i].type == PACKED_MOVE_STACK_REPLACE && !state.hasMatchFor(state.getFace(moves[i].card))) {
+            continue;
+        }
+        moves[kept++] = moves[i];
+    }
+    return kept;
+}
+
+/**
+ * 走法排序（分数高的先尝试）
+ * - 匹配：消掉这张牌后它成为新的顶部牌，主牌区还有几种能接着匹配它的点数
+ * - 换底牌：换上来的牌在主牌区有几种能匹配的点数；同分时靠近顶部的优先
+ * 用稳定排序，同分时保持生成顺序，保证结果确定
+ */
+void GameSolver::orderMoves(const PackedGameState& state, PackedMove* moves, int count) {
+    if (count < 2) return;
+
+    int scores[PackedGameState::kMaxMoves];
+    int order[PackedGameState::kMaxMoves];
+    for (int i = 0; i < count; i++) {
+        int face = state.getFace(moves[i].card);
+        uint16_t mask = state.faceMask & GameModel::getMatchMaskForFace(face);
+        int score = 0;
+        for (uint16_t bits = mask; bits != 0; bits &= bits - 1) {
+            score++;
+        }
+        if (moves[i].type == PACKED_MOVE_STACK_REPLACE) {
+            score = score * 256 + moves[i].fromIndex;
+        }
+        scores[i] = score;
+        order[i] = i;
+    }
+
+    std::stable_sort(order, order + count, [&scores](int a, int b) {
+        return scores[a] > scores[b];
+    });
+
+    PackedMove sorted[PackedGameState::kMaxMoves];
+    for (int i = 0; i < count; i++) {
+        sorted[i] = moves[order[i]];
+    }
+    for (int i = 0; i < count; i++) {
+        moves[i] = sorted[i];
+    }
+}
+
+void GameSolver::toMoves(const PackedLayout& layout, const std::vector<PackedMove>& path, std::vector<Move>& moves) {
+    moves.clear();
+    moves.reserve(path.size());
+    for (const auto& packed : path) {
+        MoveType type = packed.type == PACKED_MOVE_MATCH ? MoveType::PLAYFIELD_MATCH : MoveType::STACK_REPLACE;
+        moves.push_back(Move(type, layout.cardIds[packed.card]));
+    }
+}
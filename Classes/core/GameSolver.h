@@ -0,0 +1,147 @@
+#pragma once
+#include "models/GameModel.h"
+#include "models/MoveModel.h"
+#include "models/PackedGameState.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * SolveStatus - 求解结果状态
+ */
+enum class SolveStatus {
+    SOLVED,         // 找到了一组能清空主牌区的操作
+    UNSOLVABLE,     // 搜索完所有局面，证明这一局赢不了
+    LIMIT_REACHED,  // 达到节点数或内存上限，没有结论
+    INVALID         // 局面无法压缩（卡牌太多或数据不合法）
+};
+
+/**
+ * SolverOptions - 求解器参数
+ */
+struct SolverOptions {
+    uint64_t maxNodes = 0;                      // 最多展开的节点数，0表示不限制
+    size_t maxTableBytes = 256 * 1024 * 1024;   // 置换表最多占用的内存（字节）
+};
+
+/**
+ * SolverResult - 求解结果
+ *
+ * moves里保存的是卡牌ID和操作类型，可以按顺序交给GameLogic::applyMove()，
+ * 或者依次调用GameController::onCardClicked(move.cardId)重放
+ */
+struct SolverResult {
+    SolveStatus status = SolveStatus::INVALID;  // 求解结果状态
+    std::vector<Move> moves;                    // 获胜的操作序列（status为SOLVED时有效）
+    uint64_t nodes = 0;                         // 展开的节点数
+    double seconds = 0.0;                       // 求解耗时（秒）
+    size_t peakTableBytes = 0;                  // 置换表的峰值内存（字节）
+
+    /**
+     * 每秒展开的节点数
+     */
+    double getNodesPerSecond() const { return seconds > 0.0 ? (double)nodes / seconds : 0.0; }
+};
+
+/**
+ * @brief TranspositionTable - 置换表（已访问局面的哈希集合）
+ *
+ * 开放寻址的64位哈希集合，只保存局面哈希，不保存局面本身（每项8字节）。
+ * 装载率超过一半时容量翻倍。
+ * 注意：两个不同局面哈希相同的概率极低（64位），这里直接当作同一个局面处理
+ */
+class TranspositionTable {
+public:
+    /**
+     * @param initialCapacity 初始容量（会向上取到2的幂）
+     * @param maxBytes 最多占用的内存，扩容会超过它时插入失败
+     */
+    TranspositionTable(size_t initialCapacity, size_t maxBytes);
+
+    /**
+     * 插入一个局面哈希
+     * @return 1=新插入, 0=已经存在, -1=表满了（达到内存上限）
+     */
+    int insert(uint64_t key);
+
+    /**
+     * 是否包含某个局面哈希
+     */
+    bool contains(uint64_t key) const;
+
+    /**
+     * 清空（保留已分配的内存）
+     */
+    void clear();
+
+    size_t size() const { return _size; }
+    size_t getBytes() const { return _keys.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> _keys;  // 0表示空位
+    size_t _size;
+    size_t _maxBytes;
+
+    bool grow();
+};
+
+/**
+ * @brief GameSolver - 单线程求解器
+ *
+ * 给定一个GameModel，判断这一局能不能赢（清空主牌区），能赢时给出操作序列。
+ *
+ * 算法：
+ * - 在PackedGameState上做深度优先搜索，apply/unapply不复制状态
+ * - 置换表记录访问过的局面，同一个局面只展开一次（换底牌会形成环，也靠它避免死循环）
+ * - 局面不区分备用底牌的顺序（见PackedGameState），换底牌只换"换上来能匹配"的牌
+ * - 走法排序：匹配时优先选"消掉以后新的顶部牌还能继续匹配"的牌；
+ *   换底牌时优先换"换上来以后能匹配"的牌
+ * - 用显式栈代替递归，深度很大时也不会栈溢出
+ *
+ * 使用示例：
+ * GameSolver solver;
+ * SolverResult result = solver.solve(model);
+ * if (result.status == SolveStatus::SOLVED) { ... }
+ */
+class GameSolver {
+public:
+    explicit GameSolver(const SolverOptions& options = SolverOptions());
+
+    /**
+     * 求解一局游戏
+     * @param model 当前游戏模型（不会被修改）
+     * @return 求解结果
+     */
+    SolverResult solve(const GameModel& model);
+
+    /**
+     * 在紧凑状态上求解（求解器之间复用，结果的moves是卡牌下标，需要用layout换成卡牌ID）
+     * @param state 起始状态（不会被修改）
+     * @param path 输出：获胜的操作序列
+     * @param result 输出：状态、节点数、内存统计
+     */
+    void solvePacked(const PackedGameState& state, std::vector<PackedMove>& path, SolverResult& result);
+
+    /**
+     * 去掉不可能通向胜利的走法（换上来以后仍然不能匹配的换底牌操作）
+     * @return 剩下的走法数量
+     */
+    static int pruneMoves(const PackedGameState& state, PackedMove* moves, int count);
+
+    /**
+     * 对走法排序（并行求解器也使用同样的顺序，保证结果一致）
+     * @param state 当前状态
+     * @param moves 由state.generateMoves生成的走法
+     * @param count 走法数量
+     */
+    static void orderMoves(const PackedGameState& state, PackedMove* moves, int count);
+
+    /**
+     * 把紧凑状态上的操作序列换成卡牌ID表示的操作序列
+     */
+    static void toMoves(const PackedLayout& layout, const std::vector<PackedMove>& path, std::vector<Move>& moves);
+
+private:
+    SolverOptions _options;
+    TranspositionTable _table;
+};
@@ -0,0 +1,123 @@
+#include "InputLatencyTracker.h"
+#include <chrono>
+#include <cstdio>
+
+const int InputLatencyTracker::kMaxInFlight;
+
+InputLatencyTracker::InputLatencyTracker() : _nextId(0), _hasInput(false), _inputTime(0), _clickTime(0) {
+}
+
+uint64_t InputLatencyTracker::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void InputLatencyTracker::beginInput(uint64_t timeNs) {
+    _hasInput = true;
+    _inputTime = timeNs;
+    _clickTime = 0;
+}
+
+bool InputLatencyTracker::takeInput(uint64_t& timeNs) {
+    if (!_hasInput) return false;
+    _hasInput = false;
+    timeNs = _inputTime;
+    return true;
+}
+
+void InputLatencyTracker::markClick(uint64_t timeNs) {
+    if (_hasInput && _clickTime == 0) {
+        _clickTime = timeNs;
+    }
+}
+
+/**
+ * CLICK阶段在提交时才记（这时才知道操作类型），点了不能操作的牌的输入不会进入统计
+ */
+int InputLatencyTracker::commit(LatencyAction action, uint64_t timeNs) {
+    if (!_hasInput || action >= LatencyAction::COUNT) return -1;
+    _hasInput = false;
+
+    LatencyHistogram* histograms = _histograms[(int)action];
+    if (_clickTime != 0) {
+        histograms[(int)LatencyStage::CLICK].record(_clickTime > _inputTime ? _clickTime - _inputTime : 0);
+    }
+    histograms[(int)LatencyStage::COMMIT].record(timeNs > _inputTime ? timeNs - _inputTime : 0);
+
+    int id = _nextId;
+    _nextId = _nextId == INT32_MAX ? 0 : _nextId + 1;
+    InFlight& entry = _inFlight[id % kMaxInFlight];
+    entry.id = id;
+    entry.action = action;
+    entry.inputTime = _inputTime;
+    return id;
+}
+
+void InputLatencyTracker::markStage(int input, LatencyStage stage, uint64_t timeNs) {
+    if (input < 0 || stage >= LatencyStage::COUNT) return;
+    InFlight& entry = _inFlight[input % kMaxInFlight];
+    if (entry.id != input) return;
+    uint64_t latency = timeNs > entry.inputTime ? timeNs - entry.inputTime : 0;
+    _histograms[(int)entry.action][(int)stage].record(latency);
+    if (stage == LatencyStage::ANIMATION_END) {
+        entry.id = -1;
+    }
+}
+
+const LatencyHistogram& InputLatencyTracker::getHistogram(LatencyAction action, LatencyStage stage) const {
+    return _histograms[(int)action][(int)stage];
+}
+
+void InputLatencyTracker::reset() {
+    for (auto& actionHistograms : _histograms) {
+        for (auto& histogram : actionHistograms) {
+            histogram.reset();
+        }
+    }
+    for (auto& entry : _inFlight) {
+        entry.id = -1;
+    }
+    _hasInput = false;
+    _clickTime = 0;
+}
+
+const char* InputLatencyTracker::getActionName(LatencyAction action) {
+    switch (action) {
+        case LatencyAction::STACK_REPLACE: return "stack_replace";
+        case LatencyAction::PLAYFIELD_MATCH: return "playfield_match";
+        case LatencyAction::UNDO: return "undo";
+        case LatencyAction::REDO: return "redo";
+        default: return "unknown";
+    }
+}
+
+const char* InputLatencyTracker::getStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::CLICK: return "click";
+        case LatencyStage::COMMIT: return "commit";
+        case LatencyStage::ANIMATION_START: return "animation_start";
+        case LatencyStage::ANIMATION_END: return "animation_end";
+        default: return "unknown";
+    }
+}
+
+/**
+ * 没有记录的组合不输出
+ */
+std::string InputLatencyTracker::formatReport() const {
+    std::string report = "action,stage,count,p50_ms,p90_ms,p99_ms,max_ms,mean_ms\n";
+    char line[256];
+    for (int action = 0; action < (int)LatencyAction::COUNT; action++) {
+        for (int stage = 0; stage < (int)LatencyStage::COUNT; stage++) {
+            const LatencyHistogram& histogram = _histograms[action][stage];
+            if (histogram.getCount() == 0) continue;
+            snprintf(line, sizeof(line), "%s,%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                     getActionName((LatencyAction)action), getStageName((LatencyStage)stage),
+                     (unsigned long long)histogram.getCount(), histogram.getPercentile(50) / 1e6,
+                     histogram.getPercentile(90) / 1e6, histogram.getPercentile(99) / 1e6, histogram.getMax() / 1e6,
+                     histogram.getMean() / 1e6);
+            report += line;
+        }
+    }
+    return report;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "LatencyHistogram.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * 统计延迟的操作类型
+ */
+enum class LatencyAction : uint8_t {
+    STACK_REPLACE = 0,      // 点底牌堆的备用牌
+    PLAYFIELD_MATCH = 1,    // 点主牌区的牌匹配
+    UNDO = 2,               // 回退按钮
+    REDO = 3,               // 重做按钮
+    COUNT = 4
+};
+
+/**
+ * 一次输入经过的阶段（都从输入开始算起）
+ */
+enum class LatencyStage : uint8_t {
+    CLICK = 0,              // 控制器收到点击（GameController::onCardClicked / onUndoClicked / onRedoClicked）
+    COMMIT = 1,             // 模型修改完成（GameObserver回调）
+    ANIMATION_START = 2,    // 开始播放动画
+    ANIMATION_END = 3,      // 动画完成回调
+    COUNT = 4
+};
+
+/**
+ * @brief InputLatencyTracker - 输入到显示的延迟统计（不依赖cocos2d）
+ *
+ * 一次输入：触摸（或按钮）-> 控制器收到点击 -> 模型修改完成 -> 动画开始 -> 动画完成，
+ * 每个阶段相对输入时间的延迟按操作类型分别记在LatencyHistogram里，可以随时查询p50/p99/最大值。
+ *
+ * 时间由调用者传入（纳秒，单调递增，一般用now()），所以可以脱离界面用手动的时间测试。
+ * 动画要0.3秒，玩家可能在动画结束前又点了一次，所以已经提交的输入用编号区分（最多同时跟踪kMaxInFlight个），
+ * 动画开始、完成时按编号找到对应的输入；太旧的输入被新的覆盖，不再统计它的动画阶段。
+ *
+ * 使用示例：
+ * tracker.beginInput(InputLatencyTracker::now());            // 触摸
+ * tracker.markClick(now);                                      // 控制器收到点击
+ * int input = tracker.commit(LatencyAction::PLAYFIELD_MATCH, now);   // 模型修改完成
+ * tracker.markStage(input, LatencyStage::ANIMATION_START, now);
+ * tracker.markStage(input, LatencyStage::ANIMATION_END, now);
+ */
+class InputLatencyTracker {
+public:
+    static const int kMaxInFlight = 32;
+
+    InputLatencyTracker();
+
+    /**
+     * 当前时间（纳秒，单调递增）
+     */
+    static uint64_t now();
+
+    /**
+     * 开始一次输入（触摸到卡牌、点回退/重做按钮）
+     * 上一次输入还没有提交（比如点了一张不能操作的牌）时被这次替换
+     */
+    void beginInput(uint64_t timeNs);
+
+    /**
+     * 取走还没提交的输入（输入先排队、稍后执行时使用，执行前用beginInput放回）
+     * @param timeNs 输出：输入时间
+     * @return false=没有还没提交的输入
+     */
+    bool takeInput(uint64_t& timeNs);
+
+    /**
+     * 放弃还没提交的输入（比如回放时的触摸），之后的提交不会算到它头上
+     */
+    void cancelInput() { _hasInput = false; }
+
+    /**
+     * 控制器收到这次输入（CLICK阶段）
+     */
+    void markClick(uint64_t timeNs);
+
+    /**
+     * 模型修改完成（COMMIT阶段），这次输入开始等待动画
+     * @return 输入编号，给动画阶段使用；没有正在进行的输入时（比如回放）返回-1，不记录
+     */
+    int commit(LatencyAction action, uint64_t timeNs);
+
+    /**
+     * 已提交的输入到达一个阶段（ANIMATION_START、ANIMATION_END）
+     * 编号为-1或者已经被覆盖时忽略；ANIMATION_END之后这次输入结束
+     */
+    void markStage(int input, LatencyStage stage, uint64_t timeNs);
+
+    /**
+     * 某种操作某个阶段的延迟直方图（纳秒）
+     */
+    const LatencyHistogram& getHistogram(LatencyAction action, LatencyStage stage) const;
+
+    /**
+     * 清空所有统计
+     */
+    void reset();
+
+    /**
+     * 统计报告（CSV）：action,stage,count,p50_ms,p90_ms,p99_ms,max_ms,mean_ms
+     */
+    std::string formatReport() const;
+
+    static const char* getActionName(LatencyAction action);
+    static const char* getStageName(LatencyStage stage);
+
+private:
+    /**
+     * 已提交、还在等动画的输入
+     */
+    struct InFlight {
+        int id = -1;
+        LatencyAction action = LatencyAction::STACK_REPLACE;
+        uint64_t inputTime = 0;
+    };
+
+    LatencyHistogram _histograms[(int)LatencyAction::COUNT][(int)LatencyStage::COUNT];
+    InFlight _inFlight[kMaxInFlight];
+    int _nextId;
+    bool _hasInput;             // 是否有还没提交的输入
+    uint64_t _inputTime;
+    uint64_t _clickTime;        // 0表示还没有收到点击
+};
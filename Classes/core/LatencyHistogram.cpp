@@ -0,0 +1,79 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+const int LatencyHistogram::kSubBucketBits;
+const int LatencyHistogram::kMaxValueBits;
+
+static const int kSubBucketCount = 1 << LatencyHistogram::kSubBucketBits;
+static const int kBucketCount = (LatencyHistogram::kMaxValueBits - LatencyHistogram::kSubBucketBits + 1) * kSubBucketCount;
+static const uint64_t kMaxTrackable = (1ull << LatencyHistogram::kMaxValueBits) - 1;
+
+LatencyHistogram::LatencyHistogram() : _buckets(kBucketCount, 0), _count(0), _sum(0), _min(UINT64_MAX), _max(0) {
+}
+
+/**
+ * 最高位是第msb位（msb > kSubBucketBits）时，右移shift = msb - kSubBucketBits位，
+ * 剩下的值在[32, 64)之间，就是这个区间里的第几个桶
+ * 小于64的值shift为0，桶号就是值本身
+ */
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value > kMaxTrackable) value = kMaxTrackable;
+    int msb = 0;
+    while ((value >> msb) > 1) msb++;
+    int shift = msb > kSubBucketBits ? msb - kSubBucketBits : 0;
+    return shift * kSubBucketCount + (int)(value >> shift);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < 2 * kSubBucketCount) return (uint64_t)index;
+    int shift = index / kSubBucketCount - 1;
+    uint64_t lower = (uint64_t)(index % kSubBucketCount + kSubBucketCount) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    _buckets[bucketIndex(value)]++;
+    _count++;
+    _sum += value;
+    if (value < _min) _min = value;
+    if (value > _max) _max = value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _sum += other._sum;
+    if (other._count > 0 && other._min < _min) _min = other._min;
+    if (other._max > _max) _max = other._max;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _sum = 0;
+    _min = UINT64_MAX;
+    _max = 0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (_count == 0) return 0;
+    if (percentile < 0) percentile = 0;
+    if (percentile > 100) percentile = 100;
+    uint64_t rank = (uint64_t)std::ceil(percentile / 100.0 * _count);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = bucketUpperBound(i);
+            if (upper > _max) upper = _max;
+            if (upper < getMin()) upper = getMin();
+            return upper;
+        }
+    }
+    return _max;
+}
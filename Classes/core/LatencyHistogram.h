@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief LatencyHistogram - 对数分桶的延迟直方图（HDR风格）
+ *
+ * 记录纳秒级的延迟，查询任意百分位（p50、p99……）和最大值。
+ * 分桶：小于2^(kSubBucketBits+1)的值每个值一个桶（精确）；更大的值每个2的幂区间再等分成2^kSubBucketBits个桶，
+ * 所以每个桶的宽度不超过桶下界的1/32，百分位的相对误差在3%以内，和数值范围无关。
+ * 桶数固定（构造时一次分配），记录是常数时间，不分配内存。
+ *
+ * 使用示例：
+ * LatencyHistogram histogram;
+ * histogram.record(elapsedNs);
+ * uint64_t p99 = histogram.getPercentile(99.0);
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 5;        // 每个2的幂区间分成32个桶
+    static const int kMaxValueBits = 40;        // 能区分的最大值约2^40纳秒（18分钟），更大的值记在最后一个桶
+
+    LatencyHistogram();
+
+    /**
+     * 记录一个值（纳秒）
+     */
+    void record(uint64_t value);
+
+    /**
+     * 合并另一个直方图
+     */
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * 清空
+     */
+    void reset();
+
+    uint64_t getCount() const { return _count; }
+    uint64_t getMin() const { return _count > 0 ? _min : 0; }
+    uint64_t getMax() const { return _max; }
+    double getMean() const { return _count > 0 ? (double)_sum / _count : 0.0; }
+
+    /**
+     * 百分位：至少percentile%的记录不超过返回值
+     * 返回所在桶的上界（不超过最大值），没有记录时返回0
+     * @param percentile 0-100
+     */
+    uint64_t getPercentile(double percentile) const;
+
+private:
+    std::vector<uint32_t> _buckets;
+    uint64_t _count;
+    uint64_t _sum;
+    uint64_t _min;
+    uint64_t _max;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+};
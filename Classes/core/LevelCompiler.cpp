@@ -0,0 +1,374 @@
+#include "LevelCompiler.h"
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * 往牌局里添加一张牌，张数超出上限时返回false
+ */
+static bool addCard(Deal& deal, bool stack, double face, double suit, double x, double y) {
+    int& count = stack ? deal.stackCount : deal.playfieldCount;
+    if (count >= Deal::kMaxCards) return false;
+    DealCard& card = stack ? deal.stack[count] : deal.playfield[count];
+    // 超出int8范围的点数/花色记成0，由check()报告为不合法的牌
+    card.face = (face >= 0 && face <= 127) ? (int8_t)face : 0;
+    card.suit = (suit >= 0 && suit <= 127) ? (int8_t)suit : -1;
+    card.posX = (float)x;
+    card.posY = (float)y;
+    count++;
+    return true;
+}
+
+static std::string lineError(int line, const char* message) {
+    return "line " + std::to_string(line) + ": " + message;
+}
+
+bool LevelCompiler::parse(const std::string& text, bool json, Deal& deal, std::string& error) {
+    deal.seed = 0;
+    deal.playfieldCount = 0;
+    deal.stackCount = 0;
+    error.clear();
+
+    bool ok = json ? parseJson(text, deal, error) : parseCsv(text, deal, error);
+    if (ok && deal.stackCount == 0) {
+        error = "no stack cards";
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * CSV：每行 zone,face,suit,x,y
+ * zone可以写playfield/stack，也可以简写成p/s；空行和#开头的行跳过，表头（zone开头）跳过
+ */
+bool LevelCompiler::parseCsv(const std::string& text, Deal& deal, std::string& error) {
+    size_t start = 0;
+    int line = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string row = text.substr(start, end - start);
+        start = end + 1;
+        line++;
+
+        // 去掉行尾的\r和空白
+        while (!row.empty() && (row.back() == '\r' || row.back() == ' ' || row.back() == '\t')) row.pop_back();
+        size_t first = row.find_first_not_of(" \t");
+        if (first == std::string::npos || row[first] == '#') continue;
+        row = row.substr(first);
+        if (row.compare(0, 4, "zone") == 0) continue;
+
+        std::string fields[5];
+        int fieldCount = 0;
+        size_t fieldStart = 0;
+        while (fieldCount < 5) {
+            size_t comma = row.find(',', fieldStart);
+            fields[fieldCount++] = row.substr(fieldStart, comma == std::string::npos ? std::string::npos : comma - fieldStart);
+            if (comma == std::string::npos) break;
+            fieldStart = comma + 1;
+            if (fieldCount == 5) {
+                error = lineError(line, "too many fields");
+                return false;
+            }
+        }
+        if (fieldCount != 5) {
+            error = lineError(line, "expected zone,face,suit,x,y");
+            return false;
+        }
+
+        const std::string zone = fields[0].substr(0, fields[0].find_last_not_of(" \t") + 1);
+        bool stack;
+        if (zone == "playfield" || zone == "p") {
+            stack = false;
+        } else if (zone == "stack" || zone == "s") {
+            stack = true;
+        } else {
+            error = lineError(line, "zone must be playfield or stack");
+            return false;
+        }
+
+        double values[4];
+        for (int i = 0; i < 4; i++) {
+            const char* begin = fields[i + 1].c_str();
+            char* parsedEnd = nullptr;
+            values[i] = strtod(begin, &parsedEnd);
+            while (parsedEnd && (*parsedEnd == ' ' || *parsedEnd == '\t')) parsedEnd++;
+            if (parsedEnd == begin || !parsedEnd || *parsedEnd != '\0') {
+                error = lineError(line, "not a number");
+                return false;
+            }
+        }
+        if (!addCard(deal, stack, values[0], values[1], values[2], values[3])) {
+            error = lineError(line, "too many cards");
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * JsonCursor - 只支持关卡文件需要的JSON子集的解析器
+ * 对象、数组、数字、字符串（不处理\u转义）、true/false/null
+ */
+namespace {
+
+class JsonCursor {
+public:
+    explicit JsonCursor(const std::string& text) : _text(text), _pos(0) {}
+
+    int getLine() const {
+        int line = 1;
+        for (size_t i = 0; i < _pos && i < _text.size(); i++) {
+            if (_text[i] == '\n') line++;
+        }
+        return line;
+    }
+
+    void skipSpace() {
+        while (_pos < _text.size() && strchr(" \t\r\n", _text[_pos])) _pos++;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (_pos < _text.size() && _text[_pos] == c) {
+            _pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipSpace();
+        return _pos < _text.size() && _text[_pos] == c;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return _pos >= _text.size();
+    }
+
+    bool readString(std::string& value) {
+        if (!consume('"')) return false;
+        value.clear();
+        while (_pos < _text.size() && _text[_pos] != '"') {
+            if (_text[_pos] == '\\' && _pos + 1 < _text.size()) _pos++;
+            value += _text[_pos++];
+        }
+        return consume('"');
+    }
+
+    bool readNumber(double& value) {
+        skipSpace();
+        const char* begin = _text.c_str() + _pos;
+        char* end = nullptr;
+        value = strtod(begin, &end);
+        if (end == begin) return false;
+        _pos += end - begin;
+        return true;
+    }
+
+    /**
+     * 跳过一个任意的值（不认识的字段）
+     */
+    bool skipValue(int depth = 0) {
+        if (depth > 64) return false;
+        std::string text;
+        double number;
+        if (peek('"')) return readString(text);
+        if (consume('{')) {
+            if (consume('}')) return true;
+            do {
+                if (!readString(text) || !consume(':') || !skipValue(depth + 1)) return false;
+            } while (consume(','));
+            return consume('}');
+        }
+        if (consume('[')) {
+            if (consume(']')) return true;
+            do {
+                if (!skipValue(depth + 1)) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        static const char* kLiterals[] = { "true", "false", "null" };
+        for (const char* literal : kLiterals) {
+            size_t length = strlen(literal);
+            if (_text.compare(_pos, length, literal) == 0) {
+                _pos += length;
+                return true;
+            }
+        }
+        return readNumber(number);
+    }
+
+private:
+    const std::string& _text;
+    size_t _pos;
+};
+
+}  // namespace
+
+/**
+ * 解析一个卡牌数组：[ { "face": 1, "suit": 0, "x": 0, "y": 0 }, ... ]
+ */
+static bool parseJsonCards(JsonCursor& cursor, bool stack, Deal& deal, std::string& error) {
+    if (!cursor.consume('[')) {
+        error = lineError(cursor.getLine(), "expected card array");
+        return false;
+    }
+    if (cursor.consume(']')) return true;
+
+    do {
+        if (!cursor.consume('{')) {
+            error = lineError(cursor.getLine(), "expected card object");
+            return false;
+        }
+        double values[4] = { -1, -1, 0, 0 };
+        bool found[4] = { false, false, false, false };
+        static const char* kKeys[4] = { "face", "suit", "x", "y" };
+        if (!cursor.consume('}')) {
+            do {
+                std::string key;
+                if (!cursor.readString(key) || !cursor.consume(':')) {
+                    error = lineError(cursor.getLine(), "expected \"key\":");
+                    return false;
+                }
+                int field = -1;
+                for (int i = 0; i < 4; i++) {
+                    if (key == kKeys[i]) field = i;
+                }
+                bool ok = field >= 0 ? cursor.readNumber(values[field]) : cursor.skipValue();
+                if (!ok) {
+                    error = lineError(cursor.getLine(), "bad value");
+                    return false;
+                }
+                if (field >= 0) found[field] = true;
+            } while (cursor.consume(','));
+            if (!cursor.consume('}')) {
+                error = lineError(cursor.getLine(), "expected }");
+                return false;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            if (!found[i]) {
+                error = lineError(cursor.getLine(), (std::string("missing ") + kKeys[i]).c_str());
+                return false;
+            }
+        }
+        if (!addCard(deal, stack, values[0], values[1], values[2], values[3])) {
+            error = lineError(cursor.getLine(), "too many cards");
+            return false;
+        }
+    } while (cursor.consume(','));
+
+    if (!cursor.consume(']')) {
+        error = lineError(cursor.getLine(), "expected ]");
+        return false;
+    }
+    return true;
+}
+
+bool LevelCompiler::parseJson(const std::string& text, Deal& deal, std::string& error) {
+    JsonCursor cursor(text);
+    if (!cursor.consume('{')) {
+        error = lineError(cursor.getLine(), "expected {");
+        return false;
+    }
+    if (!cursor.consume('}')) {
+        do {
+            std::string key;
+            if (!cursor.readString(key) || !cursor.consume(':')) {
+                error = lineError(cursor.getLine(), "expected \"key\":");
+                return false;
+            }
+            bool ok;
+            if (key == "playfield" || key == "stack") {
+                if (!parseJsonCards(cursor, key == "stack", deal, error)) return false;
+                ok = true;
+            } else {
+                ok = cursor.skipValue();
+            }
+            if (!ok) {
+                error = lineError(cursor.getLine(), "bad value");
+                return false;
+            }
+        } while (cursor.consume(','));
+        if (!cursor.consume('}')) {
+            error = lineError(cursor.getLine(), "expected }");
+            return false;
+        }
+    }
+    if (!cursor.atEnd()) {
+        error = lineError(cursor.getLine(), "unexpected data after level");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 检查牌局
+ * 1. 点数1-13、花色0-3
+ * 2. 重复的牌：一副牌里每张牌只有一张
+ * 3. 永远消不掉的牌：整局里（主牌区+底牌堆）没有点数相邻的牌
+ * 4. 主牌区卡牌两两之间的重叠（中心点距离小于卡牌宽高），以及超出主牌区范围
+ * 5. 用求解器检查能否获胜（有节点数上限，超过上限没有结论）
+ */
+void LevelCompiler::check(const Deal& deal, const LevelCheckOptions& options, LevelCheck& check) {
+    check = LevelCheck();
+    check.cards = deal.playfieldCount + deal.stackCount;
+
+    bool seen[14][4] = {};
+    int faceCount[15] = {};
+    const DealCard* all[Deal::kMaxCards * 2];
+    int allCount = 0;
+    for (int i = 0; i < deal.playfieldCount; i++) all[allCount++] = &deal.playfield[i];
+    for (int i = 0; i < deal.stackCount; i++) all[allCount++] = &deal.stack[i];
+
+    for (int i = 0; i < allCount; i++) {
+        const DealCard& card = *all[i];
+        if (card.face < 1 || card.face > 13 || card.suit < 0 || card.suit > 3) {
+            check.invalidCards++;
+            continue;
+        }
+        if (seen[card.face][card.suit]) {
+            check.duplicates++;
+        }
+        seen[card.face][card.suit] = true;
+        faceCount[card.face]++;
+    }
+
+    for (int i = 0; i < deal.playfieldCount; i++) {
+        int face = deal.playfield[i].face;
+        if (face < 1 || face > 13) continue;
+        if (faceCount[face - 1] == 0 && faceCount[face + 1] == 0) {
+            check.unreachable++;
+        }
+    }
+
+    float halfWidth = options.cardWidth * 0.5f;
+    float halfHeight = options.cardHeight * 0.5f;
+    for (int i = 0; i < deal.playfieldCount; i++) {
+        const DealCard& a = deal.playfield[i];
+        if (a.posX - halfWidth < 0 || a.posX + halfWidth > options.playfieldWidth ||
+            a.posY - halfHeight < 0 || a.posY + halfHeight > options.playfieldHeight) {
+            check.outOfBounds++;
+        }
+        for (int j = i + 1; j < deal.playfieldCount; j++) {
+            const DealCard& b = deal.playfield[j];
+            float dx = a.posX > b.posX ? a.posX - b.posX : b.posX - a.posX;
+            float dy = a.posY > b.posY ? a.posY - b.posY : b.posY - a.posY;
+            if (dx < options.cardWidth && dy < options.cardHeight) {
+                check.overlaps++;
+            }
+        }
+    }
+
+    if (options.solverMaxNodes > 0 && !check.hasErrors()) {
+        GameModel model;
+        deal.applyTo(model);
+        SolverOptions solverOptions;
+        solverOptions.maxNodes = options.solverMaxNodes;
+        GameSolver solver(solverOptions);
+        SolverResult result = solver.solve(model);
+        check.solve = result.status;
+        check.solverNodes = result.nodes;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "DealGenerator.h"
+#include "GameSolver.h"
+#include <string>
+
+/**
+ * LevelCheckOptions - 关卡检查参数
+ */
+struct LevelCheckOptions {
+    float cardWidth = 120.0f;           // 卡牌大小（和StackView::layoutCards使用的一致）
+    float cardHeight = 170.0f;
+    float playfieldWidth = 1080.0f;     // 主牌区大小（主牌区坐标）
+    float playfieldHeight = 1500.0f;
+    uint64_t solverMaxNodes = 200000;   // 检查能否获胜时最多展开的节点数，0表示不检查
+};
+
+/**
+ * LevelCheck - 一关的检查结果
+ *
+ * 错误：关卡不能用，不会写入关卡包
+ * 警告：关卡可以用，但可能是编辑失误（严格模式下也当作错误）
+ */
+struct LevelCheck {
+    int cards = 0;                  // 总张数
+    int invalidCards = 0;           // 错误：点数/花色超出范围
+    int duplicates = 0;             // 错误：同一张牌（点数+花色相同）出现了不止一次
+    int unreachable = 0;            // 错误：主牌区的牌在整局里找不到点数相邻的牌，永远消不掉
+    int overlaps = 0;               // 警告：主牌区互相重叠的卡牌对数
+    int outOfBounds = 0;            // 警告：主牌区超出显示范围的卡牌数
+    SolveStatus solve = SolveStatus::INVALID;   // 能否获胜（没有检查时为INVALID）
+    uint64_t solverNodes = 0;       // 求解器展开的节点数
+
+    bool hasErrors() const { return invalidCards > 0 || duplicates > 0 || unreachable > 0; }
+
+    /**
+     * 重叠、超出范围、证明赢不了都算警告
+     */
+    bool hasWarnings() const { return overlaps > 0 || outOfBounds > 0 || solve == SolveStatus::UNSOLVABLE; }
+};
+
+/**
+ * @brief LevelCompiler - 关卡文本的解析和检查（关卡编译工具使用）
+ *
+ * 关卡文件是人工编辑的文本，字段和GameController::createCard一样（点数、花色、x、y）：
+ *
+ * CSV（每行一张牌，#开头是注释，第一行可以是表头）：
+ *   zone,face,suit,x,y
+ *   playfield,12,0,250,1000
+ *   stack,4,0,800,290
+ *
+ * JSON：
+ *   { "playfield": [ { "face": 12, "suit": 0, "x": 250, "y": 1000 } ],
+ *     "stack":     [ { "face": 4, "suit": 0, "x": 800, "y": 290 } ] }
+ *
+ * 底牌堆按文件里的顺序添加，最后一张是顶部牌。
+ */
+class LevelCompiler {
+public:
+    /**
+     * 解析关卡文本
+     * @param text 文件内容
+     * @param json true=JSON，false=CSV
+     * @param deal 输出：牌局
+     * @param error 输出：失败的原因（带行号）
+     * @return false=格式错误或者张数超出范围
+     */
+    static bool parse(const std::string& text, bool json, Deal& deal, std::string& error);
+
+    /**
+     * 检查牌局
+     * @param deal 解析出来的牌局
+     * @param options 检查参数
+     * @param check 输出：检查结果
+     */
+    static void check(const Deal& deal, const LevelCheckOptions& options, LevelCheck& check);
+
+private:
+    static bool parseCsv(const std::string& text, Deal& deal, std::string& error);
+    static bool parseJson(const std::string& text, Deal& deal, std::string& error);
+};
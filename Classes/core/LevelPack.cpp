@@ -0,0 +1,254 @@
+#include "LevelPack.h"
+#include <cmath>
+#include <cstring>
+
+static const uint8_t kMagic[4] = { 'C', 'G', 'L', 'P' };
+
+const uint32_t LevelPackFormat::kVersion;
+const size_t LevelPackFormat::kHeaderSize;
+const size_t LevelPackFormat::kIndexEntrySize;
+const size_t LevelPackFormat::kCardRecordSize;
+
+// 小端读写，和平台的字节序无关
+static uint16_t readU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t readU64(const uint8_t* p) {
+    return (uint64_t)readU32(p) | (uint64_t)readU32(p + 4) << 32;
+}
+
+static void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void writeU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(value >> (i * 8));
+}
+
+static void writeU64(uint8_t* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(value >> (i * 8));
+}
+
+static int16_t toCoordinate(float value) {
+    long rounded = std::lround(value);
+    if (rounded < INT16_MIN) rounded = INT16_MIN;
+    if (rounded > INT16_MAX) rounded = INT16_MAX;
+    return (int16_t)rounded;
+}
+
+static void readCard(const uint8_t* p, DealCard& card) {
+    card.posX = (float)(int16_t)readU16(p);
+    card.posY = (float)(int16_t)readU16(p + 2);
+    card.face = (int8_t)p[4];
+    card.suit = (int8_t)p[5];
+}
+
+static void writeCard(uint8_t* p, const DealCard& card) {
+    writeU16(p, (uint16_t)toCoordinate(card.posX));
+    writeU16(p + 2, (uint16_t)toCoordinate(card.posY));
+    p[4] = (uint8_t)card.face;
+    p[5] = (uint8_t)card.suit;
+    p[6] = 0;
+    p[7] = 0;
+}
+
+uint32_t LevelPackFormat::checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+LevelPack::LevelPack() : _data(nullptr), _size(0), _levelCount(0), _indexOffset(0) {
+}
+
+bool LevelPack::open(const std::string& path) {
+    close();
+    if (!_file.open(path)) return false;
+    if (!openMemory(_file.getData(), _file.getSize())) {
+        _file.close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 打开关卡包：只检查文件头，不读索引和记录（常数时间）
+ * 1. 格式标识、版本、卡牌记录大小
+ * 2. 文件头校验（文件头前12字节和后16字节）
+ * 3. 记录的文件大小和实际大小一致（文件被截断时直接拒绝）
+ * 4. 索引整个落在文件范围内
+ */
+bool LevelPack::openMemory(const uint8_t* data, size_t size) {
+    if (data != _file.getData()) {
+        _file.close();
+    }
+    _data = nullptr;
+    _size = 0;
+    _levelCount = 0;
+    _indexOffset = 0;
+
+    if (!data || size < LevelPackFormat::kHeaderSize || memcmp(data, kMagic, 4) != 0) return false;
+    if (readU16(data + 4) != LevelPackFormat::kVersion) return false;
+    if (readU16(data + 6) != LevelPackFormat::kCardRecordSize) return false;
+
+    uint8_t checked[28];
+    memcpy(checked, data, 12);
+    memcpy(checked + 12, data + 16, 16);
+    if (LevelPackFormat::checksum(checked, sizeof(checked)) != readU32(data + 12)) return false;
+
+    uint32_t levelCount = readU32(data + 8);
+    uint64_t indexOffset = readU64(data + 16);
+    uint64_t fileSize = readU64(data + 24);
+    if (fileSize != size) return false;
+    if (indexOffset < LevelPackFormat::kHeaderSize || indexOffset > size) return false;
+    if ((size - indexOffset) / LevelPackFormat::kIndexEntrySize < levelCount) return false;
+
+    _data = data;
+    _size = size;
+    _levelCount = levelCount;
+    _indexOffset = indexOffset;
+    return true;
+}
+
+void LevelPack::close() {
+    _file.close();
+    _data = nullptr;
+    _size = 0;
+    _levelCount = 0;
+    _indexOffset = 0;
+}
+
+const uint8_t* LevelPack::locateLevel(int index, int& playfieldCount, int& stackCount) const {
+    if (!_data || index < 0 || (uint32_t)index >= _levelCount) return nullptr;
+
+    const uint8_t* entry = _data + _indexOffset + (size_t)index * LevelPackFormat::kIndexEntrySize;
+    uint64_t offset = readU64(entry);
+    playfieldCount = entry[8];
+    stackCount = entry[9];
+    if (playfieldCount > Deal::kMaxCards || stackCount < 1 || stackCount > Deal::kMaxCards) return nullptr;
+
+    size_t bytes = (size_t)(playfieldCount + stackCount) * LevelPackFormat::kCardRecordSize;
+    if (offset < LevelPackFormat::kHeaderSize || offset > _indexOffset || _indexOffset - offset < bytes) return nullptr;
+
+    const uint8_t* records = _data + offset;
+    if (LevelPackFormat::checksum(records, bytes) != readU32(entry + 12)) return nullptr;
+    return records;
+}
+
+bool LevelPack::getLevel(int index, Deal& deal) const {
+    int playfieldCount, stackCount;
+    const uint8_t* records = locateLevel(index, playfieldCount, stackCount);
+    if (!records) return false;
+
+    deal.seed = 0;
+    deal.playfieldCount = playfieldCount;
+    deal.stackCount = stackCount;
+    for (int i = 0; i < playfieldCount; i++) {
+        readCard(records, deal.playfield[i]);
+        records += LevelPackFormat::kCardRecordSize;
+    }
+    for (int i = 0; i < stackCount; i++) {
+        readCard(records, deal.stack[i]);
+        records += LevelPackFormat::kCardRecordSize;
+    }
+    return true;
+}
+
+bool LevelPack::isLevelValid(int index) const {
+    int playfieldCount, stackCount;
+    return locateLevel(index, playfieldCount, stackCount) != nullptr;
+}
+
+LevelPackWriter::LevelPackWriter() : _file(nullptr), _offset(0), _failed(false) {
+}
+
+LevelPackWriter::~LevelPackWriter() {
+    if (_file) close();
+}
+
+/**
+ * 先写一个空的文件头占位，close()时再回来补上
+ */
+bool LevelPackWriter::open(const std::string& path) {
+    if (_file) close();
+    _index.clear();
+    _failed = false;
+    _file = fopen(path.c_str(), "wb");
+    if (!_file) return false;
+
+    uint8_t header[LevelPackFormat::kHeaderSize] = {};
+    _failed = fwrite(header, 1, sizeof(header), _file) != sizeof(header);
+    _offset = LevelPackFormat::kHeaderSize;
+    return !_failed;
+}
+
+bool LevelPackWriter::addLevel(const Deal& deal) {
+    if (!_file || _failed) return false;
+    if (deal.playfieldCount < 0 || deal.playfieldCount > Deal::kMaxCards) return false;
+    if (deal.stackCount < 1 || deal.stackCount > Deal::kMaxCards) return false;
+    if (getLevelCount() == INT32_MAX) return false;
+
+    uint8_t records[Deal::kMaxCards * 2 * LevelPackFormat::kCardRecordSize];
+    uint8_t* p = records;
+    for (int i = 0; i < deal.playfieldCount; i++) {
+        writeCard(p, deal.playfield[i]);
+        p += LevelPackFormat::kCardRecordSize;
+    }
+    for (int i = 0; i < deal.stackCount; i++) {
+        writeCard(p, deal.stack[i]);
+        p += LevelPackFormat::kCardRecordSize;
+    }
+    size_t bytes = (size_t)(p - records);
+    if (fwrite(records, 1, bytes, _file) != bytes) {
+        _failed = true;
+        return false;
+    }
+
+    uint8_t entry[LevelPackFormat::kIndexEntrySize] = {};
+    writeU64(entry, _offset);
+    entry[8] = (uint8_t)deal.playfieldCount;
+    entry[9] = (uint8_t)deal.stackCount;
+    writeU32(entry + 12, LevelPackFormat::checksum(records, bytes));
+    _index.insert(_index.end(), entry, entry + sizeof(entry));
+    _offset += bytes;
+    return true;
+}
+
+bool LevelPackWriter::close() {
+    if (!_file) return false;
+
+    uint64_t indexOffset = _offset;
+    if (!_failed && !_index.empty()) {
+        _failed = fwrite(_index.data(), 1, _index.size(), _file) != _index.size();
+    }
+
+    uint8_t header[LevelPackFormat::kHeaderSize];
+    memcpy(header, kMagic, 4);
+    writeU16(header + 4, (uint16_t)LevelPackFormat::kVersion);
+    writeU16(header + 6, (uint16_t)LevelPackFormat::kCardRecordSize);
+    writeU32(header + 8, (uint32_t)getLevelCount());
+    writeU64(header + 16, indexOffset);
+    writeU64(header + 24, indexOffset + _index.size());
+
+    uint8_t checked[28];
+    memcpy(checked, header, 12);
+    memcpy(checked + 12, header + 16, 16);
+    writeU32(header + 12, LevelPackFormat::checksum(checked, sizeof(checked)));
+
+    if (!_failed) {
+        _failed = fseek(_file, 0, SEEK_SET) != 0 || fwrite(header, 1, sizeof(header), _file) != sizeof(header);
+    }
+    if (fclose(_file) != 0) _failed = true;
+    _file = nullptr;
+    _index.clear();
+    return !_failed;
+}
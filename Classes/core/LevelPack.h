@@ -0,0 +1,149 @@
+#pragma once
+#include "DealGenerator.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * 关卡包的二进制格式（小端，版本1）
+ *
+ * 文件头（32字节）：
+ *   "CGLP" 版本(u16) 卡牌记录大小(u16) 关卡数(u32) 文件头校验(u32) 索引偏移(u64) 文件大小(u64)
+ * 卡牌记录（紧跟在文件头后面，每关的记录连续存放）：
+ *   每张牌8字节：posX(i16) posY(i16) 点数(u8) 花色(u8) 保留(2字节)
+ *   一关的记录先是主牌区的牌，再是底牌堆的牌（最后一张是顶部牌）
+ * 索引（文件末尾，每关16字节）：
+ *   记录偏移(u64) 主牌区张数(u8) 底牌堆张数(u8) 保留(u16) 这一关记录的校验和(u32)
+ *
+ * 打开时只检查文件头（常数时间，和关卡数无关）；
+ * 每一关的校验和在读取这一关时才检查，一关只有一两百字节，校验的代价可以忽略。
+ */
+struct LevelPackFormat {
+    static const uint32_t kVersion = 1;
+    static const size_t kHeaderSize = 32;
+    static const size_t kIndexEntrySize = 16;
+    static const size_t kCardRecordSize = 8;
+
+    /**
+     * 校验和（FNV-1a 32位）
+     */
+    static uint32_t checksum(const uint8_t* data, size_t size);
+};
+
+/**
+ * @brief LevelPack - 内存映射的关卡包（只读，随机访问）
+ *
+ * 打开时把整个文件映射到内存，不解析、不分配内存；
+ * 读取第i关时查索引直接定位到这一关的卡牌记录，拷贝到Deal里（Deal是定长数组，也不分配内存）。
+ * 几百万关的关卡包，打开和读取任意一关都在微秒级。
+ *
+ * 使用示例：
+ * LevelPack pack;
+ * Deal deal;
+ * if (pack.open(path) && pack.getLevel(index, deal)) {
+ *     deal.applyTo(gameLogic.getModel());
+ * }
+ */
+class LevelPack {
+public:
+    LevelPack();
+
+    /**
+     * 映射并打开关卡包文件
+     * @return false=文件打不开，或者文件头不对（格式、版本、大小不符）
+     */
+    bool open(const std::string& path);
+
+    /**
+     * 打开内存中的关卡包（数据由调用者持有，使用期间不能释放）
+     * 用于无法映射文件的平台（比如直接读出了APK中的资源）
+     */
+    bool openMemory(const uint8_t* data, size_t size);
+
+    /**
+     * 关闭关卡包
+     */
+    void close();
+
+    bool isOpen() const { return _data != nullptr; }
+
+    /**
+     * 关卡数量（没有打开时为0）
+     */
+    int getLevelCount() const { return (int)_levelCount; }
+
+    /**
+     * 读取一关
+     * 会检查这一关的记录是否在文件范围内、张数是否合法、校验和是否一致
+     * @param index 关卡下标，从0开始
+     * @param deal 输出：这一关的牌局（deal.seed为0）
+     * @return false=下标超出范围或者这一关的数据损坏
+     */
+    bool getLevel(int index, Deal& deal) const;
+
+    /**
+     * 只检查一关的数据是否完好（不读取）
+     */
+    bool isLevelValid(int index) const;
+
+private:
+    MappedFile _file;
+    const uint8_t* _data;
+    size_t _size;
+    uint32_t _levelCount;
+    uint64_t _indexOffset;
+
+    /**
+     * 找到一关的记录并检查，成功时返回记录的起始地址和张数
+     */
+    const uint8_t* locateLevel(int index, int& playfieldCount, int& stackCount) const;
+};
+
+/**
+ * @brief LevelPackWriter - 写关卡包
+ *
+ * 卡牌记录边添加边写入文件，内存里只保留索引（每关16字节），
+ * 所以可以生成几百万关的关卡包；close()时在文件末尾写索引，再回头补上文件头。
+ *
+ * 使用示例：
+ * LevelPackWriter writer;
+ * writer.open(path);
+ * writer.addLevel(deal);
+ * writer.close();
+ */
+class LevelPackWriter {
+public:
+    LevelPackWriter();
+    ~LevelPackWriter();
+
+    /**
+     * 创建关卡包文件
+     * @return false=文件无法创建
+     */
+    bool open(const std::string& path);
+
+    /**
+     * 添加一关
+     * 坐标保存成16位整数（四舍五入）
+     * @return false=文件没有打开、张数超出范围或者写文件失败
+     */
+    bool addLevel(const Deal& deal);
+
+    /**
+     * 已经添加的关卡数
+     */
+    int getLevelCount() const { return (int)(_index.size() / LevelPackFormat::kIndexEntrySize); }
+
+    /**
+     * 写入索引和文件头并关闭文件
+     * @return false=写文件失败（这时文件是不完整的，打开会失败）
+     */
+    bool close();
+
+private:
+    FILE* _file;
+    uint64_t _offset;               // 下一条卡牌记录的偏移
+    std::vector<uint8_t> _index;    // 已经编码好的索引
+    bool _failed;                   // 写文件是否失败过
+};
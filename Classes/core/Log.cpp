@@ -0,0 +1,318 @@
+#include "Log.h"
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+const int Log::kMaxArgs;
+const int Log::kTextBytes;
+const int Log::kQueueRecords;
+const int LogRecord::kMaxArgs;
+const int LogRecord::kTextBytes;
+
+namespace {
+
+const uint64_t kQueueMask = Log::kQueueRecords - 1;
+
+/**
+ * 队列的一个槽位
+ * sequence等于写位置时可以写，等于写位置+1时写完了可以读，读完后加上队列容量留给下一圈的写者
+ */
+struct LogSlot {
+    std::atomic<uint64_t> sequence{ 0 };
+    LogRecord record;
+};
+
+/**
+ * 日志队列和输出线程（第一次使用时创建，程序退出时析构，析构前会停止输出线程）
+ */
+struct LogState {
+    std::unique_ptr<LogSlot[]> slots{ new LogSlot[Log::kQueueRecords] };
+    alignas(64) std::atomic<uint64_t> enqueuePos{ 0 };  // 写者：下一个要抢的位置
+    alignas(64) std::atomic<uint64_t> dequeuePos{ 0 };  // 输出线程：下一个要读的位置
+    std::atomic<uint64_t> dropped{ 0 };
+
+    std::mutex threadMutex;         // 保护start/stop
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    Log::Sink sink;
+
+    LogState() {
+        for (int i = 0; i < Log::kQueueRecords; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LogState() { stopThread(); }
+
+    void stopThread() {
+        std::lock_guard<std::mutex> lock(threadMutex);
+        if (!running.load(std::memory_order_relaxed)) return;
+        running.store(false, std::memory_order_release);
+        thread.join();
+    }
+};
+
+LogState& getState() {
+    static LogState state;
+    return state;
+}
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+void defaultSink(int level, const char* line) {
+#ifdef __ANDROID__
+    static const int kPriorities[] = { ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR };
+    __android_log_write(kPriorities[level], "cardgame", line);
+#else
+    (void)level;
+    fprintf(stderr, "%s\n", line);
+#endif
+}
+
+/**
+ * 追加printf格式化的文本（结果可以超过栈上缓冲区的大小）
+ */
+void appendFormat(std::string& out, const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return;
+    if (length < (int)sizeof(buffer)) {
+        out.append(buffer, length);
+        return;
+    }
+    std::string large(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+    out.append(large.data(), length);
+}
+
+/**
+ * 按一个转换说明（不带长度修饰符，比如"%-5"加上conversion）格式化一个参数
+ * 参数的类型和转换说明不一致时先转换成转换说明要的类型，不会按错误的类型读参数
+ */
+void appendArg(std::string& out, std::string spec, char conversion, const LogRecord& record, int index) {
+    const LogRecord::Value& value = record.values[index];
+    LogArgType type = record.types[index];
+
+    if (conversion == 's' && type == LogArgType::STRING) {
+        spec += 's';
+        appendFormat(out, spec.c_str(), record.text + value.u);
+        return;
+    }
+    if (conversion == 'p' || type == LogArgType::POINTER) {
+        spec += 'p';
+        appendFormat(out, spec.c_str(), type == LogArgType::POINTER ? value.p : nullptr);
+        return;
+    }
+    if (type == LogArgType::STRING) {
+        // 数值的转换说明对应了字符串参数：原样输出字符串
+        out += record.text + value.u;
+        return;
+    }
+
+    bool isFloat = strchr("fFeEgGaA", conversion) != nullptr;
+    if (conversion == 's') {
+        // 字符串的转换说明对应了数值参数：按参数本身的类型输出
+        isFloat = type == LogArgType::DOUBLE;
+        conversion = isFloat ? 'g' : (type == LogArgType::UINT ? 'u' : 'd');
+    }
+    if (isFloat) {
+        double d = type == LogArgType::DOUBLE ? value.d
+            : (type == LogArgType::UINT ? (double)value.u : (double)value.i);
+        spec += conversion;
+        appendFormat(out, spec.c_str(), d);
+        return;
+    }
+
+    long long i = type == LogArgType::DOUBLE ? (long long)value.d : (long long)value.i;
+    if (conversion == 'c') {
+        spec += 'c';
+        appendFormat(out, spec.c_str(), (int)i);
+    } else if (conversion == 'd' || conversion == 'i') {
+        spec += "lld";
+        appendFormat(out, spec.c_str(), i);
+    } else if (strchr("ouxX", conversion)) {
+        spec += "ll";
+        spec += conversion;
+        appendFormat(out, spec.c_str(), (unsigned long long)i);
+    } else {
+        // 不认识的转换说明：原样输出
+        out += spec;
+        out += conversion;
+    }
+}
+
+/**
+ * 输出线程：读队列、格式化、输出；队列空时休眠一会儿
+ * 停止时先把队列读空再退出
+ */
+void runSink() {
+    LogState& state = getState();
+    uint64_t reportedDropped = 0;
+    while (true) {
+        bool stopping = !state.running.load(std::memory_order_acquire);
+        int count = 0;
+        while (true) {
+            uint64_t pos = state.dequeuePos.load(std::memory_order_relaxed);
+            LogSlot& slot = state.slots[pos & kQueueMask];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) break;
+            LogRecord record = slot.record;
+            slot.sequence.store(pos + Log::kQueueRecords, std::memory_order_release);
+            state.dequeuePos.store(pos + 1, std::memory_order_release);
+
+            std::string line = Log::format(record);
+            state.sink(record.site->level, line.c_str());
+            ++count;
+        }
+
+        uint64_t dropped = state.dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            std::string line;
+            appendFormat(line, "log: %llu messages dropped (queue full)", (unsigned long long)(dropped - reportedDropped));
+            state.sink(GAME_LOG_LEVEL_WARN, line.c_str());
+            reportedDropped = dropped;
+        }
+
+        if (count == 0) {
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+}
+
+} // namespace
+
+void Log::start(const Sink& sink) {
+    LogState& state = getState();
+    std::lock_guard<std::mutex> lock(state.threadMutex);
+    if (state.running.load(std::memory_order_relaxed)) return;
+    state.sink = sink ? sink : Sink(defaultSink);
+    state.running.store(true, std::memory_order_release);
+    state.thread = std::thread(runSink);
+}
+
+void Log::stop() {
+    getState().stopThread();
+}
+
+void Log::flush() {
+    LogState& state = getState();
+    uint64_t target = state.enqueuePos.load(std::memory_order_acquire);
+    while (state.running.load(std::memory_order_acquire) &&
+           state.dequeuePos.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+uint64_t Log::getDroppedCount() {
+    return getState().dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t Log::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+void Log::push(const LogRecord& record) {
+    LogState& state = getState();
+    uint64_t pos = state.enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        LogSlot& slot = state.slots[pos & kQueueMask];
+        int64_t diff = (int64_t)(slot.sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (state.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (diff < 0) {
+            // 这个槽位上一圈的日志还没输出：队列满了
+            state.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = state.enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Log::packString(LogRecord& record, const char* text, size_t length) {
+    int index = record.argCount++;
+    // 放不下时截断（不截在UTF-8字符中间）；已经写满时指向最后一个字节的'\0'
+    size_t offset = record.textUsed < kTextBytes - 1 ? record.textUsed : kTextBytes - 1;
+    size_t count = length;
+    if (count > kTextBytes - 1 - offset) {
+        count = kTextBytes - 1 - offset;
+        while (count > 0 && ((unsigned char)text[count] & 0xC0) == 0x80) --count;
+    }
+    memcpy(record.text + offset, text, count);
+    record.text[offset + count] = '\0';
+    record.textUsed = (uint8_t)(offset + count + 1);
+    record.types[index] = LogArgType::STRING;
+    record.values[index].u = offset;
+}
+
+std::string Log::format(const LogRecord& record) {
+    static const char kLevelNames[] = { 'D', 'I', 'W', 'E' };
+    const LogSite& site = *record.site;
+
+    const char* file = site.file;
+    for (const char* p = site.file; *p; ++p) {
+        if (*p == '/' || *p == '\\') file = p + 1;
+    }
+
+    std::string out;
+    appendFormat(out, "[%10.3f] %c %s:%d ", record.time / 1e9, kLevelNames[site.level], file, site.line);
+
+    int argIndex = 0;
+    const char* p = site.format;
+    while (*p) {
+        if (*p != '%') {
+            const char* next = strchr(p, '%');
+            if (!next) next = p + strlen(p);
+            out.append(p, next - p);
+            p = next;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            p += 2;
+            continue;
+        }
+
+        // %[标志][宽度][.精度][长度]转换：长度修饰符去掉，由参数的类型决定
+        const char* start = p++;
+        std::string spec = "%";
+        while (*p && strchr("-+ #0", *p)) spec += *p++;
+        while (isdigit((unsigned char)*p)) spec += *p++;
+        if (*p == '.') {
+            spec += *p++;
+            while (isdigit((unsigned char)*p)) spec += *p++;
+        }
+        while (*p && strchr("hlLqjzt", *p)) ++p;
+        if (!*p) {
+            out += start;
+            break;
+        }
+        char conversion = *p++;
+        if (argIndex >= record.argCount) {
+            // 参数不够：原样输出转换说明
+            out.append(start, p - start);
+            continue;
+        }
+        appendArg(out, spec, conversion, record, argIndex++);
+    }
+    return out;
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+/**
+ * 异步分级日志（不依赖cocos2d）
+ *
+ * 代替热点路径上的CCLOG：调用处不格式化字符串、不做控制台I/O，
+ * 只把日志点（格式字符串、级别、文件、行号，编译期确定的静态常量）的地址和原始参数写进无锁队列，
+ * 由后台输出线程格式化并输出，一次调用几十纳秒，不会因为控制台输出慢而卡住一帧。
+ *
+ * 编译期级别CARDGAME_LOG_LEVEL：低于这个级别的GAME_LOG_xxx展开成空语句，不产生代码、不计算参数。
+ * 默认调试版（COCOS2D_DEBUG>0）是DEBUG，发布版是WARN。
+ *
+ * 使用示例：
+ * GAME_LOG_DEBUG("卡牌点击: cardId=%d", cardId);
+ * GAME_LOG_WARN("关卡读取失败: %s", path.c_str());
+ *
+ * 参数限制：
+ * - 最多kMaxArgs个参数，只支持整数、枚举、浮点数、指针和字符串（const char*、std::string）
+ * - 字符串参数在调用时拷贝（每条日志的字符串一共最多kTextBytes-1字节，超出的截断），调用后可以释放
+ * - 格式字符串只保存指针，必须是字符串常量
+ *
+ * 队列满时（输出线程跟不上）新的日志丢掉并计数，不阻塞调用的线程；输出线程会补一条丢了多少条的提示。
+ * 没有调用Log::start()时日志先留在队列里，start()之后输出。
+ */
+// 日志级别（不用枚举：Windows头文件把ERROR定义成宏，有的工程定义了DEBUG宏）
+#define GAME_LOG_LEVEL_DEBUG 0
+#define GAME_LOG_LEVEL_INFO 1
+#define GAME_LOG_LEVEL_WARN 2
+#define GAME_LOG_LEVEL_ERROR 3
+#define GAME_LOG_LEVEL_NONE 4
+
+#ifndef CARDGAME_LOG_LEVEL
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define CARDGAME_LOG_LEVEL GAME_LOG_LEVEL_DEBUG
+#else
+#define CARDGAME_LOG_LEVEL GAME_LOG_LEVEL_WARN
+#endif
+#endif
+
+#define GAME_LOG_AT(level, format, ...) \
+    do { \
+        static const LogSite gameLogSite = { level, __FILE__, __LINE__, format }; \
+        Log::write(gameLogSite, ##__VA_ARGS__); \
+    } while (0)
+
+#if CARDGAME_LOG_LEVEL <= GAME_LOG_LEVEL_DEBUG
+#define GAME_LOG_DEBUG(format, ...) GAME_LOG_AT(GAME_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define GAME_LOG_DEBUG(format, ...) ((void)0)
+#endif
+
+#if CARDGAME_LOG_LEVEL <= GAME_LOG_LEVEL_INFO
+#define GAME_LOG_INFO(format, ...) GAME_LOG_AT(GAME_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define GAME_LOG_INFO(format, ...) ((void)0)
+#endif
+
+#if CARDGAME_LOG_LEVEL <= GAME_LOG_LEVEL_WARN
+#define GAME_LOG_WARN(format, ...) GAME_LOG_AT(GAME_LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#else
+#define GAME_LOG_WARN(format, ...) ((void)0)
+#endif
+
+#if CARDGAME_LOG_LEVEL <= GAME_LOG_LEVEL_ERROR
+#define GAME_LOG_ERROR(format, ...) GAME_LOG_AT(GAME_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define GAME_LOG_ERROR(format, ...) ((void)0)
+#endif
+
+/**
+ * 日志点：每个GAME_LOG_xxx调用处一个静态常量，它的地址就是格式的编号
+ */
+struct LogSite {
+    int level;          // GAME_LOG_LEVEL_xxx
+    const char* file;
+    int line;
+    const char* format;
+};
+
+/**
+ * 一个参数的类型
+ */
+enum class LogArgType : uint8_t {
+    INT = 0,        // 有符号整数、枚举、bool、char
+    UINT = 1,       // 无符号整数
+    DOUBLE = 2,     // 浮点数
+    STRING = 3,     // 字符串（拷贝在LogRecord::text里，值是偏移）
+    POINTER = 4,    // 指针（%p）
+};
+
+/**
+ * 一条日志：日志点 + 原始参数，由输出线程格式化
+ */
+struct LogRecord {
+    static const int kMaxArgs = 8;
+    static const int kTextBytes = 64;
+
+    union Value {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const void* p;
+    };
+
+    const LogSite* site;
+    uint64_t time;                  // 纳秒，Log::now()
+    uint8_t argCount;
+    uint8_t textUsed;               // text里已经用掉的字节
+    LogArgType types[kMaxArgs];
+    Value values[kMaxArgs];
+    char text[kTextBytes];          // 字符串参数（各自以'\0'结尾）
+};
+
+/**
+ * @brief Log - 日志队列和后台输出线程
+ *
+ * 队列是固定容量的多写者无锁队列（每个槽位一个序号：写者用CAS抢位置，写完后发布序号），
+ * 任意线程都可以写日志；只有输出线程读。
+ */
+class Log {
+public:
+    static const int kMaxArgs = LogRecord::kMaxArgs;
+    static const int kTextBytes = LogRecord::kTextBytes;
+    static const int kQueueRecords = 1 << 12;   // 队列能放的日志条数（2的幂）
+
+    /**
+     * 输出一行日志（不带换行），在输出线程调用；level是GAME_LOG_LEVEL_xxx
+     */
+    typedef std::function<void(int level, const char* line)> Sink;
+
+    /**
+     * 启动后台输出线程（已经启动时什么也不做）
+     * @param sink 输出函数，nullptr表示默认输出（Android上写系统日志，其他平台写stderr）
+     */
+    static void start(const Sink& sink = nullptr);
+
+    /**
+     * 输出队列里剩下的日志，停止后台输出线程（退出前调用）
+     */
+    static void stop();
+
+    /**
+     * 等到调用之前写的日志都已经输出（输出线程没有启动时立即返回）
+     */
+    static void flush();
+
+    /**
+     * 因为队列满而丢掉的日志数
+     */
+    static uint64_t getDroppedCount();
+
+    /**
+     * 当前时间（纳秒，单调递增）
+     */
+    static uint64_t now();
+
+    /**
+     * 把一条日志格式化成一行文本：[秒数] 级别 文件:行号 内容
+     */
+    static std::string format(const LogRecord& record);
+
+    /**
+     * 写一条日志（一般通过GAME_LOG_xxx使用）
+     */
+    template <typename... Args>
+    static void write(const LogSite& site, const Args&... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs, "too many log arguments");
+        LogRecord record;
+        record.site = &site;
+        record.time = now();
+        record.argCount = 0;
+        record.textUsed = 0;
+        pack(record, args...);
+        push(record);
+    }
+
+private:
+    static void push(const LogRecord& record);
+
+    static void pack(LogRecord&) {}
+
+    template <typename T, typename... Rest>
+    static void pack(LogRecord& record, const T& value, const Rest&... rest) {
+        packArg(record, value);
+        pack(record, rest...);
+    }
+
+    // 整数、枚举、bool、char
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    packArg(LogRecord& record, T value) {
+        int index = record.argCount++;
+        if (std::is_unsigned<T>::value && !std::is_same<T, bool>::value) {
+            record.types[index] = LogArgType::UINT;
+            record.values[index].u = (uint64_t)value;
+        } else {
+            record.types[index] = LogArgType::INT;
+            record.values[index].i = (int64_t)value;
+        }
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+    packArg(LogRecord& record, T value) {
+        int index = record.argCount++;
+        record.types[index] = LogArgType::DOUBLE;
+        record.values[index].d = (double)value;
+    }
+
+    template <typename T>
+    static void packArg(LogRecord& record, const T* value) {
+        int index = record.argCount++;
+        record.types[index] = LogArgType::POINTER;
+        record.values[index].p = value;
+    }
+
+    static void packArg(LogRecord& record, const char* value) {
+        packString(record, value ? value : "(null)", value ? strlen(value) : 6);
+    }
+
+    static void packArg(LogRecord& record, char* value) {
+        packArg(record, (const char*)value);
+    }
+
+    static void packArg(LogRecord& record, const std::string& value) {
+        packString(record, value.data(), value.size());
+    }
+
+    static void packString(LogRecord& record, const char* text, size_t length);
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief MappedFile - 只读的内存映射文件
+ *
+ * 把整个文件映射到内存，打开的代价和文件大小无关，
+ * 之后访问到哪一页操作系统才读入哪一页（POSIX用mmap，Windows用CreateFileMapping）。
+ *
+ * 注意：
+ * - Android上APK里的资源不是普通文件，不能直接映射，需要先拷贝到可写目录
+ * - 不能拷贝，析构时自动解除映射
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /**
+     * 映射文件（之前映射的文件会先关闭）
+     * @param path 文件路径（UTF-8）
+     * @return false=文件打不开、是空文件或者映射失败
+     */
+    bool open(const std::string& path);
+
+    /**
+     * 解除映射
+     */
+    void close();
+
+    bool isOpen() const { return _data != nullptr; }
+    const uint8_t* getData() const { return _data; }
+    size_t getSize() const { return _size; }
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+#ifdef _WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
@@ -0,0 +1,229 @@
+#include "ParallelGameSolver.h"
+#include <chrono>
+#include <climits>
+
+/**
+ * 每个线程攒够这么多节点再加到共享计数器上，避免每个节点都写同一个缓存行
+ */
+static const uint64_t kNodeBatch = 1024;
+
+SharedTranspositionTable::SharedTranspositionTable(size_t maxBytes) {
+    size_t stripeBytes = maxBytes / kStripeCount;
+    for (int i = 0; i < kStripeCount; i++) {
+        _stripes.push_back(std::unique_ptr<Stripe>(new Stripe(stripeBytes)));
+    }
+}
+
+void SharedTranspositionTable::insert(uint64_t key) {
+    Stripe& stripe = stripeFor(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    stripe.table.insert(key);
+}
+
+bool SharedTranspositionTable::contains(uint64_t key) {
+    Stripe& stripe = stripeFor(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    return stripe.table.contains(key);
+}
+
+void SharedTranspositionTable::clear() {
+    for (auto& stripe : _stripes) {
+        std::lock_guard<std::mutex> lock(stripe->mutex);
+        stripe->table.clear();
+    }
+}
+
+size_t SharedTranspositionTable::getBytes() {
+    size_t bytes = 0;
+    for (auto& stripe : _stripes) {
+        std::lock_guard<std::mutex> lock(stripe->mutex);
+        bytes += stripe->table.getBytes();
+    }
+    return bytes;
+}
+
+ParallelGameSolver::ParallelGameSolver(int threadCount, const SolverOptions& options)
+    : _options(options), _pool(threadCount), _table(options.maxTableBytes),
+      _firstSolvedTask(INT_MAX), _nodes(0), _limitReached(false) {
+}
+
+SolverResult ParallelGameSolver::solve(const GameModel& model) {
+    SolverResult result;
+
+    PackedGameState state;
+    PackedLayout layout;
+    if (!PackedGameState::fromModel(model, state, layout)) {
+        result.status = SolveStatus::INVALID;
+        return result;
+    }
+
+    std::vector<PackedMove> path;
+    solvePacked(state, path, result);
+    if (result.status == SolveStatus::SOLVED) {
+        GameSolver::toMoves(layout, path, result.moves);
+    }
+    return result;
+}
+
+void ParallelGameSolver::solvePacked(const PackedGameState& start, std::vector<PackedMove>& path, SolverResult& result) {
+    auto startTime = std::chrono::steady_clock::now();
+    _table.clear();
+    _firstSolvedTask = INT_MAX;
+    _nodes = 0;
+    _limitReached = false;
+    path.clear();
+
+    std::vector<Task> tasks;
+    splitTasks(start, tasks);
+
+    _pool.run((int)tasks.size(), [this, &tasks](int taskIndex, int) {
+        searchTask(taskIndex, tasks[taskIndex]);
+    });
+
+    // 按任务编号合并：第一个获胜的任务就是答案
+    result.status = SolveStatus::UNSOLVABLE;
+    for (const auto& task : tasks) {
+        if (task.status == SolveStatus::SOLVED) {
+            path = task.prefix;
+            path.insert(path.end(), task.path.begin(), task.path.end());
+            result.status = SolveStatus::SOLVED;
+            break;
+        }
+        if (task.status == SolveStatus::LIMIT_REACHED) {
+            result.status = SolveStatus::LIMIT_REACHED;
+        }
+    }
+
+    result.nodes = _nodes;
+    result.peakTableBytes = _table.getBytes();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * 按走法顺序一层层展开，直到子局面数量达到kSplitTaskCount
+ * 每个局面原地换成它的所有子局面，所以任务列表始终保持深度优先的顺序；
+ * 已经赢了的局面保留（它就是一个直接获胜的任务），没有走法的局面直接丢掉
+ */
+void ParallelGameSolver::splitTasks(const PackedGameState& start, std::vector<Task>& tasks) {
+    tasks.clear();
+    Task root;
+    root.state = start;
+    root.status = SolveStatus::UNSOLVABLE;
+    tasks.push_back(root);
+
+    while ((int)tasks.size() < kSplitTaskCount) {
+        std::vector<Task> next;
+        bool expanded = false;
+        for (auto& task : tasks) {
+            if (task.state.isWon()) {
+                next.push_back(std::move(task));
+                continue;
+            }
+
+            _nodes++;
+            PackedMove moves[PackedGameState::kMaxMoves];
+            int count = GameSolver::pruneMoves(task.state, moves, task.state.generateMoves(moves));
+            GameSolver::orderMoves(task.state, moves, count);
+            for (int i = 0; i < count; i++) {
+                Task child;
+                child.state = task.state;
+                child.state.apply(moves[i]);
+                child.prefix = task.prefix;
+                child.prefix.push_back(moves[i]);
+                child.status = SolveStatus::UNSOLVABLE;
+                next.push_back(std::move(child));
+                expanded = true;
+            }
+        }
+        tasks.swap(next);
+        if (!expanded) break;
+    }
+}
+
+/**
+ * 搜索一个任务的子树（和GameSolver::solvePacked相同的深度优先搜索）
+ *
+ * 区别：
+ * - 进入局面时只查共享置换表，不插入；一个局面的走法全部试完才插入，
+ *   这时它的整个子树都搜过了，可以确定它赢不了，其他线程遇到它可以直接跳过
+ * - 编号更小的任务已经赢了，或者达到节点上限时，立即停止
+ */
+void ParallelGameSolver::searchTask(int taskIndex, Task& task) {
+    struct Frame {
+        PackedMove moves[PackedGameState::kMaxMoves];
+        int count;
+        int next;
+    };
+
+    task.status = SolveStatus::UNSOLVABLE;
+    task.path.clear();
+
+    PackedGameState state = task.state;
+    std::vector<Frame> stack;
+    uint64_t pendingNodes = 0;
+
+    auto enter = [&]() -> bool {
+        pendingNodes++;
+        if (_table.contains(state.hash())) return false;
+        stack.push_back(Frame());
+        Frame& frame = stack.back();
+        frame.count = GameSolver::pruneMoves(state, frame.moves, state.generateMoves(frame.moves));
+        frame.next = 0;
+        GameSolver::orderMoves(state, frame.moves, frame.count);
+        return true;
+    };
+
+    if (state.isWon()) {
+        task.status = SolveStatus::SOLVED;
+    } else {
+        enter();
+    }
+
+    while (!stack.empty()) {
+        if (pendingNodes >= kNodeBatch) {
+            uint64_t total = _nodes.fetch_add(pendingNodes) + pendingNodes;
+            pendingNodes = 0;
+            if (_options.maxNodes > 0 && total >= _options.maxNodes) {
+                _limitReached = true;
+            }
+        }
+        if (_limitReached.load(std::memory_order_relaxed) ||
+            _firstSolvedTask.load(std::memory_order_relaxed) < taskIndex) {
+            task.status = SolveStatus::LIMIT_REACHED;
+            break;
+        }
+
+        Frame& frame = stack.back();
+        if (frame.next >= frame.count) {
+            // 整个子树都搜过了，这个局面赢不了
+            _table.insert(state.hash());
+            stack.pop_back();
+            if (!stack.empty()) {
+                Frame& parent = stack.back();
+                state.unapply(parent.moves[parent.next - 1]);
+            }
+            continue;
+        }
+
+        PackedMove move = frame.moves[frame.next++];
+        state.apply(move);
+        if (state.isWon()) {
+            task.status = SolveStatus::SOLVED;
+            break;
+        }
+        if (!enter()) {
+            state.unapply(move);
+        }
+    }
+    _nodes += pendingNodes;
+
+    if (task.status == SolveStatus::SOLVED) {
+        for (const auto& frame : stack) {
+            task.path.push_back(frame.moves[frame.next - 1]);
+        }
+        // 记录编号最小的获胜任务，编号更大的任务看到后会停止
+        int current = _firstSolvedTask.load();
+        while (taskIndex < current && !_firstSolvedTask.compare_exchange_weak(current, taskIndex)) {
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "GameSolver.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief SharedTranspositionTable - 多线程共用的置换表
+ *
+ * 按哈希值分成kStripeCount段，每段是一个TranspositionTable加一把锁，
+ * 不同线程访问不同段时互不影响。
+ * 并行求解器只往里面放"已经证明赢不了"的局面，所以表满了插不进去也不影响正确性，只是少剪一些枝
+ */
+class SharedTranspositionTable {
+public:
+    static const int kStripeCount = 64;  // 分段数（2的幂）
+
+    /**
+     * @param maxBytes 所有分段加起来最多占用的内存
+     */
+    explicit SharedTranspositionTable(size_t maxBytes);
+
+    /**
+     * 插入一个局面哈希（表满时忽略）
+     */
+    void insert(uint64_t key);
+
+    /**
+     * 是否包含某个局面哈希
+     */
+    bool contains(uint64_t key);
+
+    /**
+     * 清空（保留已分配的内存）
+     */
+    void clear();
+
+    /**
+     * 所有分段占用的内存（字节）
+     */
+    size_t getBytes();
+
+private:
+    struct Stripe {
+        std::mutex mutex;
+        TranspositionTable table;
+        explicit Stripe(size_t maxBytes) : table(1024, maxBytes) {}
+    };
+    std::vector<std::unique_ptr<Stripe>> _stripes;
+
+    Stripe& stripeFor(uint64_t key) { return *_stripes[(size_t)(key >> 58) & (kStripeCount - 1)]; }
+};
+
+/**
+ * @brief ParallelGameSolver - 多线程求解器
+ *
+ * 和GameSolver解同一个问题，用工作窃取线程池把搜索树分给所有CPU核。
+ *
+ * 算法：
+ * 1. 拆分：从起始局面开始按GameSolver的走法顺序一层层展开，直到得到至少kSplitTaskCount个子局面，
+ *    每个子局面是一个任务，任务编号就是它在深度优先顺序中的位置
+ * 2. 搜索：线程池并行搜索每个任务的子树，一个局面的所有走法都试完还没赢，就把它放进共享置换表，
+ *    其他线程再遇到这个局面直接跳过
+ * 3. 合并：编号最小的获胜任务决定答案；某个任务赢了以后，编号更大的任务立即停止
+ *
+ * 结果确定：
+ * - GameSolver::pruneMoves去掉"换上来不能匹配"的换底牌操作后，换底牌以后一定是匹配，
+ *   匹配会让主牌区少一张牌，所以局面之间不会形成环。
+ *   这种情况下置换表只会剪掉赢不了的子树，搜索找到的总是"按走法顺序的第一条获胜路线"
+ * - 所以不管几个线程、哪个线程先做完，得到的操作序列都一样，也和单线程的GameSolver一样
+ * - 达到节点数或内存上限（LIMIT_REACHED）时结果和线程调度有关，不保证一致
+ *
+ * 使用示例：
+ * ParallelGameSolver solver;  // 线程数=CPU核数
+ * SolverResult result = solver.solve(gameLogic.getModel());
+ */
+class ParallelGameSolver {
+public:
+    static const int kSplitTaskCount = 256;  // 拆分出的任务数下限（和线程数无关，保证结果确定）
+
+    /**
+     * @param threadCount 线程数，<=0表示使用CPU核数
+     * @param options 求解参数（maxNodes是所有线程加起来的节点数）
+     */
+    explicit ParallelGameSolver(int threadCount = 0, const SolverOptions& options = SolverOptions());
+
+    /**
+     * 求解一局游戏
+     * @param model 当前游戏模型（不会被修改），可以直接传GameController/GameLogic正在用的模型
+     * @return 求解结果
+     */
+    SolverResult solve(const GameModel& model);
+
+    /**
+     * 在紧凑状态上求解，参数含义同GameSolver::solvePacked
+     */
+    void solvePacked(const PackedGameState& state, std::vector<PackedMove>& path, SolverResult& result);
+
+    int getThreadCount() const { return _pool.getThreadCount(); }
+
+private:
+    /**
+     * 拆分出来的一个子局面
+     */
+    struct Task {
+        PackedGameState state;              // 子局面
+        std::vector<PackedMove> prefix;     // 从起始局面走到这里的操作
+        SolveStatus status;                 // 这个子树的搜索结果
+        std::vector<PackedMove> path;       // 子树里的获胜操作（从子局面开始）
+    };
+
+    SolverOptions _options;
+    WorkStealingPool _pool;
+    SharedTranspositionTable _table;
+
+    std::atomic<int> _firstSolvedTask;  // 目前找到的编号最小的获胜任务
+    std::atomic<uint64_t> _nodes;       // 所有线程展开的节点数
+    std::atomic<bool> _limitReached;
+
+    void splitTasks(const PackedGameState& start, std::vector<Task>& tasks);
+    void searchTask(int taskIndex, Task& task);
+};
@@ -0,0 +1,112 @@
+#include "RectPacker.h"
+#include <algorithm>
+#include <climits>
+
+RectPacker::RectPacker(int width, int height) {
+    reset(width, height);
+}
+
+void RectPacker::reset(int width, int height) {
+    _width = width;
+    _height = height;
+    _usedWidth = 0;
+    _usedHeight = 0;
+    _usedArea = 0;
+    _freeRects.clear();
+    if (width > 0 && height > 0) {
+        _freeRects.push_back(Rect{ 0, 0, width, height });
+    }
+}
+
+float RectPacker::getOccupancy() const {
+    long long area = (long long)_width * _height;
+    return area > 0 ? (float)((double)_usedArea / area) : 0.0f;
+}
+
+/**
+ * 选择位置：剩余短边最小，相同时剩余长边最小（Best Short Side Fit）
+ */
+bool RectPacker::insert(int width, int height, int& x, int& y) {
+    if (width <= 0 || height <= 0) return false;
+
+    int bestShort = INT_MAX, bestLong = INT_MAX;
+    const Rect* best = nullptr;
+    for (const Rect& free : _freeRects) {
+        if (free.width < width || free.height < height) continue;
+        int leftoverX = free.width - width;
+        int leftoverY = free.height - height;
+        int shortSide = std::min(leftoverX, leftoverY);
+        int longSide = std::max(leftoverX, leftoverY);
+        if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+            best = &free;
+            bestShort = shortSide;
+            bestLong = longSide;
+        }
+    }
+    if (!best) return false;
+
+    Rect used{ best->x, best->y, width, height };
+    splitFreeRects(used);
+    pruneFreeRects();
+
+    x = used.x;
+    y = used.y;
+    _usedWidth = std::max(_usedWidth, used.x + width);
+    _usedHeight = std::max(_usedHeight, used.y + height);
+    _usedArea += (long long)width * height;
+    return true;
+}
+
+/**
+ * 和放入的矩形相交的空闲矩形切成最多四个（上下左右剩下的部分）
+ */
+void RectPacker::splitFreeRects(const Rect& used) {
+    _splitRects.clear();
+    for (const Rect& free : _freeRects) {
+        bool intersects = used.x < free.x + free.width && used.x + used.width > free.x &&
+                          used.y < free.y + free.height && used.y + used.height > free.y;
+        if (!intersects) {
+            _splitRects.push_back(free);
+            continue;
+        }
+        if (used.x > free.x) {
+            _splitRects.push_back(Rect{ free.x, free.y, used.x - free.x, free.height });
+        }
+        if (used.x + used.width < free.x + free.width) {
+            int right = used.x + used.width;
+            _splitRects.push_back(Rect{ right, free.y, free.x + free.width - right, free.height });
+        }
+        if (used.y > free.y) {
+            _splitRects.push_back(Rect{ free.x, free.y, free.width, used.y - free.y });
+        }
+        if (used.y + used.height < free.y + free.height) {
+            int bottom = used.y + used.height;
+            _splitRects.push_back(Rect{ free.x, bottom, free.width, free.y + free.height - bottom });
+        }
+    }
+    _freeRects.swap(_splitRects);
+}
+
+bool RectPacker::contains(const Rect& outer, const Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+/**
+ * 去掉被别的空闲矩形完全包含的空闲矩形（相同的只留一个）
+ */
+void RectPacker::pruneFreeRects() {
+    for (size_t i = 0; i < _freeRects.size(); i++) {
+        for (size_t j = i + 1; j < _freeRects.size();) {
+            if (contains(_freeRects[i], _freeRects[j])) {
+                _freeRects.erase(_freeRects.begin() + j);
+            } else if (contains(_freeRects[j], _freeRects[i])) {
+                _freeRects.erase(_freeRects.begin() + i);
+                j = i + 1;
+            } else {
+                j++;
+            }
+        }
+    }
+}
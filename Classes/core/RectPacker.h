@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+
+/**
+ * @brief RectPacker - 矩形装箱（MaxRects，最短边最贴合）
+ *
+ * 把一组矩形（图片）放进固定大小的箱子（图集的一页），矩形之间不重叠，不旋转。
+ * 箱子里记录所有最大的空闲矩形，每次放入时选剩余短边最小的位置，再切分、去掉被包含的空闲矩形。
+ * 图集打包工具（tools/AtlasPacker.cpp）使用，不依赖图片格式，可以单独测试。
+ *
+ * 使用示例：
+ * RectPacker packer(2048, 2048);
+ * int x, y;
+ * if (packer.insert(width + padding, height + padding, x, y)) { ... }
+ */
+class RectPacker {
+public:
+    RectPacker(int width, int height);
+
+    /**
+     * 清空，重新开始装箱
+     */
+    void reset(int width, int height);
+
+    /**
+     * 放入一个矩形
+     * @param x 输出：放入的位置（左上角）
+     * @param y 输出
+     * @return false=放不下
+     */
+    bool insert(int width, int height, int& x, int& y);
+
+    /**
+     * 已经放入的矩形占用的范围（从左上角算起），用来裁剪图集的大小
+     */
+    int getUsedWidth() const { return _usedWidth; }
+    int getUsedHeight() const { return _usedHeight; }
+
+    /**
+     * 已经放入的面积占箱子面积的比例
+     */
+    float getOccupancy() const;
+
+private:
+    struct Rect {
+        int x, y, width, height;
+    };
+
+    int _width;
+    int _height;
+    int _usedWidth;
+    int _usedHeight;
+    long long _usedArea;
+    std::vector<Rect> _freeRects;   // 最大空闲矩形
+    std::vector<Rect> _splitRects;  // 切分时的临时数组
+
+    void splitFreeRects(const Rect& used);
+    void pruneFreeRects();
+    static bool contains(const Rect& outer, const Rect& inner);
+};
@@ -0,0 +1,401 @@
+#include "Replay.h"
+#include "GameLogic.h"
+#include <cmath>
+#include <cstdio>
+
+static const uint8_t kMagic[4] = { 'C', 'G', 'R', 'P' };
+
+// 常量会以引用方式传给push_back，需要定义
+const uint8_t ReplayFormat::kVersion;
+const uint8_t ReplayFormat::kStartSeed;
+const uint8_t ReplayFormat::kStartDeal;
+const uint8_t ReplayFormat::kClickEscape;
+const uint8_t ReplayFormat::kUndo;
+const uint8_t ReplayFormat::kRedo;
+const uint8_t ReplayFormat::kSeek;
+const uint8_t ReplayFormat::kFinish;
+
+/**
+ * 写入无符号varint：每个字节存7位，最高位为1表示后面还有字节
+ */
+static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+/**
+ * 有符号数先做zigzag编码（0,-1,1,-2... -> 0,1,2,3...），小的负数也只占1个字节
+ */
+static void writeSignedVarint(std::vector<uint8_t>& out, int32_t value) {
+    writeVarint(out, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static void writeFixed64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back((uint8_t)(value >> (i * 8)));
+    }
+}
+
+static bool readVarint(const uint8_t* data, size_t size, size_t& offset, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= size) return false;
+        uint8_t byte = data[offset++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;  // 超过10个字节，数据损坏
+}
+
+static bool readSignedVarint(const uint8_t* data, size_t size, size_t& offset, int32_t& value) {
+    uint64_t raw;
+    if (!readVarint(data, size, offset, raw)) return false;
+    value = (int32_t)((uint32_t)(raw >> 1) ^ (0u - (uint32_t)(raw & 1)));
+    return true;
+}
+
+static bool readFixed64(const uint8_t* data, size_t size, size_t& offset, uint64_t& value) {
+    if (size - offset < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)data[offset + i] << (i * 8);
+    }
+    offset += 8;
+    return true;
+}
+
+static void writeCard(std::vector<uint8_t>& out, const CardModel& card) {
+    writeVarint(out, (uint64_t)card.id);
+    out.push_back((uint8_t)((card.face & 0x0F) | (card.suit & 0x03) << 4 | (card.isFaceUp ? 0x40 : 0)));
+    writeSignedVarint(out, (int32_t)std::lround(card.posX));
+    writeSignedVarint(out, (int32_t)std::lround(card.posY));
+}
+
+static bool readCard(const uint8_t* data, size_t size, size_t& offset, CardModel& card) {
+    uint64_t id;
+    int32_t posX, posY;
+    if (!readVarint(data, size, offset, id) || offset >= size) return false;
+    uint8_t packed = data[offset++];
+    if (!readSignedVarint(data, size, offset, posX) || !readSignedVarint(data, size, offset, posY)) return false;
+    card.id = (int)id;
+    card.face = packed & 0x0F;
+    card.suit = (packed >> 4) & 0x03;
+    card.isFaceUp = (packed & 0x40) != 0;
+    card.posX = (float)posX;
+    card.posY = (float)posY;
+    return true;
+}
+
+static uint64_t mixHash(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * 主牌区的顺序会因为swap-and-pop而不同，所以每张牌的哈希相加（和顺序无关）；
+ * 底牌堆的顺序有意义，按顺序滚动混合
+ */
+uint64_t ReplayFormat::hashModel(const GameModel& model) {
+    uint64_t playfield = 0;
+    for (const auto& card : model.getPlayfieldCards()) {
+        playfield += mixHash((uint64_t)card.id << 8 | (uint64_t)(card.face << 2 | card.suit));
+    }
+    uint64_t stack = 0x9E3779B97F4A7C15ULL;
+    for (const auto& card : model.getStackCards()) {
+        stack = mixHash(stack ^ ((uint64_t)card.id << 8 | (uint64_t)(card.face << 2 | card.suit)));
+    }
+    return mixHash(playfield ^ stack);
+}
+
+bool ReplayFormat::loadFile(const std::string& path, std::vector<uint8_t>& data) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    data.clear();
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + count);
+    }
+    fclose(file);
+    return true;
+}
+
+bool ReplayFormat::saveFile(const std::string& path, const std::vector<uint8_t>& data) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = data.empty() || fwrite(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return ok;
+}
+
+ReplayRecorder::ReplayRecorder() : _lastTimeMs(0), _recording(false) {
+}
+
+void ReplayRecorder::beginWithSeed(uint64_t seed, const DealOptions& options) {
+    clear();
+    _data.insert(_data.end(), kMagic, kMagic + 4);
+    _data.push_back(ReplayFormat::kVersion);
+    _data.push_back(ReplayFormat::kStartSeed);
+    writeFixed64(_data, seed);
+    _data.push_back((uint8_t)options.minCards);
+    _data.push_back((uint8_t)options.maxCards);
+    _data.push_back((uint8_t)options.minPlayfieldPercent);
+    _data.push_back((uint8_t)options.maxPlayfieldPercent);
+    _data.push_back(options.requireFirstMove ? 1 : 0);
+    _recording = true;
+}
+
+void ReplayRecorder::beginWithModel(const GameModel& model) {
+    clear();
+    _data.insert(_data.end(), kMagic, kMagic + 4);
+    _data.push_back(ReplayFormat::kVersion);
+    _data.push_back(ReplayFormat::kStartDeal);
+    writeVarint(_data, (uint64_t)model.peekNextCardId());
+    writeVarint(_data, model.getPlayfieldCards().size());
+    for (const auto& card : model.getPlayfieldCards()) {
+        writeCard(_data, card);
+    }
+    writeVarint(_data, model.getStackCards().size());
+    for (const auto& card : model.getStackCards()) {
+        writeCard(_data, card);
+    }
+    _recording = true;
+}
+
+/**
+ * 时间只保存和上一个事件的间隔，玩家操作的间隔一般在几百毫秒以内，只占1-2个字节
+ */
+void ReplayRecorder::writeEvent(uint8_t code, uint32_t timeMs) {
+    uint32_t delta = timeMs > _lastTimeMs ? timeMs - _lastTimeMs : 0;
+    _lastTimeMs += delta;
+    writeVarint(_data, delta);
+    _data.push_back(code);
+}
+
+void ReplayRecorder::recordClick(int cardId, uint32_t timeMs) {
+    if (!_recording || cardId < 0) return;
+    if (cardId < ReplayFormat::kClickEscape) {
+        writeEvent((uint8_t)cardId, timeMs);
+    } else {
+        writeEvent(ReplayFormat::kClickEscape, timeMs);
+        writeVarint(_data, (uint64_t)cardId);
+    }
+}
+
+void ReplayRecorder::recordUndo(uint32_t timeMs) {
+    if (!_recording) return;
+    writeEvent(ReplayFormat::kUndo, timeMs);
+}
+
+void ReplayRecorder::recordRedo(uint32_t timeMs) {
+    if (!_recording) return;
+    writeEvent(ReplayFormat::kRedo, timeMs);
+}
+
+void ReplayRecorder::recordSeek(int position, uint32_t timeMs) {
+    if (!_recording || position < 0) return;
+    writeEvent(ReplayFormat::kSeek, timeMs);
+    writeVarint(_data, (uint64_t)position);
+}
+
+void ReplayRecorder::finish(const GameModel& model, uint32_t timeMs) {
+    if (!_recording) return;
+    writeEvent(ReplayFormat::kFinish, timeMs);
+    writeFixed64(_data, ReplayFormat::hashModel(model));
+    _recording = false;
+}
+
+void ReplayRecorder::clear() {
+    _data.clear();
+    _lastTimeMs = 0;
+    _recording = false;
+}
+
+ReplayReader::ReplayReader()
+    : _data(nullptr), _size(0), _eventsOffset(0), _offset(0), _timeMs(0), _corrupt(false),
+      _startType(ReplayFormat::kStartSeed), _seed(0), _nextCardId(0) {
+}
+
+/**
+ * 解析文件头
+ * 卡牌ID不能超过一个合理的上限，防止损坏的数据让applyInitialState分配巨大的索引表
+ */
+bool ReplayReader::open(const uint8_t* data, size_t size) {
+    static const uint64_t kMaxCardId = 1 << 16;
+
+    _data = data;
+    _size = size;
+    _playfield.clear();
+    _stack.clear();
+
+    size_t offset = 0;
+    if (size < 6 || data[0] != kMagic[0] || data[1] != kMagic[1] || data[2] != kMagic[2] || data[3] != kMagic[3]) {
+        return false;
+    }
+    if (data[4] != ReplayFormat::kVersion) return false;
+    _startType = data[5];
+    offset = 6;
+
+    if (_startType == ReplayFormat::kStartSeed) {
+        if (!readFixed64(data, size, offset, _seed) || size - offset < 5) return false;
+        _options.minCards = data[offset];
+        _options.maxCards = data[offset + 1];
+        _options.minPlayfieldPercent = data[offset + 2];
+        _options.maxPlayfieldPercent = data[offset + 3];
+        _options.requireFirstMove = (data[offset + 4] & 1) != 0;
+        offset += 5;
+    } else if (_startType == ReplayFormat::kStartDeal) {
+        uint64_t nextCardId, count;
+        if (!readVarint(data, size, offset, nextCardId) || nextCardId > kMaxCardId) return false;
+        _nextCardId = (int)nextCardId;
+        for (int zone = 0; zone < 2; zone++) {
+            std::vector<CardModel>& cards = zone == 0 ? _playfield : _stack;
+            if (!readVarint(data, size, offset, count) || count > kMaxCardId) return false;
+            cards.resize((size_t)count);
+            for (auto& card : cards) {
+                if (!readCard(data, size, offset, card) || card.id >= (int)kMaxCardId) return false;
+            }
+        }
+    } else {
+        return false;
+    }
+
+    _eventsOffset = offset;
+    rewind();
+    return true;
+}
+
+void ReplayReader::applyInitialState(GameModel& model) const {
+    if (hasSeed()) {
+        Deal deal;
+        DealGenerator::generate(_seed, _options, deal);
+        deal.applyTo(model);
+        return;
+    }
+    for (const auto& card : _playfield) {
+        model.addCardToPlayfield(card);
+    }
+    for (const auto& card : _stack) {
+        model.addCardToStack(card);
+    }
+    model.setNextCardId(_nextCardId);
+}
+
+bool ReplayReader::next(ReplayEvent& event) {
+    if (_corrupt || _offset >= _size) return false;
+
+    uint64_t delta;
+    if (!readVarint(_data, _size, _offset, delta) || _offset >= _size) {
+        _corrupt = true;
+        return false;
+    }
+    _timeMs += (uint32_t)delta;
+    event.timeMs = _timeMs;
+    event.value = -1;
+    event.stateHash = 0;
+
+    uint8_t code = _data[_offset++];
+    uint64_t value = 0;
+    bool ok = true;
+    if (code < ReplayFormat::kClickEscape) {
+        event.type = ReplayEventType::CLICK;
+        event.value = code;
+    } else if (code == ReplayFormat::kClickEscape) {
+        event.type = ReplayEventType::CLICK;
+        ok = readVarint(_data, _size, _offset, value);
+        event.value = (int)value;
+    } else if (code == ReplayFormat::kUndo) {
+        event.type = ReplayEventType::UNDO;
+    } else if (code == ReplayFormat::kRedo) {
+        event.type = ReplayEventType::REDO;
+    } else if (code == ReplayFormat::kSeek) {
+        event.type = ReplayEventType::SEEK;
+        ok = readVarint(_data, _size, _offset, value);
+        event.value = (int)value;
+    } else if (code == ReplayFormat::kFinish) {
+        event.type = ReplayEventType::FINISH;
+        ok = readFixed64(_data, _size, _offset, event.stateHash);
+    } else {
+        ok = false;  // 未知的事件
+    }
+
+    if (!ok) {
+        _corrupt = true;
+        return false;
+    }
+    return true;
+}
+
+void ReplayReader::rewind() {
+    _offset = _eventsOffset;
+    _timeMs = 0;
+    _corrupt = false;
+}
+
+void ReplayPlayer::setupGame(const ReplayReader& reader, GameLogic& logic) {
+    logic.reset();
+    reader.applyInitialState(logic.getModel());
+}
+
+/**
+ * 执行一个事件
+ * 点击的处理和GameController::onCardClicked相同：点击 -> getMoveForCard -> applyMove
+ */
+bool ReplayPlayer::applyEvent(const ReplayEvent& event, GameLogic& logic, ReplayStats* stats) {
+    bool changed = false;
+    switch (event.type) {
+        case ReplayEventType::CLICK: {
+            Move move = logic.getMoveForCard(event.value);
+            changed = move.isValid() && logic.applyMove(move);
+            if (stats) {
+                stats->clicks++;
+                if (changed) stats->appliedMoves++;
+            }
+            break;
+        }
+        case ReplayEventType::UNDO:
+            changed = logic.undo();
+            if (stats && changed) stats->undos++;
+            break;
+        case ReplayEventType::REDO:
+            changed = logic.redo();
+            if (stats && changed) stats->redos++;
+            break;
+        case ReplayEventType::SEEK:
+            changed = logic.seek(event.value);
+            if (stats && changed) stats->seeks++;
+            break;
+        case ReplayEventType::FINISH:
+            if (stats) {
+                stats->finished = true;
+                stats->stateMatches = ReplayFormat::hashModel(logic.getModel()) == event.stateHash;
+            }
+            break;
+    }
+    if (stats) {
+        stats->events++;
+        stats->durationMs = event.timeMs;
+    }
+    return changed;
+}
+
+bool ReplayPlayer::playHeadless(const uint8_t* data, size_t size, GameLogic& logic, ReplayStats* stats) {
+    ReplayReader reader;
+    if (!reader.open(data, size)) return false;
+
+    if (stats) *stats = ReplayStats();
+    setupGame(reader, logic);
+
+    ReplayEvent event;
+    while (reader.next(event)) {
+        applyEvent(event, logic, stats);
+    }
+    return !reader.isCorrupt();
+}
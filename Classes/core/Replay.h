@@ -0,0 +1,250 @@
+#pragma once
+#include "DealGenerator.h"
+#include "models/GameModel.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GameLogic;
+
+/**
+ * ReplayEventType - 回放事件的类型
+ */
+enum class ReplayEventType : uint8_t {
+    CLICK,      // 点击卡牌（value是卡牌ID，不合法的点击也会记录）
+    UNDO,       // 点击回退
+    REDO,       // 点击重做
+    SEEK,       // 跳到时间线的第value步
+    FINISH      // 结束标记，stateHash是结束时的局面哈希
+};
+
+/**
+ * ReplayEvent - 回放中的一个事件
+ */
+struct ReplayEvent {
+    ReplayEventType type = ReplayEventType::CLICK;
+    int value = -1;             // 卡牌ID或者跳转的步数
+    uint32_t timeMs = 0;        // 从开局算起的时间（毫秒）
+    uint64_t stateHash = 0;     // 只有FINISH有
+};
+
+/**
+ * 回放的二进制格式（小端，版本1）
+ *
+ * 文件头：
+ *   "CGRP" 版本(1字节) 开局类型(1字节：0=种子，1=完整牌局)
+ *   种子开局：种子(8字节) minCards maxCards minPlayfieldPercent maxPlayfieldPercent 标志位(各1字节)
+ *   完整牌局：nextCardId(varint) 主牌区张数(varint) 每张牌 + 底牌堆张数(varint) 每张牌
+ *     每张牌：id(varint) 点数|花色<<4|翻开<<6(1字节) posX posY(zigzag varint，坐标取整)
+ * 事件（一直到数据结尾）：
+ *   距上一个事件的毫秒数(varint) 事件字节 [附加数据]
+ *   事件字节 0x00-0x3E：点击ID为0-62的卡牌（一局牌最多52张，所以点击都只占1个字节）
+ *           0x3F：点击，后面跟卡牌ID(varint)
+ *           0x40：回退  0x41：重做  0x42：跳转，后面跟步数(varint)
+ *           0x43：结束，后面跟局面哈希(8字节)
+ *
+ * 一次点击一般是2个字节（间隔小于128毫秒时）或3个字节。
+ */
+class ReplayFormat {
+public:
+    static const uint8_t kVersion = 1;
+    static const uint8_t kStartSeed = 0;
+    static const uint8_t kStartDeal = 1;
+
+    static const uint8_t kClickEscape = 0x3F;
+    static const uint8_t kUndo = 0x40;
+    static const uint8_t kRedo = 0x41;
+    static const uint8_t kSeek = 0x42;
+    static const uint8_t kFinish = 0x43;
+
+    /**
+     * 局面哈希：底牌堆按顺序，主牌区和顺序无关，坐标不参与
+     * 用来检查回放结束时的局面和录制时是否一致
+     */
+    static uint64_t hashModel(const GameModel& model);
+
+    /**
+     * 读取/保存整个文件
+     * @return false=文件打不开
+     */
+    static bool loadFile(const std::string& path, std::vector<uint8_t>& data);
+    static bool saveFile(const std::string& path, const std::vector<uint8_t>& data);
+};
+
+/**
+ * @brief ReplayRecorder - 回放录制器
+ *
+ * 开局时调用beginWithSeed/beginWithModel写文件头，之后每次玩家输入记录一个事件。
+ * 记录的是玩家的输入（点击了哪张牌），不是操作结果，回放时按同样的规则重新执行，
+ * 所以不合法的点击也会记录下来，复现bug时和玩家看到的完全一样。
+ *
+ * 使用示例：
+ * ReplayRecorder recorder;
+ * recorder.beginWithSeed(seed, options);
+ * recorder.recordClick(cardId, timeMs);
+ * recorder.finish(logic.getModel(), timeMs);
+ * ReplayFormat::saveFile(path, recorder.getData());
+ */
+class ReplayRecorder {
+public:
+    ReplayRecorder();
+
+    /**
+     * 开始录制种子开局的一局（牌局由DealGenerator还原）
+     */
+    void beginWithSeed(uint64_t seed, const DealOptions& options);
+
+    /**
+     * 开始录制任意开局（写入模型中的所有卡牌）
+     * @param model 开局时的模型（还没有执行任何操作）
+     */
+    void beginWithModel(const GameModel& model);
+
+    /**
+     * 记录事件
+     * @param timeMs 从开局算起的时间（毫秒），比上一个事件早时按0间隔记录
+     */
+    void recordClick(int cardId, uint32_t timeMs);
+    void recordUndo(uint32_t timeMs);
+    void recordRedo(uint32_t timeMs);
+    void recordSeek(int position, uint32_t timeMs);
+
+    /**
+     * 写入结束标记和当前局面的哈希，之后不再记录事件
+     */
+    void finish(const GameModel& model, uint32_t timeMs);
+
+    /**
+     * 停止录制并清空数据
+     */
+    void clear();
+
+    /**
+     * 是否正在录制（begin之后、finish/clear之前）
+     */
+    bool isRecording() const { return _recording; }
+
+    /**
+     * 录制的数据
+     */
+    const std::vector<uint8_t>& getData() const { return _data; }
+
+private:
+    std::vector<uint8_t> _data;
+    uint32_t _lastTimeMs;       // 上一个事件的时间
+    bool _recording;
+
+    /**
+     * 写入事件的时间间隔和事件字节
+     */
+    void writeEvent(uint8_t code, uint32_t timeMs);
+};
+
+/**
+ * @brief ReplayReader - 回放读取器
+ *
+ * open()解析文件头，之后next()逐个读取事件，不分配内存。
+ * 数据由调用者持有，读取期间不能释放。
+ */
+class ReplayReader {
+public:
+    ReplayReader();
+
+    /**
+     * 解析文件头
+     * @return false=不是回放数据、版本不支持或者数据不完整
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    /**
+     * 开局类型：true=种子开局
+     */
+    bool hasSeed() const { return _startType == ReplayFormat::kStartSeed; }
+    uint64_t getSeed() const { return _seed; }
+    const DealOptions& getDealOptions() const { return _options; }
+
+    /**
+     * 把开局的卡牌添加到模型中（不会清空模型，先调用GameLogic::reset）
+     */
+    void applyInitialState(GameModel& model) const;
+
+    /**
+     * 读取下一个事件
+     * @return false=没有更多事件（读到结尾或者数据损坏，用isCorrupt()区分）
+     */
+    bool next(ReplayEvent& event);
+
+    /**
+     * 回到第一个事件
+     */
+    void rewind();
+
+    /**
+     * 数据是否损坏（事件读到一半数据就结束了）
+     */
+    bool isCorrupt() const { return _corrupt; }
+
+private:
+    const uint8_t* _data;
+    size_t _size;
+    size_t _eventsOffset;       // 第一个事件的位置
+    size_t _offset;             // 下一个要读的位置
+    uint32_t _timeMs;           // 上一个事件的时间
+    bool _corrupt;
+    uint8_t _startType;
+    uint64_t _seed;
+    DealOptions _options;
+    int _nextCardId;
+    std::vector<CardModel> _playfield;  // 完整牌局开局时的卡牌
+    std::vector<CardModel> _stack;
+};
+
+/**
+ * ReplayStats - 一次回放的统计
+ */
+struct ReplayStats {
+    int events = 0;             // 事件总数
+    int clicks = 0;             // 点击次数
+    int appliedMoves = 0;       // 点击中合法、执行成功的次数
+    int undos = 0;              // 成功的回退次数
+    int redos = 0;              // 成功的重做次数
+    int seeks = 0;              // 成功的跳转次数
+    uint32_t durationMs = 0;    // 录制时的总时长
+    bool finished = false;      // 是否有结束标记
+    bool stateMatches = false;  // 结束时的局面和录制时是否一致（有结束标记时才有意义）
+};
+
+/**
+ * @brief ReplayPlayer - 回放执行器
+ *
+ * 把回放事件交给GameLogic重新执行，规则和GameController处理点击时完全一样，
+ * 所以同一份回放每次执行的结果都相同。
+ *
+ * - 无界面回放：playHeadless()一次性全速执行所有事件（压测、批量复现bug）
+ * - 带界面回放：GameController::playReplay()按时间和倍速逐个调用applyEvent()
+ */
+class ReplayPlayer {
+public:
+    /**
+     * 按回放的文件头开局：重置GameLogic并添加开局的卡牌
+     */
+    static void setupGame(const ReplayReader& reader, GameLogic& logic);
+
+    /**
+     * 执行一个事件
+     * @param stats 可以为nullptr
+     * @return true=事件改变了局面（不合法的点击、没有可回退的记录等返回false）
+     */
+    static bool applyEvent(const ReplayEvent& event, GameLogic& logic, ReplayStats* stats);
+
+    /**
+     * 无界面全速回放
+     * @param data 回放数据
+     * @param size 数据长度
+     * @param logic 用来执行的游戏逻辑（会被重置）
+     * @param stats 输出：统计，可以为nullptr
+     * @return false=数据损坏或者文件头不对
+     */
+    static bool playHeadless(const uint8_t* data, size_t size, GameLogic& logic, ReplayStats* stats);
+};
@@ -0,0 +1,156 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+// 一个矩形最多登记的格子数（每个方向），防止异常大的矩形把格子表撑爆
+static const int kMaxCellSpan = 64;
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : _cellSize(cellSize > 0 ? cellSize : 128.0f), _inverseCellSize(1.0f / _cellSize), _count(0) {
+}
+
+uint64_t SpatialGrid::cellKey(int cellX, int cellY) {
+    return (uint64_t)(uint32_t)cellX << 32 | (uint32_t)cellY;
+}
+
+int SpatialGrid::cellCoordinate(float value) const {
+    float cell = std::floor(value * _inverseCellSize);
+    if (cell < (float)(INT32_MIN / 2)) return INT32_MIN / 2;
+    if (cell > (float)(INT32_MAX / 2)) return INT32_MAX / 2;
+    return (int)cell;
+}
+
+/**
+ * 记录矩形并计算覆盖的格子范围
+ */
+void SpatialGrid::setRect(Entry& entry, float minX, float minY, float maxX, float maxY) {
+    entry.item.minX = minX;
+    entry.item.minY = minY;
+    entry.item.maxX = maxX;
+    entry.item.maxY = maxY;
+    if (!(minX <= maxX && minY <= maxY)) {
+        // 空矩形（包括NaN）不占格子
+        entry.cellX0 = entry.cellY0 = 0;
+        entry.cellX1 = entry.cellY1 = -1;
+        return;
+    }
+    entry.cellX0 = cellCoordinate(minX);
+    entry.cellY0 = cellCoordinate(minY);
+    entry.cellX1 = std::min(cellCoordinate(maxX), entry.cellX0 + kMaxCellSpan - 1);
+    entry.cellY1 = std::min(cellCoordinate(maxY), entry.cellY0 + kMaxCellSpan - 1);
+}
+
+void SpatialGrid::addToCells(const Entry& entry) {
+    for (int y = entry.cellY0; y <= entry.cellY1; y++) {
+        for (int x = entry.cellX0; x <= entry.cellX1; x++) {
+            _cells[cellKey(x, y)].push_back(entry.item);
+        }
+    }
+}
+
+void SpatialGrid::removeFromCells(const Entry& entry) {
+    for (int y = entry.cellY0; y <= entry.cellY1; y++) {
+        for (int x = entry.cellX0; x <= entry.cellX1; x++) {
+            auto it = _cells.find(cellKey(x, y));
+            if (it == _cells.end()) continue;
+            std::vector<Item>& items = it->second;
+            for (size_t i = 0; i < items.size(); i++) {
+                if (items[i].handle == entry.item.handle) {
+                    // 格子里的顺序无关紧要，用最后一个填补
+                    items[i] = items.back();
+                    items.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * 覆盖的格子没变，只更新格子里的副本
+ */
+void SpatialGrid::refreshCells(const Entry& entry) {
+    for (int y = entry.cellY0; y <= entry.cellY1; y++) {
+        for (int x = entry.cellX0; x <= entry.cellX1; x++) {
+            auto it = _cells.find(cellKey(x, y));
+            if (it == _cells.end()) continue;
+            for (Item& item : it->second) {
+                if (item.handle == entry.item.handle) {
+                    item = entry.item;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int SpatialGrid::insert(float minX, float minY, float maxX, float maxY, uint64_t order) {
+    int handle;
+    if (!_freeHandles.empty()) {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+    } else {
+        handle = (int)_entries.size();
+        _entries.push_back(Entry());
+    }
+    Entry& entry = _entries[handle];
+    entry.used = true;
+    entry.item.order = order;
+    entry.item.handle = handle;
+    setRect(entry, minX, minY, maxX, maxY);
+    addToCells(entry);
+    _count++;
+    return handle;
+}
+
+void SpatialGrid::update(int handle, float minX, float minY, float maxX, float maxY, uint64_t order) {
+    if (handle < 0 || handle >= (int)_entries.size() || !_entries[handle].used) return;
+    Entry& entry = _entries[handle];
+    Entry moved = entry;
+    setRect(moved, minX, minY, maxX, maxY);
+    moved.item.order = order;
+    bool sameCells = moved.cellX0 == entry.cellX0 && moved.cellY0 == entry.cellY0 &&
+                     moved.cellX1 == entry.cellX1 && moved.cellY1 == entry.cellY1;
+    if (sameCells) {
+        entry = moved;
+        refreshCells(entry);
+    } else {
+        removeFromCells(entry);
+        entry = moved;
+        addToCells(entry);
+    }
+}
+
+void SpatialGrid::remove(int handle) {
+    if (handle < 0 || handle >= (int)_entries.size() || !_entries[handle].used) return;
+    removeFromCells(_entries[handle]);
+    _entries[handle].used = false;
+    _freeHandles.push_back(handle);
+    _count--;
+}
+
+int SpatialGrid::hitTest(float x, float y) const {
+    auto it = _cells.find(cellKey(cellCoordinate(x), cellCoordinate(y)));
+    if (it == _cells.end()) return -1;
+
+    const Item* best = nullptr;
+    for (const Item& item : it->second) {
+        if (x < item.minX || x > item.maxX || y < item.minY || y > item.maxY) continue;
+        if (!best || item.order > best->order) {
+            best = &item;
+        }
+    }
+    return best ? best->handle : -1;
+}
+
+/**
+ * 格子的数组只清空不释放，重新开局后再添加不用分配内存
+ */
+void SpatialGrid::clear() {
+    for (auto& cell : _cells) {
+        cell.second.clear();
+    }
+    _entries.clear();
+    _freeHandles.clear();
+    _count = 0;
+}
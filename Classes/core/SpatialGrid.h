@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief SpatialGrid - 矩形的均匀网格空间索引（点击检测用，不依赖cocos2d）
+ *
+ * 平面按cellSize划分成格子，每个矩形登记在它覆盖的所有格子里（格子按坐标哈希，平面不限大小）。
+ * 格子里直接保存矩形和层级的副本，点击检测只顺序扫描点所在的那一个格子，
+ * 找包含这个点、层级最高的一个，和矩形的总数无关：几千张卡牌时一次检测也在亚微秒级。
+ *
+ * 矩形移动时，覆盖的格子不变就只改格子里的副本，变了才从旧格子移到新格子。
+ * 空矩形（minX > maxX）不占格子，永远点不到，用来表示隐藏的卡牌。
+ *
+ * 使用示例：
+ * SpatialGrid grid(128.0f);
+ * int handle = grid.insert(0, 0, 120, 170, order);
+ * grid.update(handle, 10, 0, 130, 170, order);
+ * int hit = grid.hitTest(50, 50);  // handle，没有点到返回-1
+ */
+class SpatialGrid {
+public:
+    /**
+     * @param cellSize 格子边长，取和矩形差不多大小时最快
+     */
+    explicit SpatialGrid(float cellSize = 128.0f);
+
+    /**
+     * 添加矩形（边界包含在内）
+     * @param order 层级，重叠时层级高的被点到
+     * @return 句柄，remove之后会被重新使用
+     */
+    int insert(float minX, float minY, float maxX, float maxY, uint64_t order);
+
+    /**
+     * 修改矩形的位置、大小和层级
+     */
+    void update(int handle, float minX, float minY, float maxX, float maxY, uint64_t order);
+
+    /**
+     * 移除矩形
+     */
+    void remove(int handle);
+
+    /**
+     * 点击检测
+     * @return 包含这个点的层级最高的矩形的句柄，没有返回-1
+     */
+    int hitTest(float x, float y) const;
+
+    /**
+     * 移除所有矩形（保留格子的内存）
+     */
+    void clear();
+
+    /**
+     * 矩形数量
+     */
+    int getCount() const { return _count; }
+
+private:
+    struct Item {
+        float minX, minY, maxX, maxY;
+        uint64_t order;
+        int handle;
+    };
+
+    struct Entry {
+        Item item;
+        int cellX0, cellY0, cellX1, cellY1;     // 覆盖的格子范围（cellX0 > cellX1表示不占格子）
+        bool used;
+    };
+
+    float _cellSize;
+    float _inverseCellSize;
+    std::vector<Entry> _entries;                                // 句柄 -> 矩形
+    std::vector<int> _freeHandles;                              // 可以重新使用的句柄
+    std::unordered_map<uint64_t, std::vector<Item>> _cells;     // 格子坐标 -> 登记在这个格子里的矩形
+    int _count;
+
+    static uint64_t cellKey(int cellX, int cellY);
+    int cellCoordinate(float value) const;
+    void setRect(Entry& entry, float minX, float minY, float maxX, float maxY);
+    void addToCells(const Entry& entry);
+    void removeFromCells(const Entry& entry);
+    void refreshCells(const Entry& entry);
+};
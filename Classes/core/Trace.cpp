@@ -0,0 +1,200 @@
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+const int Trace::kBufferEvents;
+
+namespace {
+
+/**
+ * 环形缓冲区里的一条记录
+ * 每个字段都是原子变量（relaxed读写和普通读写一样快），导出线程读的时候不算数据竞争；
+ * sequence是这条记录的序号锁：写的时候是奇数，写完是2*(第几条+1)，读前读后各看一次，变了就丢掉
+ */
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{ 0 };
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<uint64_t> time{ 0 };        // ZONE：开始时间；COUNTER：记录时间
+    std::atomic<int64_t> value{ 0 };        // ZONE：耗时；COUNTER：值
+    std::atomic<uint8_t> type{ 0 };
+};
+
+/**
+ * 一个线程的缓冲区（线程退出后也保留，导出时仍然能看到它的记录）
+ */
+struct TraceBuffer {
+    std::unique_ptr<TraceSlot[]> slots{ new TraceSlot[Trace::kBufferEvents] };
+    std::atomic<uint64_t> head{ 0 };            // 一共写过的条数
+    std::atomic<uint64_t> clearedAt{ 0 };       // clear()时的head，之前的记录不再导出
+    std::atomic<const char*> threadName{ nullptr };
+    int threadIndex = 0;
+};
+
+/**
+ * 导出时拷贝出来的记录
+ */
+struct TraceRecord {
+    const char* name;
+    uint64_t time;
+    int64_t value;
+    TraceEventType type;
+};
+
+std::mutex g_buffersMutex;
+std::vector<std::unique_ptr<TraceBuffer>> g_buffers;
+thread_local TraceBuffer* t_buffer = nullptr;
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+/**
+ * 当前线程的缓冲区（第一次调用时分配并登记，之后不加锁）
+ */
+TraceBuffer* getThreadBuffer() {
+    if (!t_buffer) {
+        std::unique_ptr<TraceBuffer> buffer(new TraceBuffer());
+        std::lock_guard<std::mutex> lock(g_buffersMutex);
+        buffer->threadIndex = (int)g_buffers.size();
+        t_buffer = buffer.get();
+        g_buffers.push_back(std::move(buffer));
+    }
+    return t_buffer;
+}
+
+void writeEvent(TraceEventType type, const char* name, uint64_t time, int64_t value) {
+    TraceBuffer* buffer = getThreadBuffer();
+    uint64_t index = buffer->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = buffer->slots[index & (Trace::kBufferEvents - 1)];
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.time.store(time, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.type.store((uint8_t)type, std::memory_order_relaxed);
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * 拷贝一个缓冲区里还没被覆盖的记录
+ */
+void copyEvents(const TraceBuffer& buffer, std::vector<TraceRecord>& records) {
+    uint64_t head = buffer.head.load(std::memory_order_acquire);
+    uint64_t first = head > (uint64_t)Trace::kBufferEvents ? head - Trace::kBufferEvents : 0;
+    uint64_t clearedAt = buffer.clearedAt.load(std::memory_order_relaxed);
+    if (first < clearedAt) first = clearedAt;
+
+    for (uint64_t index = first; index < head; index++) {
+        const TraceSlot& slot = buffer.slots[index & (Trace::kBufferEvents - 1)];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != index * 2 + 2) continue;  // 已经被覆盖或者正在被覆盖
+        TraceRecord record;
+        record.name = slot.name.load(std::memory_order_relaxed);
+        record.time = slot.time.load(std::memory_order_relaxed);
+        record.value = slot.value.load(std::memory_order_relaxed);
+        record.type = (TraceEventType)slot.type.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) continue;
+        records.push_back(record);
+    }
+}
+
+/**
+ * 写JSON字符串（名字是代码里的常量，只需要转义引号、反斜杠和控制字符）
+ */
+void writeJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* p = text ? text : ""; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if (c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+}  // namespace
+
+uint64_t Trace::now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+void Trace::zone(const char* name, uint64_t startNs, uint64_t durationNs) {
+    writeEvent(TraceEventType::ZONE, name, startNs, (int64_t)durationNs);
+}
+
+void Trace::counter(const char* name, int64_t value) {
+    writeEvent(TraceEventType::COUNTER, name, now(), value);
+}
+
+void Trace::setThreadName(const char* name) {
+    getThreadBuffer()->threadName.store(name, std::memory_order_relaxed);
+}
+
+/**
+ * Chrome追踪格式：一段代码是"X"（完整事件，开始时间+耗时），计数器是"C"，线程名是"M"（元数据）
+ * 时间单位是微秒；一段代码按结束时间判断是否在最近lastSeconds秒内
+ */
+int Trace::exportChromeJson(const std::string& path, double lastSeconds) {
+    uint64_t exportTime = now();
+    uint64_t cutoff = 0;
+    if (lastSeconds > 0 && exportTime > (uint64_t)(lastSeconds * 1e9)) {
+        cutoff = exportTime - (uint64_t)(lastSeconds * 1e9);
+    }
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return -1;
+
+    std::vector<TraceRecord> records;
+    int exported = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    for (const auto& buffer : g_buffers) {
+        const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+        if (threadName) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",\n", buffer->threadIndex);
+            writeJsonString(file, threadName);
+            fprintf(file, "}}");
+            first = false;
+        }
+
+        records.clear();
+        copyEvents(*buffer, records);
+        for (const auto& record : records) {
+            bool isZone = record.type == TraceEventType::ZONE;
+            uint64_t endTime = isZone ? record.time + (uint64_t)record.value : record.time;
+            if (endTime < cutoff) continue;
+            fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+            writeJsonString(file, record.name);
+            if (isZone) {
+                fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadIndex,
+                        record.time / 1000.0, record.value / 1000.0);
+            } else {
+                fprintf(file, ",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                        buffer->threadIndex, record.time / 1000.0, (long long)record.value);
+            }
+            first = false;
+            exported++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = fclose(file) == 0;
+    return ok ? exported : -1;
+}
+
+void Trace::clear() {
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    for (const auto& buffer : g_buffers) {
+        buffer->clearedAt.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * 性能追踪（不依赖cocos2d）
+ *
+ * 在热点路径上放追踪点，记录每段代码的开始时间和耗时、计数器的值，导出成Chrome追踪格式
+ * （chrome://tracing或者https://ui.perfetto.dev打开），看一帧的时间花在点击、模型修改、布局、动画回调、绘制的哪一段。
+ *
+ * 编译开关CARDGAME_TRACE（默认0）：
+ * - 0：TRACE_ZONE、TRACE_COUNTER展开成空语句，不产生任何代码
+ * - 1：每个线程第一次记录时分配自己的环形缓冲区（kBufferEvents条），之后记录只写自己的缓冲区，不加锁、不分配内存；
+ *      缓冲区写满后覆盖最旧的记录，所以随时可以导出最近一段时间
+ *
+ * 使用示例：
+ * void StackView::layoutCards() {
+ *     TRACE_ZONE("StackView::layoutCards");      // 到作用域结束为止的耗时
+ *     ...
+ *     TRACE_COUNTER("stack.cards", _cards.size());
+ * }
+ * Trace::exportChromeJson(path, 5.0);             // 导出最近5秒
+ *
+ * 注意：名字只保存指针，必须是字符串常量（或者生命周期和程序一样长的字符串）。
+ */
+#ifndef CARDGAME_TRACE
+#define CARDGAME_TRACE 0
+#endif
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if CARDGAME_TRACE
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) Trace::counter(name, (int64_t)(value))
+#define TRACE_THREAD_NAME(name) Trace::setThreadName(name)
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+/**
+ * 一条记录的类型
+ */
+enum class TraceEventType : uint8_t {
+    ZONE = 0,       // 一段代码：开始时间 + 耗时
+    COUNTER = 1,    // 计数器：时间 + 值
+};
+
+/**
+ * @brief Trace - 追踪记录和导出
+ *
+ * 每个线程一个单写者环形缓冲区：写入时先写记录，再用release语义推进写位置；
+ * 导出时（任意线程）读写位置、拷贝记录，再读一次写位置，拷贝期间可能被覆盖的记录丢掉，
+ * 所以导出不会阻塞记录，也不会读到写了一半的记录。
+ */
+class Trace {
+public:
+    static const int kBufferEvents = 1 << 16;   // 每个线程的环形缓冲区能放的记录数（2的幂）
+
+    /**
+     * 当前时间（纳秒，从第一次调用算起，单调递增）
+     */
+    static uint64_t now();
+
+    /**
+     * 记录一段代码（TraceZone析构时调用）
+     */
+    static void zone(const char* name, uint64_t startNs, uint64_t durationNs);
+
+    /**
+     * 记录计数器的当前值
+     */
+    static void counter(const char* name, int64_t value);
+
+    /**
+     * 设置当前线程在追踪文件里显示的名字（字符串常量）
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * 导出成Chrome追踪格式（JSON）
+     * @param path 输出文件
+     * @param lastSeconds 只导出最近这么多秒的记录，<=0表示缓冲区里的全部记录
+     * @return 导出的记录数，文件无法创建时返回-1
+     */
+    static int exportChromeJson(const std::string& path, double lastSeconds = 0);
+
+    /**
+     * 丢掉所有线程已经记录的内容（线程缓冲区保留）
+     */
+    static void clear();
+};
+
+/**
+ * @brief TraceZone - 作用域追踪点（一般通过TRACE_ZONE使用）
+ */
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : _name(name), _start(Trace::now()) {}
+    ~TraceZone() { Trace::zone(_name, _start, Trace::now() - _start); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* _name;
+    uint64_t _start;
+};
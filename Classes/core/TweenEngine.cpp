@@ -0,0 +1,208 @@
+#include "TweenEngine.h"
+#include <algorithm>
+#include <utility>
+
+const TweenEngine::TweenId TweenEngine::kInvalidId;
+const int TweenEngine::kMaxTweens;
+
+TweenEngine::TweenEngine(ApplyFunc apply, int capacity)
+    : _apply(apply), _count(0) {
+    capacity = std::max(1, std::min(capacity, kMaxTweens));
+    _slotIndex.reserve(capacity);
+    _slotVersion.reserve(capacity);
+    _freeSlots.reserve(capacity);
+    _finished.reserve(capacity);
+    while ((int)_slotIndex.size() < capacity) grow();
+}
+
+/**
+ * 增加一个槽位（数组也增加一个位置）
+ */
+void TweenEngine::grow() {
+    int slot = (int)_slotIndex.size();
+    _slotIndex.push_back(-1);
+    _slotVersion.push_back(1);
+    _freeSlots.push_back((uint16_t)slot);
+
+    _targets.push_back(nullptr);
+    _fromX.push_back(0);
+    _fromY.push_back(0);
+    _toX.push_back(0);
+    _toY.push_back(0);
+    _elapsed.push_back(0);
+    _duration.push_back(0);
+    _eases.push_back(TweenEase::LINEAR);
+    _slots.push_back(0);
+    _onComplete.emplace_back();
+}
+
+TweenEngine::TweenId TweenEngine::start(void* target, float fromX, float fromY, float toX, float toY, float duration,
+                                        TweenEase ease, std::function<void()> onComplete) {
+    if (_freeSlots.empty()) {
+        if ((int)_slotIndex.size() >= kMaxTweens) return kInvalidId;
+        // 容量翻倍（之后再也不用分配）
+        int newCapacity = std::min((int)_slotIndex.size() * 2, kMaxTweens);
+        while ((int)_slotIndex.size() < newCapacity) grow();
+        _finished.reserve(newCapacity);
+    }
+    uint16_t slot = _freeSlots.back();
+    _freeSlots.pop_back();
+
+    int index = _count++;
+    _slotIndex[slot] = index;
+    _slots[index] = slot;
+    _targets[index] = target;
+    _fromX[index] = fromX;
+    _fromY[index] = fromY;
+    _toX[index] = toX;
+    _toY[index] = toY;
+    _elapsed[index] = 0;
+    _duration[index] = duration;
+    _eases[index] = ease;
+    _onComplete[index] = std::move(onComplete);
+
+    _apply(target, fromX, fromY);
+    return ((TweenId)_slotVersion[slot] << 16) | slot;
+}
+
+bool TweenEngine::retarget(TweenId id, float toX, float toY, float duration) {
+    int index = findIndex(id);
+    if (index < 0) return false;
+    float x, y;
+    currentPosition(index, x, y);
+    _fromX[index] = x;
+    _fromY[index] = y;
+    _toX[index] = toX;
+    _toY[index] = toY;
+    _elapsed[index] = 0;
+    _duration[index] = duration;
+    return true;
+}
+
+bool TweenEngine::swapOnComplete(TweenId id, std::function<void()>& onComplete) {
+    int index = findIndex(id);
+    if (index < 0) return false;
+    _onComplete[index].swap(onComplete);
+    return true;
+}
+
+bool TweenEngine::cancel(TweenId id) {
+    int index = findIndex(id);
+    if (index < 0) return false;
+    removeAt(index);
+    return true;
+}
+
+bool TweenEngine::complete(TweenId id) {
+    int index = findIndex(id);
+    if (index < 0) return false;
+    _apply(_targets[index], _toX[index], _toY[index]);
+    std::function<void()> callback = std::move(_onComplete[index]);
+    removeAt(index);
+    if (callback) callback();
+    return true;
+}
+
+bool TweenEngine::getTarget(TweenId id, float& x, float& y) const {
+    int index = findIndex(id);
+    if (index < 0) return false;
+    x = _toX[index];
+    y = _toY[index];
+    return true;
+}
+
+void TweenEngine::update(float dt) {
+    // 到终点的补间用最后一个补上，补上来的这一帧还没有更新，所以下标不前进
+    int index = 0;
+    while (index < _count) {
+        float elapsed = _elapsed[index] + dt;
+        float duration = _duration[index];
+        bool done = elapsed >= duration;
+        float k = done ? 1.0f : ease(_eases[index], elapsed / duration);
+        _elapsed[index] = elapsed;
+        _apply(_targets[index],
+               _fromX[index] + (_toX[index] - _fromX[index]) * k,
+               _fromY[index] + (_toY[index] - _fromY[index]) * k);
+        if (done) {
+            if (_onComplete[index]) {
+                _finished.push_back(std::move(_onComplete[index]));
+            }
+            removeAt(index);
+        } else {
+            ++index;
+        }
+    }
+
+    // 回调里可能开始新的补间（不会进入这次的_finished）
+    for (size_t i = 0; i < _finished.size(); ++i) {
+        std::function<void()> callback = std::move(_finished[i]);
+        callback();
+    }
+    _finished.clear();
+}
+
+void TweenEngine::clear() {
+    while (_count > 0) removeAt(_count - 1);
+}
+
+float TweenEngine::ease(TweenEase ease, float t) {
+    switch (ease) {
+        case TweenEase::QUAD_OUT:
+            return t * (2 - t);
+        case TweenEase::CUBIC_OUT: {
+            float u = 1 - t;
+            return 1 - u * u * u;
+        }
+        case TweenEase::QUAD_IN_OUT:
+            return t < 0.5f ? 2 * t * t : 1 - 2 * (1 - t) * (1 - t);
+        case TweenEase::BACK_OUT: {
+            const float s = 1.70158f;
+            float u = t - 1;
+            return 1 + u * u * ((s + 1) * u + s);
+        }
+        case TweenEase::LINEAR:
+        default:
+            return t;
+    }
+}
+
+int TweenEngine::findIndex(TweenId id) const {
+    uint16_t slot = (uint16_t)(id & 0xFFFF);
+    uint16_t version = (uint16_t)(id >> 16);
+    if (version == 0 || slot >= _slotIndex.size() || _slotVersion[slot] != version) return -1;
+    return _slotIndex[slot];
+}
+
+void TweenEngine::currentPosition(int index, float& x, float& y) const {
+    float duration = _duration[index];
+    float k = _elapsed[index] >= duration ? 1.0f : ease(_eases[index], _elapsed[index] / duration);
+    x = _fromX[index] + (_toX[index] - _fromX[index]) * k;
+    y = _fromY[index] + (_toY[index] - _fromY[index]) * k;
+}
+
+/**
+ * 移除一个补间：释放槽位（版本号加一，旧ID失效），最后一个补间搬到这个位置
+ */
+void TweenEngine::removeAt(int index) {
+    uint16_t slot = _slots[index];
+    _slotIndex[slot] = -1;
+    if (++_slotVersion[slot] == 0) _slotVersion[slot] = 1;
+    _freeSlots.push_back(slot);
+
+    int last = --_count;
+    if (index != last) {
+        _slots[index] = _slots[last];
+        _targets[index] = _targets[last];
+        _fromX[index] = _fromX[last];
+        _fromY[index] = _fromY[last];
+        _toX[index] = _toX[last];
+        _toY[index] = _toY[last];
+        _elapsed[index] = _elapsed[last];
+        _duration[index] = _duration[last];
+        _eases[index] = _eases[last];
+        _onComplete[index] = std::move(_onComplete[last]);
+        _slotIndex[_slots[index]] = index;
+    }
+    _onComplete[last] = nullptr;
+    _targets[last] = nullptr;
+}
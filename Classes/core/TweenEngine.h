@@ -0,0 +1,145 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * 缓动曲线：把时间进度t（0~1）映射成位置进度
+ */
+enum class TweenEase : uint8_t {
+    LINEAR = 0,         // 匀速（和MoveTo一样）
+    QUAD_OUT = 1,       // 先快后慢
+    CUBIC_OUT = 2,      // 先快后慢（更明显）
+    QUAD_IN_OUT = 3,    // 慢-快-慢
+    BACK_OUT = 4,       // 稍微冲过目标再回来
+};
+
+/**
+ * @brief TweenEngine - 位置补间动画（不依赖cocos2d）
+ *
+ * 代替每次移动都创建MoveTo + CallFunc + Sequence：所有正在播放的补间按字段分开存放（结构数组），
+ * 紧凑地放在前getActiveCount()个位置，每帧update()一个循环更新完，通过apply函数写回目标的位置。
+ *
+ * - 不自己计时：update(dt)由调用者驱动（游戏里由Scheduler每帧调用，测试和无界面工具里可以手动推进）
+ * - 容量预先分配，开始、重定向、取消都不分配内存（超过容量时才扩容一次）；
+ *   完成回调是std::function，捕获的内容超过它的内部缓冲区时由std::function自己分配
+ * - 补间用TweenId引用，补间结束或取消后旧的ID失效（槽位带版本号），不会误操作后来复用这个槽位的补间
+ *
+ * 使用示例：
+ * TweenEngine engine([](void* target, float x, float y) { ((Node*)target)->setPosition(x, y); });
+ * TweenId id = engine.start(node, 0, 0, 100, 200, 0.3f, TweenEase::QUAD_OUT, [] { ... });
+ * engine.retarget(id, 300, 200, 0.3f);   // 从当前位置改去新的目标
+ * engine.update(1.0f / 60);              // 每帧
+ */
+class TweenEngine {
+public:
+    typedef uint32_t TweenId;               // 低16位是槽位，高16位是版本号（不为0）
+    static const TweenId kInvalidId = 0;
+
+    /**
+     * 把补间算出的位置写回目标（update期间调用，不能在里面调用TweenEngine的方法）
+     */
+    typedef void (*ApplyFunc)(void* target, float x, float y);
+
+    /**
+     * @param apply 写回位置的函数
+     * @param capacity 预先分配的补间数量
+     */
+    explicit TweenEngine(ApplyFunc apply, int capacity = 64);
+
+    /**
+     * 开始一个补间（马上写一次起点位置）
+     * @param target 目标（传给apply函数）
+     * @param duration 时长（秒），<=0时下一次update直接到终点
+     * @param onComplete 播放到终点后调用（取消时不调用）
+     * @return 补间ID
+     */
+    TweenId start(void* target, float fromX, float fromY, float toX, float toY, float duration,
+                  TweenEase ease = TweenEase::LINEAR, std::function<void()> onComplete = nullptr);
+
+    /**
+     * 把正在播放的补间改去新的目标：从当前位置出发，重新计时，曲线和完成回调不变
+     * @return false=补间已经结束或取消（ID失效）
+     */
+    bool retarget(TweenId id, float toX, float toY, float duration);
+
+    /**
+     * 交换补间的完成回调：调用后onComplete里是原来的回调
+     * @return false=补间已经结束或取消（onComplete不变）
+     */
+    bool swapOnComplete(TweenId id, std::function<void()>& onComplete);
+
+    /**
+     * 取消补间：停在当前位置，不调用完成回调
+     * @return false=补间已经结束或取消
+     */
+    bool cancel(TweenId id);
+
+    /**
+     * 立即完成补间：跳到终点并调用完成回调
+     * @return false=补间已经结束或取消
+     */
+    bool complete(TweenId id);
+
+    /**
+     * 补间是否还在播放
+     */
+    bool isActive(TweenId id) const { return findIndex(id) >= 0; }
+
+    /**
+     * 取得补间的终点
+     * @return false=补间已经结束或取消
+     */
+    bool getTarget(TweenId id, float& x, float& y) const;
+
+    /**
+     * 推进所有补间dt秒，写回位置；到终点的补间移除后再依次调用完成回调
+     * （回调里可以开始、取消其他补间）
+     */
+    void update(float dt);
+
+    /**
+     * 取消所有补间（不调用完成回调）
+     */
+    void clear();
+
+    /**
+     * 正在播放的补间数
+     */
+    int getActiveCount() const { return _count; }
+
+    /**
+     * 缓动曲线在t（0~1）处的值
+     */
+    static float ease(TweenEase ease, float t);
+
+private:
+    static const int kMaxTweens = 0xFFFF;
+
+    ApplyFunc _apply;
+    int _count;
+
+    // 正在播放的补间，下标0~_count-1，移除时用最后一个补上
+    std::vector<void*> _targets;
+    std::vector<float> _fromX;
+    std::vector<float> _fromY;
+    std::vector<float> _toX;
+    std::vector<float> _toY;
+    std::vector<float> _elapsed;
+    std::vector<float> _duration;
+    std::vector<TweenEase> _eases;
+    std::vector<uint16_t> _slots;                       // 下标 -> 槽位
+    std::vector<std::function<void()>> _onComplete;
+
+    // 槽位（ID引用的是槽位，补间在数组里的位置会因为移除而变化）
+    std::vector<int> _slotIndex;                        // 槽位 -> 下标，-1表示空闲
+    std::vector<uint16_t> _slotVersion;
+    std::vector<uint16_t> _freeSlots;
+
+    std::vector<std::function<void()>> _finished;       // update里到终点的回调（复用）
+
+    int findIndex(TweenId id) const;
+    void grow();
+    void currentPosition(int index, float& x, float& y) const;
+    void removeAt(int index);
+};
@@ -0,0 +1,111 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : _threadCount(threadCount > 0 ? threadCount : getHardwareThreads()),
+      _job(nullptr), _round(0), _busyWorkers(0), _stopping(false) {
+    for (int i = 0; i < _threadCount; i++) {
+        _queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+    // 0号工作线程是调用run()的线程，这里只创建其余的后台线程
+    for (int i = 1; i < _threadCount; i++) {
+        _threads.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _startCondition.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+int WorkStealingPool::getHardwareThreads() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? (int)count : 1;
+}
+
+void WorkStealingPool::run(int count, const std::function<void(int, int)>& job) {
+    if (count <= 0) return;
+
+    for (int i = 0; i < count; i++) {
+        _queues[i % _threadCount]->tasks.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _busyWorkers = _threadCount - 1;
+        _round++;
+    }
+    _startCondition.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this]() { return _busyWorkers == 0; });
+    _job = nullptr;
+}
+
+/**
+ * 后台线程：等待新的一轮，做完所有能拿到的任务后报告完成
+ */
+void WorkStealingPool::workerLoop(int workerIndex) {
+    unsigned seenRound = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCondition.wait(lock, [&]() { return _stopping || _round != seenRound; });
+            if (_stopping) return;
+            seenRound = _round;
+        }
+
+        drain(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busyWorkers--;
+        }
+        _doneCondition.notify_one();
+    }
+}
+
+/**
+ * 一直取任务执行，直到所有队列都空
+ * run()期间不会再添加任务，所以一次找不到任务就说明这一轮的任务都被领走了
+ */
+void WorkStealingPool::drain(int workerIndex) {
+    int task = 0;
+    while (popTask(workerIndex, task)) {
+        (*_job)(task, workerIndex);
+    }
+}
+
+/**
+ * 先从自己队列的前面取，取不到再从其他线程队列的后面偷
+ */
+bool WorkStealingPool::popTask(int workerIndex, int& task) {
+    {
+        WorkQueue& own = *_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (int i = 1; i < _threadCount; i++) {
+        WorkQueue& victim = *_queues[(workerIndex + i) % _threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
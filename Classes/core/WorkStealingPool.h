@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief WorkStealingPool - 工作窃取线程池
+ *
+ * 用来并行执行一批编号为0~count-1的任务（求解器、批量生成牌局等）。
+ * 线程在构造时创建，析构时退出，多次run()之间复用。
+ *
+ * 调度方式：
+ * - 任务按编号轮流分给各个线程的队列（任务i -> 线程i % N）
+ * - 每个线程从自己队列的前面取任务（编号小的先做）
+ * - 自己的队列空了就从别的线程队列的后面"偷"任务，保证负载不均时所有核都在干活
+ * - 调用run()的线程也作为0号工作线程参与执行
+ *
+ * 使用示例：
+ * WorkStealingPool pool;  // 线程数=CPU核数
+ * pool.run(100, [&](int taskIndex, int workerIndex) {
+ *     results[taskIndex] = solveOne(taskIndex);
+ * });
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @param threadCount 线程数（包括调用run()的线程），<=0表示使用CPU核数
+     */
+    explicit WorkStealingPool(int threadCount = 0);
+    ~WorkStealingPool();
+
+    /**
+     * 执行count个任务，阻塞到全部完成
+     * @param count 任务数量
+     * @param job 任务函数，参数是(任务编号, 工作线程编号)，工作线程编号在0~getThreadCount()-1之间
+     */
+    void run(int count, const std::function<void(int, int)>& job);
+
+    /**
+     * 线程数（包括调用run()的线程）
+     */
+    int getThreadCount() const { return _threadCount; }
+
+    /**
+     * CPU核数（获取不到时返回1）
+     */
+    static int getHardwareThreads();
+
+private:
+    /**
+     * 每个工作线程一个任务队列
+     */
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    int _threadCount;
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _startCondition;  // 通知后台线程开始新的一轮
+    std::condition_variable _doneCondition;   // 后台线程做完这一轮时通知run()
+    const std::function<void(int, int)>* _job;
+    unsigned _round;        // 第几轮run()，后台线程靠它判断有没有新任务
+    int _busyWorkers;       // 这一轮还没做完的后台线程数
+    bool _stopping;
+
+    void workerLoop(int workerIndex);
+    void drain(int workerIndex);
+    bool popTask(int workerIndex, int& task);
+};
@@ -0,0 +1,104 @@
+#include "TexturePreloader.h"
+#include "core/Log.h"
+#include "core/WorkStealingPool.h"
+#include <algorithm>
+
+USING_NS_CC;
+
+TexturePreloader::TexturePreloader(int threadCount) : _threadCount(threadCount) {
+}
+
+TexturePreloader::~TexturePreloader() {
+    if (_state) {
+        _state->cancelled = true;
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+/**
+ * 1. 主线程：路径换成完整路径（FileUtils不是线程安全的），跳过已经加载的和找不到的图片
+ * 2. 后台线程：线程池并行解码，每解码好一张就交回主线程
+ * 3. 主线程：放进TextureCache（上传纹理只能在主线程），更新进度
+ */
+void TexturePreloader::start(const std::vector<std::string>& paths, const std::function<void(int, int)>& onProgress,
+                             const std::function<void()>& onFinished) {
+    if (_state) return;
+    _state = std::make_shared<State>();
+    _state->onProgress = onProgress;
+    _state->onFinished = onFinished;
+
+    auto fileUtils = FileUtils::getInstance();
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (const auto& path : paths) {
+        std::string fullPath = fileUtils->fullPathForFilename(path);
+        if (fullPath.empty() || textureCache->getTextureForKey(fullPath)) continue;
+        if (std::find(_state->fullPaths.begin(), _state->fullPaths.end(), fullPath) != _state->fullPaths.end()) continue;
+        _state->fullPaths.push_back(fullPath);
+    }
+
+    int total = (int)_state->fullPaths.size();
+    if (total == 0) {
+        if (onFinished) onFinished();
+        return;
+    }
+
+    int threadCount = _threadCount > 0 ? _threadCount : WorkStealingPool::getHardwareThreads();
+    if (threadCount > total) threadCount = total;
+
+    std::shared_ptr<State> state = _state;
+    _thread = std::thread([state, threadCount, total]() {
+        WorkStealingPool pool(threadCount);
+        auto scheduler = Director::getInstance()->getScheduler();
+        pool.run(total, [&](int index, int) {
+            if (state->cancelled) return;
+            Image* image = new (std::nothrow) Image();
+            if (image && !image->initWithImageFile(state->fullPaths[index])) {
+                image->release();
+                image = nullptr;
+            }
+            scheduler->performFunctionInCocosThread([state, index, image]() {
+                finishImage(state, index, image);
+            });
+        });
+    });
+}
+
+void TexturePreloader::finishImage(const std::shared_ptr<State>& state, int index, Image* image) {
+    const std::string& fullPath = state->fullPaths[index];
+    if (image) {
+        // 取消之后也放进缓存：已经解码好了，之后用到时不用再解码
+        Director::getInstance()->getTextureCache()->addImage(image, fullPath);
+        image->release();
+    } else {
+        state->failed++;
+        GAME_LOG_WARN("TexturePreloader: cannot decode %s", fullPath.c_str());
+    }
+    state->loaded++;
+    if (state->cancelled) return;
+
+    int total = (int)state->fullPaths.size();
+    if (state->onProgress) {
+        state->onProgress(state->loaded, total);
+    }
+    if (state->loaded == total && state->onFinished) {
+        state->onFinished();
+    }
+}
+
+int TexturePreloader::getLoadedCount() const {
+    return _state ? _state->loaded : 0;
+}
+
+int TexturePreloader::getTotalCount() const {
+    return _state ? (int)_state->fullPaths.size() : 0;
+}
+
+int TexturePreloader::getFailedCount() const {
+    return _state ? _state->failed : 0;
+}
+
+bool TexturePreloader::isFinished() const {
+    return _state && _state->loaded == (int)_state->fullPaths.size();
+}
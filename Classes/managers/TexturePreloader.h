@@ -0,0 +1,85 @@
+#pragma once
+#include "cocos2d.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief TexturePreloader - 多线程预加载纹理
+ *
+ * 在后台线程池（core/WorkStealingPool）里并行读取、解码图片，
+ * 解码好的图片交回主线程（Scheduler::performFunctionInCocosThread）放进TextureCache，
+ * 之后Sprite::create(path)、加载图集时直接命中缓存，主线程不再解码图片。
+ *
+ * 和TextureCache::addImageAsync的区别：addImageAsync只有一个加载线程，这里按CPU核数并行解码；
+ * 放进TextureCache时用的键和addImage(path)一样（完整路径），所以两边可以混用。
+ *
+ * 职责：
+ * - 解析路径、跳过已经在TextureCache里的图片（主线程）
+ * - 并行解码（后台线程），按完成顺序逐张上传（主线程）
+ * - 报告进度，全部完成（包括解码失败的）时通知一次
+ *
+ * 使用示例：
+ * _preloader.start(paths, [](int loaded, int total) { ... }, []() { ... });
+ *
+ * 注意：回调都在主线程调用；预加载器析构时会等后台线程结束，之后到达的回调不再调用。
+ */
+class TexturePreloader {
+public:
+    /**
+     * @param threadCount 解码线程数，<=0表示使用CPU核数
+     */
+    explicit TexturePreloader(int threadCount = 0);
+    ~TexturePreloader();
+
+    /**
+     * 开始预加载（只能调用一次）
+     * @param paths 图片路径（和Sprite::create使用的一样，按搜索路径查找）
+     * @param onProgress 每完成一张图片调用一次，参数是(已完成数, 总数)，可以为空
+     * @param onFinished 全部完成时调用（没有需要加载的图片时立即调用）
+     */
+    void start(const std::vector<std::string>& paths, const std::function<void(int, int)>& onProgress,
+               const std::function<void()>& onFinished);
+
+    /**
+     * 已完成（上传或者解码失败）的图片数
+     */
+    int getLoadedCount() const;
+
+    /**
+     * 需要加载的图片数（已经在TextureCache里的不算）
+     */
+    int getTotalCount() const;
+
+    /**
+     * 解码失败的图片数
+     */
+    int getFailedCount() const;
+
+    bool isFinished() const;
+
+private:
+    /**
+     * 后台线程和主线程回调共享的状态（预加载器析构后，还没执行的回调仍然可能持有它）
+     */
+    struct State {
+        std::vector<std::string> fullPaths;
+        std::function<void(int, int)> onProgress;
+        std::function<void()> onFinished;
+        int loaded = 0;             // 主线程读写
+        int failed = 0;             // 主线程读写
+        std::atomic<bool> cancelled{ false };
+    };
+
+    int _threadCount;
+    std::shared_ptr<State> _state;
+    std::thread _thread;            // 执行线程池的后台线程
+
+    /**
+     * 主线程：一张图片完成（image为nullptr表示解码失败）
+     */
+    static void finishImage(const std::shared_ptr<State>& state, int index, cocos2d::Image* image);
+};
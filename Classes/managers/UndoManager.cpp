@@ -1,48 +1,145 @@
 #include "UndoManager.h"
+#include "core/Trace.h"
+
+UndoManager::UndoManager(int capacity) : _first(0), _position(0), _end(0) {
+    setCapacity(capacity);
+}
+
+/**
+ * 修改容量
+ * 缓冲区只在这里分配，之后的操作不会再分配内存
+ * 检查点的数量要能覆盖所有保存着的记录，再多留两个给首尾
+ */
+void UndoManager::setCapacity(int capacity) {
+    if (capacity < 1) capacity = 1;
+    _records.assign(capacity, UndoDelta());
+    _checkpoints.assign(capacity / kCheckpointInterval + 2, Checkpoint());
+    clear();
+}
 
 /**
  * 记录一次操作
- * 把操作记录压入栈中，就像把一张纸放到一摞纸的最上面
+ * 1. 当前位置之后的记录作废，这些位置上的检查点也作废（它们属于被丢弃的那条分支）
+ * 2. 写到当前位置，位置+1
+ * 3. 超出容量时，最旧的记录被覆盖
  */
-void UndoManager::push(const UndoRecord& record) {
-    _undoStack.push(record);
+void UndoManager::push(const UndoDelta& delta) {
+    TRACE_ZONE("UndoManager::push");
+    for (int p = _position - _position % kCheckpointInterval + kCheckpointInterval; p <= _end; p += kCheckpointInterval) {
+        Checkpoint& checkpoint = checkpointSlot(p);
+        if (checkpoint.position == p) {
+            checkpoint.position = -1;
+        }
+    }
+
+    _records[_position % _records.size()] = delta;
+    _position++;
+    _end = _position;
+    if (_end - _first > (int)_records.size()) {
+        _first = _end - (int)_records.size();
+    }
 }
 
 /**
  * 检查是否可以回退
- * 如果栈不为空，说明还有记录可以回退
+ * 当前位置之前还有记录就可以回退
  */
 bool UndoManager::canUndo() const {
-    return !_undoStack.empty();  // 栈不为空就可以回退
+    return _position > _first;
 }
 
 /**
  * 执行一次回退
- * 从栈顶取出（弹出）一条记录，这就是最近的一次操作
- * 返回这条记录，让调用者根据记录恢复状态
+ * 最近的一条记录就在当前位置的前一格，位置-1，记录保留给重做用
  */
-UndoRecord UndoManager::undo() {
-    if (_undoStack.empty()) {
-        // 栈为空，没有记录可以回退，返回一个无效记录
-        UndoRecord empty;
-        empty.cardId = -1;
-        return empty;
+UndoDelta UndoManager::undo() {
+    TRACE_ZONE("UndoManager::undo");
+    if (!canUndo()) {
+        // 没有记录可以回退，返回一个无效记录
+        return UndoDelta();
     }
-    
-    // 获取栈顶的记录（最近的操作）
-    UndoRecord record = _undoStack.top();
-    // 从栈中移除这条记录
-    _undoStack.pop();
-    return record;
+    _position--;
+    return getDelta(_position);
+}
+
+/**
+ * 执行一次重做
+ * 当前位置上的记录就是下一步，位置+1
+ */
+UndoDelta UndoManager::redo() {
+    TRACE_ZONE("UndoManager::redo");
+    if (!canRedo()) {
+        return UndoDelta();
+    }
+    UndoDelta delta = getDelta(_position);
+    _position++;
+    return delta;
 }
 
 /**
  * 清空所有历史记录
- * 把栈中的所有记录都弹出，直到栈为空
+ * 只重置位置和检查点标记，缓冲区保留
  */
 void UndoManager::clear() {
-    while (!_undoStack.empty()) {
-        _undoStack.pop();  // 不断弹出，直到栈为空
+    _first = 0;
+    _position = 0;
+    _end = 0;
+    for (auto& checkpoint : _checkpoints) {
+        checkpoint.position = -1;
     }
 }
 
+void UndoManager::setPosition(int position) {
+    if (position < _first) position = _first;
+    if (position > _end) position = _end;
+    _position = position;
+}
+
+bool UndoManager::needsCheckpoint() const {
+    if (_position % kCheckpointInterval != 0) return false;
+    return checkpointSlot(_position).position != _position;
+}
+
+void UndoManager::saveCheckpoint(const PackedGameState& state) {
+    TRACE_ZONE("UndoManager::saveCheckpoint");
+    Checkpoint& checkpoint = checkpointSlot(_position);
+    checkpoint.position = _position;
+    checkpoint.packed = true;
+    checkpoint.state = state;
+}
+
+/**
+ * 保存完整检查点：拷贝两个区域的数组（槽位里的数组保留容量，之后再保存到这个槽位不分配内存）
+ */
+void UndoManager::saveCheckpoint(const GameModel& model) {
+    TRACE_ZONE("UndoManager::saveCheckpoint");
+    Checkpoint& checkpoint = checkpointSlot(_position);
+    checkpoint.position = _position;
+    checkpoint.packed = false;
+    checkpoint.playfieldCards = model.getPlayfieldCards();
+    checkpoint.stackCards = model.getStackCards();
+}
+
+bool UndoManager::hasCheckpoint(int position) const {
+    if (position < 0 || position % kCheckpointInterval != 0) return false;
+    return checkpointSlot(position).position == position;
+}
+
+bool UndoManager::findCheckpoint(int position, PackedGameState& state) const {
+    TRACE_ZONE("UndoManager::findCheckpoint");
+    if (position < 0 || position % kCheckpointInterval != 0) return false;
+    const Checkpoint& checkpoint = checkpointSlot(position);
+    if (checkpoint.position != position || !checkpoint.packed) return false;
+    state = checkpoint.state;
+    return true;
+}
+
+bool UndoManager::findCheckpoint(int position, std::vector<CardModel>& playfieldCards, std::vector<CardModel>& stackCards) const {
+    TRACE_ZONE("UndoManager::findCheckpoint");
+    if (!hasCheckpoint(position)) return false;
+    const Checkpoint& checkpoint = checkpointSlot(position);
+    if (checkpoint.packed) return false;
+    playfieldCards = checkpoint.playfieldCards;
+    stackCards = checkpoint.stackCards;
+    return true;
+}
@@ -1,57 +1,183 @@
 #pragma once
 #include "models/UndoModel.h"
-#include <stack>
+#include "models/PackedGameState.h"
+#include <vector>
 
 /**
- * @brief UndoManager - 回退管理器类
- * 
- * 这个类管理所有的回退记录，实现游戏的撤销功能。
- * 它使用栈（stack）数据结构存储操作历史，支持后进先出的回退操作。
- * 
+ * @brief UndoManager - 回退管理器类（操作时间线）
+ *
+ * 这个类管理所有的操作记录，实现游戏的撤销、重做和"跳到第k步"。
+ * 它使用固定容量的环形缓冲区存储操作历史，另外每隔kCheckpointInterval步保存一个局面检查点。
+ *
  * 职责：
- * - 记录每次游戏操作（压入栈）
- * - 提供回退功能（从栈顶弹出记录）
- * - 检查是否可以回退
+ * - 记录每次游戏操作（压入）
+ * - 提供回退、重做功能（移动当前位置，记录不删除）
+ * - 保存和查找检查点，让跳转的代价有上限
  * - 清空所有历史记录
- * 
+ *
  * 使用场景：
  * - 玩家执行操作时记录操作信息
- * - 玩家点击回退按钮时恢复之前的状态
+ * - 玩家点击回退/重做按钮时恢复状态
+ * - 回放、复盘时跳到任意一步（GameLogic::seek）
  * - 重新开始游戏时清空历史记录
- * 
+ *
  * 架构说明：
- * - 使用std::stack存储UndoRecord对象
- * - 栈是"后进先出"（LIFO）的数据结构，符合回退的需求
- * - 例如：操作A -> 操作B -> 操作C，回退时是 C -> B -> A
+ * - 位置是从开局算起的绝对步数：第p步的记录保存在_records[p % 容量]
+ * - 当前位置之前的记录可以回退，之后的记录可以重做；在中间执行新操作会丢弃可以重做的记录
+ * - 记录满了以后，新记录覆盖最旧的记录（最旧的那一步不能再回退），
+ *   所以无尽模式玩得再久，内存也不会增长
+ * - 检查点保存"第p步执行之前"的局面（p是间隔的整数倍），也放在环形缓冲区里；
+ *   跳转时从最近的检查点恢复，再执行/回退不超过kCheckpointInterval步的记录
+ * - 检查点一般是压缩的PackedGameState；卡牌太多（超过64张）无法压缩时保存两个区域的完整数组
+ * - 所有内存在构造/setCapacity时一次分配好，之后的操作都不再分配内存
+ *   （完整检查点的数组在每个槽位第一次保存时分配，之后复用）
+ * - 例如：操作A -> 操作B -> 操作C，回退时是 C -> B -> A，重做时是 A -> B -> C
  */
 class UndoManager {
 public:
+    static const int kDefaultCapacity = 16384;     // 默认最多保存的步数
+    static const int kCheckpointInterval = 64;     // 每隔多少步保存一个检查点
+
+    /**
+     * @param capacity 最多保存的步数（回退深度）
+     */
+    explicit UndoManager(int capacity = kDefaultCapacity);
+
     /**
-     * 记录一次操作
-     * @param record 操作记录，包含所有回退需要的信息
+     * 修改最多保存的步数
+     * 注意：会清空已有记录并重新分配内存，只在开局前调用
      */
-    void push(const UndoRecord& record);
-    
+    void setCapacity(int capacity);
+
+    /**
+     * 最多保存的步数
+     */
+    int getCapacity() const { return (int)_records.size(); }
+
+    /**
+     * 当前可以回退的步数
+     */
+    int size() const { return _position - _first; }
+
+    /**
+     * 记录一次操作（O(1)）
+     * 当前位置之后的记录（可以重做的）会被丢弃；记录满了时覆盖最旧的一条
+     * @param delta 操作记录
+     */
+    void push(const UndoDelta& delta);
+
     /**
      * 检查是否可以回退
      * @return true=有记录可以回退, false=没有记录了
      */
     bool canUndo() const;
-    
+
     /**
-     * 执行一次回退
-     * @return 返回要回退的操作记录
-     * 注意：调用这个方法会从栈中移除一条记录
+     * 检查是否可以重做
      */
-    UndoRecord undo();
-    
+    bool canRedo() const { return _position < _end; }
+
+    /**
+     * 执行一次回退（O(1)）
+     * @return 返回要回退的操作记录，没有记录时返回无效记录（isValid()==false）
+     * 注意：记录不会被删除，之后可以重做
+     */
+    UndoDelta undo();
+
     /**
-     * 清空所有历史记录
-     * 重新开始游戏时调用
+     * 执行一次重做（O(1)）
+     * @return 返回要重新执行的操作记录，没有时返回无效记录
+     */
+    UndoDelta redo();
+
+    /**
+     * 清空所有历史记录和检查点
+     * 重新开始游戏时调用（不释放内存）
      */
     void clear();
 
+    /**
+     * 当前位置（已经执行的步数）
+     */
+    int getPosition() const { return _position; }
+
+    /**
+     * 最早能回到的位置（更早的记录已经被覆盖）
+     */
+    int getFirstPosition() const { return _first; }
+
+    /**
+     * 最后能重做到的位置
+     */
+    int getEndPosition() const { return _end; }
+
+    /**
+     * 第position步的记录（position在[getFirstPosition(), getEndPosition())范围内）
+     */
+    const UndoDelta& getDelta(int position) const { return _records[position % _records.size()]; }
+
+    /**
+     * 直接设置当前位置（从检查点恢复模型后使用），不修改记录
+     * @param position 新位置，必须在[getFirstPosition(), getEndPosition()]范围内
+     */
+    void setPosition(int position);
+
+    /**
+     * 当前位置是否需要保存检查点（是间隔的整数倍，并且还没有保存过）
+     */
+    bool needsCheckpoint() const;
+
+    /**
+     * 保存当前位置的检查点
+     * @param state 当前位置的局面（第getPosition()步执行之前）
+     */
+    void saveCheckpoint(const PackedGameState& state);
+
+    /**
+     * 保存当前位置的完整检查点（卡牌太多、无法压缩成PackedGameState时使用）
+     * @param model 当前位置的模型，保存主牌区和底牌堆的完整数组
+     */
+    void saveCheckpoint(const GameModel& model);
+
+    /**
+     * 某个位置是否有检查点（压缩的或完整的）
+     */
+    bool hasCheckpoint(int position) const;
+
+    /**
+     * 查找某个位置的检查点
+     * @param position 位置（必须是kCheckpointInterval的整数倍才可能找到）
+     * @param state 输出：这个位置的局面
+     * @return false=没有这个位置的检查点，或者它是完整检查点
+     */
+    bool findCheckpoint(int position, PackedGameState& state) const;
+
+    /**
+     * 查找某个位置的完整检查点
+     * @param playfieldCards 输出：主牌区的卡牌
+     * @param stackCards 输出：底牌堆的卡牌（最后一张是顶部牌）
+     * @return false=没有这个位置的检查点，或者它是压缩的
+     */
+    bool findCheckpoint(int position, std::vector<CardModel>& playfieldCards, std::vector<CardModel>& stackCards) const;
+
 private:
-    std::stack<UndoRecord> _undoStack;  // 回退记录栈，存储所有的操作记录
-};
+    /**
+     * Checkpoint - 检查点（某个位置的完整局面）
+     */
+    struct Checkpoint {
+        int position = -1;          // 检查点的位置，-1表示空
+        bool packed = true;         // true=局面在state里，false=在两个完整数组里
+        PackedGameState state;      // 这个位置的局面
+        std::vector<CardModel> playfieldCards;  // 完整检查点：主牌区
+        std::vector<CardModel> stackCards;      // 完整检查点：底牌堆
+    };
+
+    std::vector<UndoDelta> _records;        // 操作记录的环形缓冲区
+    std::vector<Checkpoint> _checkpoints;   // 检查点的环形缓冲区
+    int _first;                             // 最早还保存着的记录的位置
+    int _position;                          // 当前位置
+    int _end;                               // 最后一条记录之后的位置
 
+    Checkpoint& checkpointSlot(int position) { return _checkpoints[(position / kCheckpointInterval) % _checkpoints.size()]; }
+    const Checkpoint& checkpointSlot(int position) const { return _checkpoints[(position / kCheckpointInterval) % _checkpoints.size()]; }
+};
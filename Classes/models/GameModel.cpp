@@ -1,5 +1,32 @@
 #include "GameModel.h"
-#include <algorithm>
+
+/**
+ * 无效卡牌（id=-1）
+ * 查找失败时返回它的引用，调用者通过 id == -1 判断是否找到
+ */
+static const CardModel kInvalidCard = { -1, 0, 0, false, 0.0f, 0.0f };
+
+/**
+ * 每个点数可以匹配的相邻点数掩码（预先计算好，下标是点数）
+ * 比如点数2可以和A(1)、3匹配，掩码就是第0位和第2位
+ * A只有2一个邻居，K只有Q一个邻居（不循环）
+ */
+static const uint16_t kFaceMatchMask[14] = {
+    0,                          // 0：无效点数
+    (1 << 1),                   // A：2
+    (1 << 0) | (1 << 2),        // 2：A、3
+    (1 << 1) | (1 << 3),        // 3：2、4
+    (1 << 2) | (1 << 4),        // 4：3、5
+    (1 << 3) | (1 << 5),        // 5：4、6
+    (1 << 4) | (1 << 6),        // 6：5、7
+    (1 << 5) | (1 << 7),        // 7：6、8
+    (1 << 6) | (1 << 8),        // 8：7、9
+    (1 << 7) | (1 << 9),        // 9：8、10
+    (1 << 8) | (1 << 10),       // 10：9、J
+    (1 << 9) | (1 << 11),       // J：10、Q
+    (1 << 10) | (1 << 12),      // Q：J、K
+    (1 << 11)                   // K：Q
+};
 
 /**
  * 获取下一个卡牌ID
@@ -7,15 +34,33 @@
  * 比如第一次调用返回0，第二次返回1，以此类推
  */
 int GameModel::getNextCardId() {
-    return nextCardId++;  // 先返回当前值，然后+1
+    return _nextCardId++;  // 先返回当前值，然后+1
 }
 
 /**
  * 添加卡牌到主牌区
- * 使用vector的push_back方法，把卡牌添加到数组末尾
+ * 卡牌放到主牌区数组末尾，并在索引表中记录它的下标
+ * 如果这张卡牌已经在某个区域里，会先把它从原区域移除，保证索引一致
  */
 void GameModel::addCardToPlayfield(const CardModel& card) {
-    playfieldCards.push_back(card);
+    if (card.id < 0) return;
+
+    // 先拷贝一份：card可能就是本模型数组里的元素，移除后引用会失效
+    CardModel copy = card;
+    if (getCardZone(copy.id) == CardZone::PLAYFIELD) {
+        removeCardFromPlayfield(copy.id);
+    } else if (getCardZone(copy.id) == CardZone::STACK) {
+        removeCardFromStack(copy.id);
+    }
+
+    CardSlot& slot = ensureSlot(copy.id);
+    slot.zone = CardZone::PLAYFIELD;
+    slot.placed = true;
+    slot.posX = copy.posX;
+    slot.posY = copy.posY;
+    slot.index = (int)_playfieldCards.size();
+    _playfieldCards.push_back(copy);
+    countPlayfieldFace(copy.face, 1);
 }
 
 /**
@@ -23,55 +68,197 @@ void GameModel::addCardToPlayfield(const CardModel& card) {
  * 新添加的卡牌会放在最后，成为顶部牌（因为顶部牌是vector的最后一个元素）
  */
 void GameModel::addCardToStack(const CardModel& card) {
-    stackCards.push_back(card);
+    if (card.id < 0) return;
+
+    CardModel copy = card;
+    if (getCardZone(copy.id) == CardZone::PLAYFIELD) {
+        removeCardFromPlayfield(copy.id);
+    } else if (getCardZone(copy.id) == CardZone::STACK) {
+        removeCardFromStack(copy.id);
+    }
+
+    CardSlot& slot = ensureSlot(copy.id);
+    slot.zone = CardZone::STACK;
+    slot.placed = true;
+    slot.posX = copy.posX;
+    slot.posY = copy.posY;
+    slot.index = (int)_stackCards.size();
+    _stackCards.push_back(copy);
 }
 
 /**
  * 根据ID查找卡牌
- * 先在主牌区找，找不到再在底牌堆找
- * 如果都找不到，返回一个id=-1的空卡牌表示没找到
- */
-CardModel GameModel::getCardById(int cardId) const {
-    // 在主牌区查找：遍历主牌区的所有卡牌
-    for (const auto& card : playfieldCards) {
-        if (card.id == cardId) {
-            return card;  // 找到了，返回这张卡牌
-        }
+ * 通过索引表直接定位到卡牌所在区域的下标，不需要遍历
+ * 如果找不到，返回一个id=-1的空卡牌表示没找到
+ */
+const CardModel& GameModel::getCardById(int cardId) const {
+    const CardSlot* slot = getSlot(cardId);
+    if (!slot) return kInvalidCard;
+
+    if (slot->zone == CardZone::PLAYFIELD) {
+        return _playfieldCards[slot->index];
     }
-    // 在底牌堆查找：遍历底牌堆的所有卡牌
-    for (const auto& card : stackCards) {
-        if (card.id == cardId) {
-            return card;  // 找到了，返回这张卡牌
-        }
+    if (slot->zone == CardZone::STACK) {
+        return _stackCards[slot->index];
     }
-    // 未找到，返回空卡牌（id=-1表示无效）
-    CardModel empty;
-    empty.id = -1;
-    return empty;
+    return kInvalidCard;  // 卡牌已经不在任何区域
+}
+
+/**
+ * 根据ID查找卡牌，返回可修改的指针
+ */
+CardModel* GameModel::findCard(int cardId) {
+    const CardModel& card = getCardById(cardId);
+    if (card.id == -1) return nullptr;
+    return const_cast<CardModel*>(&card);
+}
+
+/**
+ * 获取卡牌的句柄
+ * 句柄记录了当前的代数，卡牌之后被移除的话句柄就会失效
+ */
+CardHandle GameModel::getHandle(int cardId) const {
+    CardHandle handle;
+    const CardSlot* slot = getSlot(cardId);
+    if (slot && slot->zone != CardZone::NONE) {
+        handle.id = cardId;
+        handle.generation = slot->generation;
+    }
+    return handle;
+}
+
+/**
+ * 通过句柄获取卡牌
+ * 代数不一致说明卡牌在拿到句柄之后被移除过，返回nullptr
+ */
+const CardModel* GameModel::resolve(const CardHandle& handle) const {
+    const CardSlot* slot = getSlot(handle.id);
+    if (!slot || slot->generation != handle.generation) return nullptr;
+
+    const CardModel& card = getCardById(handle.id);
+    return card.id == -1 ? nullptr : &card;
+}
+
+/**
+ * 查询卡牌所在的区域
+ */
+CardZone GameModel::getCardZone(int cardId) const {
+    const CardSlot* slot = getSlot(cardId);
+    return slot ? slot->zone : CardZone::NONE;
+}
+
+/**
+ * 查询卡牌最后一次在模型中时的坐标
+ */
+bool GameModel::getLastPosition(int cardId, float& posX, float& posY) const {
+    const CardSlot* slot = getSlot(cardId);
+    if (!slot || !slot->placed) return false;
+    posX = slot->posX;
+    posY = slot->posY;
+    return true;
+}
+
+void GameModel::rememberPosition(int cardId, float posX, float posY) {
+    if (cardId < 0) return;
+    CardSlot& slot = ensureSlot(cardId);
+    slot.placed = true;
+    slot.posX = posX;
+    slot.posY = posY;
+}
+
+/**
+ * 查询卡牌在底牌堆中的下标
+ */
+int GameModel::getStackIndex(int cardId) const {
+    const CardSlot* slot = getSlot(cardId);
+    if (!slot || slot->zone != CardZone::STACK) return -1;
+    return slot->index;
 }
 
 /**
  * 从主牌区移除卡牌
- * 使用STL的remove_if算法找到要删除的卡牌，然后用erase删除
+ * 把最后一张卡牌挪到被删除的位置，再删掉最后一个元素（swap-and-pop）
+ * 这样不需要移动其他元素，只需要更新被挪动的那张卡牌的下标
  */
 void GameModel::removeCardFromPlayfield(int cardId) {
-    playfieldCards.erase(
-        std::remove_if(playfieldCards.begin(), playfieldCards.end(),
-            [cardId](const CardModel& card) { return card.id == cardId; }),  // lambda表达式：找到id匹配的卡牌
-        playfieldCards.end()
-    );
+    const CardSlot* slot = getSlot(cardId);
+    if (!slot || slot->zone != CardZone::PLAYFIELD) return;
+
+    int index = slot->index;
+    countPlayfieldFace(_playfieldCards[index].face, -1);
+    int lastIndex = (int)_playfieldCards.size() - 1;
+    if (index != lastIndex) {
+        _playfieldCards[index] = _playfieldCards[lastIndex];
+        _slots[_playfieldCards[index].id].index = index;  // 被挪动的卡牌更新下标
+    }
+    _playfieldCards.pop_back();
+    releaseSlot(cardId);
 }
 
 /**
  * 从底牌堆移除卡牌
- * 和上面的方法一样，只是操作的是stackCards数组
+ * 底牌堆是有顺序的，所以要删除元素并把上面的牌往下移
+ * 最常见的情况是移除顶部牌，这时就是一次pop_back
  */
 void GameModel::removeCardFromStack(int cardId) {
-    stackCards.erase(
-        std::remove_if(stackCards.begin(), stackCards.end(),
-            [cardId](const CardModel& card) { return card.id == cardId; }),
-        stackCards.end()
-    );
+    const CardSlot* slot = getSlot(cardId);
+    if (!slot || slot->zone != CardZone::STACK) return;
+
+    int index = slot->index;
+    _stackCards.erase(_stackCards.begin() + index);
+    releaseSlot(cardId);
+    reindexStack(index, (int)_stackCards.size());
+}
+
+/**
+ * 调整卡牌在底牌堆中的位置
+ * 比如换底牌时把备用底牌移到顶部，回退时再移回原来的位置
+ */
+void GameModel::moveStackCard(int cardId, int newIndex) {
+    int oldIndex = getStackIndex(cardId);
+    if (oldIndex < 0) return;
+
+    int lastIndex = (int)_stackCards.size() - 1;
+    if (newIndex < 0 || newIndex > lastIndex) {
+        newIndex = lastIndex;  // 超出范围时放到顶部
+    }
+    if (newIndex == oldIndex) return;
+
+    CardModel temp = _stackCards[oldIndex];
+    _stackCards.erase(_stackCards.begin() + oldIndex);
+    _stackCards.insert(_stackCards.begin() + newIndex, temp);
+
+    // 只有两个下标之间的卡牌位置发生了变化
+    int from = oldIndex < newIndex ? oldIndex : newIndex;
+    int to = oldIndex < newIndex ? newIndex : oldIndex;
+    reindexStack(from, to + 1);
+}
+
+/**
+ * 主牌区是否有能与指定点数匹配的卡牌
+ * 把"邻居点数掩码"和"主牌区点数存在掩码"做与运算，不为0就说明有牌可以匹配
+ */
+bool GameModel::hasPlayfieldMatchFor(int face) const {
+    return (_playfieldFaceMask & getMatchMaskForFace(face)) != 0;
+}
+
+/**
+ * 是否还有可以走的步
+ * 顶部牌能匹配时可以消牌；不能匹配时，只要还有备用底牌就可以换底牌
+ */
+bool GameModel::hasMovesLeft() const {
+    if (_playfieldCards.empty() || _stackCards.empty()) return false;
+    return hasPlayfieldMatchFor(_stackCards.back().face) || _stackCards.size() > 1;
+}
+
+int GameModel::getPlayfieldFaceCount(int face) const {
+    if (face < 1 || face > 13) return 0;
+    return _playfieldFaceCount[face];
+}
+
+uint16_t GameModel::getMatchMaskForFace(int face) {
+    if (face < 1 || face > 13) return 0;
+    return kFaceMatchMask[face];
 }
 
 /**
@@ -79,22 +266,67 @@ void GameModel::removeCardFromStack(int cardId) {
  * 顶部卡牌就是vector的最后一个元素（back()）
  * 如果底牌堆为空，返回id=-1的空卡牌
  */
-CardModel GameModel::getStackTopCard() const {
-    if (stackCards.empty()) {
-        CardModel empty;
-        empty.id = -1;
-        return empty;
+const CardModel& GameModel::getStackTopCard() const {
+    if (_stackCards.empty()) {
+        return kInvalidCard;
     }
-    return stackCards.back();  // back()返回vector的最后一个元素
+    return _stackCards.back();  // back()返回vector的最后一个元素
 }
 
 /**
  * 清空所有数据
  * 清空两个数组，并把ID计数器重置为0
+ * 索引表不删除，只把每一项标记为无效并增加代数，这样旧句柄都会失效
  */
 void GameModel::clear() {
-    playfieldCards.clear();  // 清空主牌区
-    stackCards.clear();      // 清空底牌堆
-    nextCardId = 0;          // 重置ID计数器
+    _playfieldCards.clear();  // 清空主牌区
+    _stackCards.clear();      // 清空底牌堆
+    for (auto& slot : _slots) {
+        if (slot.zone != CardZone::NONE) {
+            slot.zone = CardZone::NONE;
+            slot.index = -1;
+            slot.generation++;
+        }
+        slot.placed = false;
+    }
+    _nextCardId = 0;          // 重置ID计数器
+    for (auto& count : _playfieldFaceCount) {
+        count = 0;            // 清空点数计数
+    }
+    _playfieldFaceMask = 0;
+}
+
+const GameModel::CardSlot* GameModel::getSlot(int cardId) const {
+    if (cardId < 0 || cardId >= (int)_slots.size()) return nullptr;
+    return &_slots[cardId];
 }
 
+GameModel::CardSlot& GameModel::ensureSlot(int cardId) {
+    if (cardId >= (int)_slots.size()) {
+        _slots.resize(cardId + 1);
+    }
+    return _slots[cardId];
+}
+
+void GameModel::releaseSlot(int cardId) {
+    CardSlot& slot = _slots[cardId];
+    slot.zone = CardZone::NONE;
+    slot.index = -1;
+    slot.generation++;
+}
+
+void GameModel::countPlayfieldFace(int face, int delta) {
+    if (face < 1 || face > 13) return;
+    _playfieldFaceCount[face] += delta;
+    if (_playfieldFaceCount[face] > 0) {
+        _playfieldFaceMask |= (uint16_t)(1 << (face - 1));
+    } else {
+        _playfieldFaceMask &= (uint16_t)~(1 << (face - 1));
+    }
+}
+
+void GameModel::reindexStack(int from, int to) {
+    for (int i = from; i < to; i++) {
+        _slots[_stackCards[i].id].index = i;
+    }
+}
@@ -1,73 +1,266 @@
 #pragma once
 #include "CardModel.h"
+#include <cstdint>
 #include <vector>
 
+/**
+ * CardZone - 卡牌所在区域
+ * 用来记录一张卡牌当前在主牌区、底牌堆，还是已经不在游戏中了
+ */
+enum class CardZone : int8_t {
+    NONE,       // 不在任何区域（没创建过，或者已经被移除）
+    PLAYFIELD,  // 主牌区
+    STACK       // 底牌堆
+};
+
+/**
+ * CardHandle - 卡牌句柄（带代数的卡牌引用）
+ *
+ * 句柄 = 卡牌ID + 代数(generation)
+ * 每次卡牌离开所在区域（被移除、清空）时，这张卡牌的代数都会+1，
+ * 所以之前拿到的旧句柄会自动失效，不会误用到已经不存在的卡牌上
+ *
+ * 使用场景：
+ * - 在动画回调、异步流程里保存卡牌引用，回调时用GameModel::resolve()检查是否还有效
+ */
+struct CardHandle {
+    int id = -1;                 // 卡牌ID，-1表示无效句柄
+    uint32_t generation = 0;     // 创建句柄时卡牌的代数
+
+    bool isValid() const { return id >= 0; }
+};
+
 /**
  * GameModel - 游戏数据模型
- * 
- * 这个结构体管理整个游戏的所有数据状态
+ *
+ * 这个类管理整个游戏的所有数据状态
  * 它存储了主牌区和底牌堆的所有卡牌数据
- * 
+ *
  * 职责：
  * - 存储所有卡牌的数据（主牌区和底牌堆）
  * - 提供添加、移除、查找卡牌的方法
  * - 管理卡牌ID的分配
- * 
+ *
+ * 数据结构说明：
+ * - 主牌区和底牌堆各自是一个紧凑的CardModel数组（dense store），遍历时内存连续
+ * - 另外维护一张 卡牌ID -> (区域, 槽位下标, 代数) 的索引表，下标就是卡牌ID
+ * - 因此按ID查找、查询所在区域、从主牌区移除都是O(1)，查找返回引用而不是拷贝
+ * - 主牌区移除采用"和最后一个元素交换再删除"，所以主牌区数组的顺序不固定
+ * - 主牌区还维护13个点数桶的计数和一个13位的"点数存在"掩码（第face-1位表示点数face），
+ *   增删卡牌时同步更新，所以"主牌区有没有能和点数F匹配的牌"只需要一次位运算
+ * - 底牌堆是有顺序的（最后一张是顶部牌），移除顶部牌是O(1)，移除/调整中间的牌需要移动后面的元素
+ *
  * 注意：这个类只管理数据，不负责显示，显示由View层负责
  */
-struct GameModel {
-    std::vector<CardModel> playfieldCards;  // 主牌区的所有卡牌，用vector数组存储
-    std::vector<CardModel> stackCards;     // 底牌堆的所有卡牌（手牌区），最后一张是当前使用的顶部牌
-    int nextCardId = 0;                    // 卡牌ID计数器，每创建一张新卡牌就+1，确保每张卡牌ID唯一
-
+class GameModel {
+public:
     /**
      * 获取下一个卡牌ID
      * @return 返回一个新的唯一ID，然后计数器自动+1
      */
     int getNextCardId();
-    
+
+    /**
+     * 查看下一个卡牌ID（不会让计数器+1）
+     */
+    int peekNextCardId() const { return _nextCardId; }
+
+    /**
+     * 设置ID计数器（从紧凑状态、关卡数据还原模型时使用）
+     * @param nextId 下一个要分配的卡牌ID
+     */
+    void setNextCardId(int nextId) { _nextCardId = nextId; }
+
     /**
      * 添加卡牌到主牌区
-     * @param card 要添加的卡牌数据
+     * @param card 要添加的卡牌数据（card.id必须>=0）
      */
     void addCardToPlayfield(const CardModel& card);
-    
+
     /**
      * 添加卡牌到底牌堆
-     * @param card 要添加的卡牌数据
+     * @param card 要添加的卡牌数据（card.id必须>=0）
      * 注意：新添加的卡牌会放在最后，成为顶部牌
      */
     void addCardToStack(const CardModel& card);
-    
+
+    /**
+     * 根据ID查找卡牌（O(1)）
+     * @param cardId 卡牌的ID
+     * @return 找到的卡牌的引用，如果没找到返回id=-1的卡牌
+     * 注意：返回的引用在下一次增删卡牌之前有效
+     */
+    const CardModel& getCardById(int cardId) const;
+
     /**
-     * 根据ID查找卡牌
+     * 根据ID查找卡牌，返回可修改的指针（O(1)）
      * @param cardId 卡牌的ID
-     * @return 找到的卡牌，如果没找到返回id=-1的卡牌
+     * @return 卡牌指针，没找到返回nullptr
+     * 注意：不要通过这个指针修改id和face，主牌区的点数计数依赖它们
      */
-    CardModel getCardById(int cardId) const;
-    
+    CardModel* findCard(int cardId);
+
     /**
-     * 从主牌区移除卡牌
+     * 获取卡牌的句柄
+     * @param cardId 卡牌的ID
+     * @return 卡牌句柄，卡牌不存在时返回无效句柄（id=-1）
+     */
+    CardHandle getHandle(int cardId) const;
+
+    /**
+     * 通过句柄获取卡牌（O(1)）
+     * @param handle 卡牌句柄
+     * @return 卡牌指针；如果句柄已经失效（卡牌被移除过）返回nullptr
+     */
+    const CardModel* resolve(const CardHandle& handle) const;
+
+    /**
+     * 查询卡牌所在的区域（O(1)）
+     * @param cardId 卡牌的ID
+     * @return 卡牌所在区域，不存在返回CardZone::NONE
+     */
+    CardZone getCardZone(int cardId) const;
+
+    /**
+     * 查询卡牌最后一次在模型中时的坐标（O(1)）
+     * 卡牌被移除以后索引表仍然保留它的坐标，回退时用它还原被移除的卡牌，回退记录里就不用再存坐标
+     * @param cardId 卡牌的ID
+     * @param posX 输出：坐标X
+     * @param posY 输出：坐标Y
+     * @return false=这张卡牌从来没有添加过
+     */
+    bool getLastPosition(int cardId, float& posX, float& posY) const;
+
+    /**
+     * 记录卡牌的坐标，但不把它添加到任何区域
+     * 从紧凑状态还原模型时，已经被移除的卡牌也要记住坐标，之后回退时才能放回原处
+     */
+    void rememberPosition(int cardId, float posX, float posY);
+
+    /**
+     * 查询卡牌在底牌堆中的下标（O(1)）
+     * @param cardId 卡牌的ID
+     * @return 下标（0是最底下），卡牌不在底牌堆返回-1
+     */
+    int getStackIndex(int cardId) const;
+
+    /**
+     * 从主牌区移除卡牌（O(1)）
      * @param cardId 要移除的卡牌ID
      */
     void removeCardFromPlayfield(int cardId);
-    
+
     /**
      * 从底牌堆移除卡牌
      * @param cardId 要移除的卡牌ID
+     * 注意：移除顶部牌是O(1)，移除中间的牌需要移动上面的牌
      */
     void removeCardFromStack(int cardId);
-    
+
+    /**
+     * 调整卡牌在底牌堆中的位置
+     * @param cardId 底牌堆中的卡牌ID
+     * @param newIndex 新的下标，超出范围时放到顶部
+     */
+    void moveStackCard(int cardId, int newIndex);
+
     /**
      * 获取底牌堆的顶部卡牌（当前使用的底牌）
-     * @return 顶部卡牌，如果底牌堆为空返回id=-1的卡牌
+     * @return 顶部卡牌的引用，如果底牌堆为空返回id=-1的卡牌
+     */
+    const CardModel& getStackTopCard() const;
+
+    /**
+     * 主牌区是否有能与指定点数匹配的卡牌（O(1)）
+     * 匹配规则：点数差1，所以只需要检查F-1和F+1两个桶
+     * @param face 要匹配的点数（一般是底牌堆顶部牌的点数）
+     * @return true=有可以匹配的牌
+     */
+    bool hasPlayfieldMatchFor(int face) const;
+
+    /**
+     * 是否还有可以走的步（O(1)）
+     * 有步可走的条件：主牌区还有牌，并且 顶部牌能匹配 或者 还有备用底牌可以换
+     * @return false=没有可走的步了（已经赢了或者卡死）
+     */
+    bool hasMovesLeft() const;
+
+    /**
+     * 获取主牌区某个点数的卡牌数量
+     * @param face 点数（1-13）
+     */
+    int getPlayfieldFaceCount(int face) const;
+
+    /**
+     * 获取主牌区的点数存在掩码，第face-1位为1表示主牌区有这个点数的牌
+     */
+    uint16_t getPlayfieldFaceMask() const { return _playfieldFaceMask; }
+
+    /**
+     * 获取与指定点数相邻（可以匹配）的点数掩码，表是预先计算好的
+     * @param face 点数（1-13），超出范围返回0
+     */
+    static uint16_t getMatchMaskForFace(int face);
+
+    /**
+     * 获取主牌区的所有卡牌（只读，顺序不固定）
+     */
+    const std::vector<CardModel>& getPlayfieldCards() const { return _playfieldCards; }
+
+    /**
+     * 获取底牌堆的所有卡牌（只读，最后一张是顶部牌）
      */
-    CardModel getStackTopCard() const;
-    
+    const std::vector<CardModel>& getStackCards() const { return _stackCards; }
+
     /**
      * 清空所有数据
      * 用于重新开始游戏时清空之前的数据
+     * 注意：清空后之前拿到的所有句柄都会失效
      */
     void clear();
-};
 
+private:
+    /**
+     * CardSlot - 索引表的一项，记录一张卡牌在哪个区域的第几个位置
+     */
+    struct CardSlot {
+        CardZone zone = CardZone::NONE;  // 所在区域
+        int index = -1;                  // 在区域数组中的下标
+        uint32_t generation = 0;         // 代数，卡牌每离开一次区域就+1
+        bool placed = false;             // 这一局是否添加过（clear()时重置）
+        float posX = 0.0f;               // 最后一次添加时的坐标（移除后仍然保留）
+        float posY = 0.0f;
+    };
+
+    std::vector<CardModel> _playfieldCards;  // 主牌区的所有卡牌（紧凑数组）
+    std::vector<CardModel> _stackCards;      // 底牌堆的所有卡牌，最后一张是当前使用的顶部牌
+    std::vector<CardSlot> _slots;            // 卡牌ID -> 位置 的索引表，下标就是卡牌ID
+    int _nextCardId = 0;                     // 卡牌ID计数器，每创建一张新卡牌就+1，确保每张卡牌ID唯一
+    int _playfieldFaceCount[14] = {};        // 主牌区每个点数的卡牌数量，下标是点数（0不用）
+    uint16_t _playfieldFaceMask = 0;         // 主牌区点数存在掩码，第face-1位对应点数face
+
+    /**
+     * 获取卡牌的索引项（只读），ID无效时返回nullptr
+     */
+    const CardSlot* getSlot(int cardId) const;
+
+    /**
+     * 获取卡牌的索引项，必要时扩充索引表
+     */
+    CardSlot& ensureSlot(int cardId);
+
+    /**
+     * 标记卡牌离开了所在区域（区域置空，代数+1）
+     */
+    void releaseSlot(int cardId);
+
+    /**
+     * 主牌区点数计数 +1/-1，并同步更新点数存在掩码
+     */
+    void countPlayfieldFace(int face, int delta);
+
+    /**
+     * 重新计算底牌堆[from, to)范围内卡牌的下标
+     */
+    void reindexStack(int from, int to);
+};
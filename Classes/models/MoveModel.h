@@ -0,0 +1,24 @@
+#pragma once
+#include "UndoModel.h"
+
+/**
+ * Move - 一步操作
+ * 
+ * 玩家的每次有效点击都对应一步操作：
+ * - PLAYFIELD_MATCH：cardId是主牌区被点击的卡牌
+ * - STACK_REPLACE：cardId是底牌堆中被点击的备用底牌
+ * 
+ * 使用场景：
+ * - GameLogic::applyMove()执行操作
+ * - GameLogic::legalMoves()列出当前所有合法操作（求解器、机器人使用）
+ * - 回放、自动测试时按顺序重放操作
+ */
+struct Move {
+    MoveType type = MoveType::PLAYFIELD_MATCH;  // 操作类型
+    int cardId = -1;                            // 被操作的卡牌ID，-1表示无效操作
+
+    Move() {}
+    Move(MoveType moveType, int id) : type(moveType), cardId(id) {}
+
+    bool isValid() const { return cardId >= 0; }
+};
@@ -0,0 +1,253 @@
+#include "PackedGameState.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * 位集合中最低位的1的下标（bits不能为0）
+ */
+static inline int lowestBit(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * 把64位整数混合到哈希值中（splitmix64的混合函数）
+ */
+static inline uint64_t mixHash(uint64_t h, uint64_t value) {
+    h ^= value + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+int PackedLayout::findIndex(int cardId) const {
+    // 开局时卡牌ID一般按添加顺序从0分配，和下标相同，先直接检查
+    if (cardId >= 0 && cardId < cardCount && cardIds[cardId] == cardId) return cardId;
+    for (int i = 0; i < cardCount; i++) {
+        if (cardIds[i] == cardId) return i;
+    }
+    return -1;
+}
+
+/**
+ * 从GameModel生成紧凑状态
+ * 主牌区的牌先编号，底牌堆的牌后编号，这样还原时顺序和原来一致
+ */
+bool PackedGameState::fromModel(const GameModel& model, PackedGameState& state, PackedLayout& layout) {
+    const auto& playfieldCards = model.getPlayfieldCards();
+    const auto& stackCards = model.getStackCards();
+    size_t total = playfieldCards.size() + stackCards.size();
+    if (total > (size_t)kMaxCards) return false;
+
+    std::memset(&state, 0, sizeof(state));
+    layout.cardCount = 0;
+
+    // 把一张牌写进状态和布局，返回它的下标；点数或花色不合法返回-1
+    auto pack = [&state, &layout](const CardModel& card) -> int {
+        if (card.face < 1 || card.face > 13 || card.suit < 0 || card.suit > 3) return -1;
+        int index = layout.cardCount++;
+        layout.cardIds[index] = card.id;
+        layout.posX[index] = card.posX;
+        layout.posY[index] = card.posY;
+        state.cards[index] = (uint8_t)(card.face | (card.suit << 4) | (card.isFaceUp ? 0x40 : 0));
+        return index;
+    };
+
+    for (const auto& card : playfieldCards) {
+        int index = pack(card);
+        if (index < 0) return false;
+        state.addToPlayfield(index);
+    }
+    for (const auto& card : stackCards) {
+        int index = pack(card);
+        if (index < 0) return false;
+        state.stock[state.stockCount++] = (uint8_t)index;
+        state.stockSet |= (uint64_t)1 << index;
+    }
+    state.cardCount = (uint8_t)layout.cardCount;
+    layout.nextCardId = model.peekNextCardId();
+    return true;
+}
+
+/**
+ * 用已有的布局压缩
+ * 下标用PackedLayout::findIndex查（ID和下标相同时O(1)，否则最多查64项），不分配内存：
+ * 回退时间线每64步在这里保存一次检查点
+ */
+bool PackedGameState::fromModel(const GameModel& model, const PackedLayout& layout, PackedGameState& state) {
+    std::memset(&state, 0, sizeof(state));
+    state.cardCount = (uint8_t)layout.cardCount;
+
+    auto pack = [&state, &layout](const CardModel& card) -> int {
+        int index = layout.findIndex(card.id);
+        if (index < 0 || card.face < 1 || card.face > 13 || card.suit < 0 || card.suit > 3) return -1;
+        state.cards[index] = (uint8_t)(card.face | (card.suit << 4) | (card.isFaceUp ? 0x40 : 0));
+        return index;
+    };
+
+    for (const auto& card : model.getPlayfieldCards()) {
+        int index = pack(card);
+        if (index < 0) return false;
+        state.addToPlayfield(index);
+    }
+    for (const auto& card : model.getStackCards()) {
+        int index = pack(card);
+        if (index < 0) return false;
+        state.stock[state.stockCount++] = (uint8_t)index;
+        state.stockSet |= (uint64_t)1 << index;
+    }
+    return true;
+}
+
+/**
+ * 还原成GameModel
+ * 主牌区按下标从小到大添加，底牌堆按stock数组的顺序添加
+ */
+void PackedGameState::toModel(const PackedLayout& layout, GameModel& model) const {
+    model.clear();
+    model.setNextCardId(layout.nextCardId);
+    for (int i = 0; i < layout.cardCount; i++) {
+        model.rememberPosition(layout.cardIds[i], layout.posX[i], layout.posY[i]);
+    }
+
+    auto unpack = [this, &layout](int index) {
+        CardModel card;
+        card.id = layout.cardIds[index];
+        card.face = getFace(index);
+        card.suit = getSuit(index);
+        card.isFaceUp = isFaceUp(index);
+        card.posX = layout.posX[index];
+        card.posY = layout.posY[index];
+        return card;
+    };
+
+    for (uint64_t bits = playfield; bits != 0; bits &= bits - 1) {
+        model.addCardToPlayfield(unpack(lowestBit(bits)));
+    }
+    for (int i = 0; i < stockCount; i++) {
+        model.addCardToStack(unpack(stock[i]));
+    }
+}
+
+int PackedGameState::generateMoves(PackedMove* moves) const {
+    int top = getTopCard();
+    if (top < 0 || playfield == 0) return 0;
+
+    int count = 0;
+    int topFace = getFace(top);
+    if (hasMatchFor(topFace)) {
+        // 顶部牌能匹配：列出所有点数相邻的主牌区卡牌
+        for (uint64_t bits = playfield; bits != 0; bits &= bits - 1) {
+            int card = lowestBit(bits);
+            int diff = getFace(card) - topFace;
+            if (diff == 1 || diff == -1) {
+                moves[count++] = makeMatchMove(card);
+            }
+        }
+    } else {
+        // 顶部牌不能匹配：任意一张备用底牌都可以换到顶部
+        for (int i = 0; i < stockCount - 1; i++) {
+            moves[count++] = makeReplaceMove(i);
+        }
+    }
+    return count;
+}
+
+/**
+ * 执行一步操作
+ * - 匹配：卡牌离开主牌区，替换掉顶部牌（原顶部牌直接消失）
+ * - 换底牌：备用底牌移到顶部，上面的牌依次往下移一格
+ */
+void PackedGameState::apply(const PackedMove& move) {
+    if (move.type == PACKED_MOVE_MATCH) {
+        removeFromPlayfield(move.card);
+        stock[stockCount - 1] = move.card;
+        stockSet = (stockSet & ~((uint64_t)1 << move.prevTop)) | ((uint64_t)1 << move.card);
+    } else {
+        int last = stockCount - 1;
+        for (int i = move.fromIndex; i < last; i++) {
+            stock[i] = stock[i + 1];
+        }
+        stock[last] = move.card;
+    }
+}
+
+/**
+ * 撤销一步操作，是apply的逆操作
+ */
+void PackedGameState::unapply(const PackedMove& move) {
+    if (move.type == PACKED_MOVE_MATCH) {
+        stock[stockCount - 1] = move.prevTop;
+        stockSet = (stockSet & ~((uint64_t)1 << move.card)) | ((uint64_t)1 << move.prevTop);
+        addToPlayfield(move.card);
+    } else {
+        for (int i = stockCount - 1; i > move.fromIndex; i--) {
+            stock[i] = stock[i - 1];
+        }
+        stock[move.fromIndex] = move.card;
+    }
+}
+
+PackedMove PackedGameState::makeMatchMove(int card) const {
+    PackedMove move;
+    move.type = PACKED_MOVE_MATCH;
+    move.card = (uint8_t)card;
+    move.prevTop = (uint8_t)getTopCard();
+    move.fromIndex = (uint8_t)(stockCount - 1);
+    return move;
+}
+
+PackedMove PackedGameState::makeReplaceMove(int stockIndex) const {
+    PackedMove move;
+    move.type = PACKED_MOVE_STACK_REPLACE;
+    move.card = stock[stockIndex];
+    move.prevTop = (uint8_t)getTopCard();
+    move.fromIndex = (uint8_t)stockIndex;
+    return move;
+}
+
+uint64_t PackedGameState::hash() const {
+    uint64_t h = mixHash(0, playfield);
+    h = mixHash(h, stockSet);
+    return mixHash(h, (uint64_t)(getTopCard() + 1));
+}
+
+bool PackedGameState::sameAs(const PackedGameState& other) const {
+    return playfield == other.playfield &&
+           stockSet == other.stockSet &&
+           getTopCard() == other.getTopCard();
+}
+
+void PackedGameState::addToPlayfield(int card) {
+    playfield |= (uint64_t)1 << card;
+    int face = getFace(card);
+    if (faceCount[face]++ == 0) {
+        faceMask |= (uint16_t)(1 << (face - 1));
+    }
+}
+
+void PackedGameState::removeFromPlayfield(int card) {
+    playfield &= ~((uint64_t)1 << card);
+    int face = getFace(card);
+    if (--faceCount[face] == 0) {
+        faceMask &= (uint16_t)~(1 << (face - 1));
+    }
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include "GameModel.h"
+#include <cstdint>
+
+/**
+ * PackedGameState - 紧凑的游戏状态（给求解器、机器人用）
+ *
+ * GameModel用两个vector<CardModel>存储卡牌，每张牌24字节，还带浮点坐标，
+ * 搜索时每秒要展开上百万个状态，拷贝和比较GameModel太慢。
+ * 这个结构体把一局游戏压缩到几个缓存行（约170字节）里：
+ * - 每张牌一个字节：低4位是点数，第4-5位是花色，第6位表示正面朝上
+ * - 主牌区用64位的位集合表示（第i位=1表示第i张牌在主牌区）
+ * - 底牌堆用一个字节数组保存顺序（存的是卡牌下标，最后一个是顶部牌），另外用位集合记录底牌堆里有哪些牌
+ * - 另外维护主牌区的点数计数和点数掩码，判断能否匹配是O(1)
+ *
+ * 局面等价：任意一张备用底牌都可以换到顶部，备用底牌的顺序不影响以后能走哪些步，
+ * 所以hash()/sameAs()只看 主牌区集合 + 底牌堆集合 + 顶部牌，不看备用底牌的顺序，
+ * 这样求解器不会把同一个局面的不同排列当成不同局面重复搜索
+ *
+ * 卡牌"下标"和卡牌ID不同：下标是0~63的紧凑编号，ID和坐标保存在PackedLayout里，
+ * 布局在一局游戏中不会变化，所以多个状态可以共用一个布局
+ *
+ * 使用示例：
+ * PackedLayout layout;
+ * PackedGameState state;
+ * if (PackedGameState::fromModel(model, state, layout)) {
+ *     PackedMove moves[PackedGameState::kMaxMoves];
+ *     int count = state.generateMoves(moves);
+ *     state.apply(moves[0]);
+ *     state.unapply(moves[0]);
+ *     state.toModel(layout, model);
+ * }
+ */
+
+/**
+ * 紧凑状态最多支持的卡牌数量（受64位位集合限制）
+ */
+const int kPackedMaxCards = 64;
+
+/**
+ * PackedMoveType - 紧凑状态上的操作类型
+ */
+enum PackedMoveType : uint8_t {
+    PACKED_MOVE_MATCH = 0,          // 主牌区的牌与顶部底牌匹配
+    PACKED_MOVE_STACK_REPLACE = 1   // 备用底牌换到顶部
+};
+
+/**
+ * PackedMove - 紧凑状态上的一步操作（4字节）
+ * 里面保存了撤销这一步需要的全部信息，所以apply/unapply不需要额外的栈
+ */
+struct PackedMove {
+    uint8_t type;       // 操作类型（PackedMoveType）
+    uint8_t card;       // 被操作的卡牌下标
+    uint8_t prevTop;    // 操作前的顶部牌下标（匹配时它会被移除）
+    uint8_t fromIndex;  // 换底牌时卡牌原来在底牌堆的位置
+};
+
+/**
+ * PackedLayout - 卡牌下标 -> 卡牌ID、坐标 的对照表
+ * 这部分数据在一局游戏中不会变化，从GameModel转换时生成，转换回去时使用
+ */
+struct PackedLayout {
+    int cardCount = 0;          // 卡牌总数
+    int cardIds[kPackedMaxCards];   // 每个下标对应的卡牌ID
+    float posX[kPackedMaxCards];    // 每张牌的坐标X
+    float posY[kPackedMaxCards];    // 每张牌的坐标Y
+    int nextCardId = 0;         // 转换时GameModel的ID计数器，转换回去时恢复
+
+    /**
+     * 根据卡牌ID找到下标
+     * @return 下标，找不到返回-1
+     */
+    int findIndex(int cardId) const;
+};
+
+struct PackedGameState {
+    static const int kMaxCards = kPackedMaxCards;  // 最多支持的卡牌数量
+    static const int kMaxMoves = kMaxCards;        // 一个状态最多的可走步数
+
+    uint64_t playfield;             // 主牌区位集合，第i位表示第i张牌在主牌区
+    uint64_t stockSet;              // 底牌堆位集合，第i位表示第i张牌在底牌堆
+    uint8_t cards[kMaxCards];       // 每张牌一个字节：点数 | 花色<<4 | 正面朝上<<6
+    uint8_t stock[kMaxCards];       // 底牌堆顺序，stock[0]在最底下，stock[stockCount-1]是顶部牌
+    uint8_t faceCount[14];          // 主牌区每个点数的卡牌数量，下标是点数（0不用）
+    uint16_t faceMask;              // 主牌区点数存在掩码，第face-1位对应点数face
+    uint8_t stockCount;             // 底牌堆的卡牌数量
+    uint8_t cardCount;              // 卡牌总数
+
+    /**
+     * 从GameModel生成紧凑状态和布局
+     * @param model 游戏模型
+     * @param state 输出：紧凑状态
+     * @param layout 输出：卡牌下标对照表
+     * @return false=卡牌超过kMaxCards张或者点数/花色不合法，无法压缩
+     */
+    static bool fromModel(const GameModel& model, PackedGameState& state, PackedLayout& layout);
+
+    /**
+     * 用已有的布局压缩GameModel（不重新编号）
+     * 一局游戏中卡牌不会增加，开局时生成一次布局，之后的状态都用它压缩，
+     * 这样所有状态共用一个布局（比如回退时间线的检查点）
+     * @param model 游戏模型
+     * @param layout 开局时fromModel生成的布局，必须包含模型中的所有卡牌
+     * @param state 输出：紧凑状态
+     * @return false=模型中有布局里没有的卡牌
+     */
+    static bool fromModel(const GameModel& model, const PackedLayout& layout, PackedGameState& state);
+
+    /**
+     * 把紧凑状态还原成GameModel（会先清空model）
+     * 布局中不在状态里的卡牌（已经被移除的）也会通过GameModel::rememberPosition记住坐标
+     * @param layout fromModel时生成的布局
+     * @param model 输出：游戏模型
+     */
+    void toModel(const PackedLayout& layout, GameModel& model) const;
+
+    /**
+     * 生成当前状态下所有合法的操作
+     * 规则和GameController一致：
+     * - 顶部牌能匹配时，只能匹配（每张能匹配的主牌区卡牌一步）
+     * - 顶部牌不能匹配时，可以把任意一张备用底牌换到顶部
+     * @param moves 输出数组，长度至少kMaxMoves
+     * @return 合法操作的数量
+     */
+    int generateMoves(PackedMove* moves) const;
+
+    /**
+     * 执行一步操作
+     * @param move 由generateMoves或makeMatchMove/makeReplaceMove得到的操作
+     */
+    void apply(const PackedMove& move);
+
+    /**
+     * 撤销一步操作（必须是最近一次apply的操作）
+     */
+    void unapply(const PackedMove& move);
+
+    /**
+     * 创建一个匹配操作
+     * @param card 主牌区的卡牌下标
+     */
+    PackedMove makeMatchMove(int card) const;
+
+    /**
+     * 创建一个换底牌操作
+     * @param stockIndex 备用底牌在底牌堆中的位置
+     */
+    PackedMove makeReplaceMove(int stockIndex) const;
+
+    /**
+     * 主牌区是否已经清空（赢了）
+     */
+    bool isWon() const { return playfield == 0; }
+
+    /**
+     * 顶部底牌的下标，底牌堆为空返回-1
+     */
+    int getTopCard() const { return stockCount > 0 ? stock[stockCount - 1] : -1; }
+
+    /**
+     * 主牌区是否有能与指定点数匹配的牌（O(1)）
+     */
+    bool hasMatchFor(int face) const { return (faceMask & GameModel::getMatchMaskForFace(face)) != 0; }
+
+    /**
+     * 读取卡牌字节中的点数、花色、正面朝上
+     */
+    int getFace(int card) const { return cards[card] & 0x0F; }
+    int getSuit(int card) const { return (cards[card] >> 4) & 0x03; }
+    bool isFaceUp(int card) const { return (cards[card] & 0x40) != 0; }
+
+    /**
+     * 计算局面的64位哈希（主牌区集合、底牌堆集合、顶部牌）
+     */
+    uint64_t hash() const;
+
+    /**
+     * 判断两个状态的局面是否相同（不比较备用底牌的顺序）
+     */
+    bool sameAs(const PackedGameState& other) const;
+
+private:
+    void addToPlayfield(int card);
+    void removeFromPlayfield(int card);
+};
@@ -1,11 +1,14 @@
 #pragma once
-#include "cocos2d.h"
+#include <cstdint>
 
 /**
  * UndoModel - 回退数据模型
  * 
  * 这个文件定义了回退功能需要的数据结构
- * 每次玩家操作时，都会记录一条UndoRecord，用于回退时恢复状态
+ * 每次玩家操作时，UndoManager里保存一条只有几个字节的UndoDelta；
+ * 通知观察者（执行、回退操作时）再结合模型展开成完整的UndoRecord
+ * 
+ * 注意：这个文件不依赖cocos2d，核心逻辑库（core）可以在没有图形环境的机器上编译
  */
 
 /**
@@ -18,16 +21,40 @@ enum class MoveType {
 };
 
 /**
- * UndoRecord - 回退记录结构体
+ * UndoDelta - 保存在回退日志里的紧凑记录（8字节）
+ *
+ * 只保存模型里推算不出来的信息：
+ * - 换底牌：被点击的卡牌ID + 它原来在底牌堆中的下标
+ *   （原来的顶部牌回退前就在它下面一格，不用保存）
+ * - 匹配：被点击的卡牌ID + 原顶部牌的ID、点数、花色
+ *   （被点击的卡牌回退前就是顶部牌，点数、花色、坐标都在模型里；
+ *    原顶部牌已经从模型中移除，坐标通过GameModel::getLastPosition查询）
+ *
+ * 卡牌ID每局从0开始，ID和底牌堆下标都用16位保存，几百张牌的自定义关卡也不会截断；
+ * 卡牌ID达到kInvalidCardId（65535张以上）的关卡GameLogic::applyMove直接拒绝，不会记录错误的回退
+ */
+struct UndoDelta {
+    static const uint16_t kInvalidCardId = 0xFFFF;
+
+    uint16_t cardId = kInvalidCardId;       // 被操作的卡牌ID
+    uint16_t oldTopCardId = kInvalidCardId; // 匹配：原顶部牌ID（换底牌时不用）
+    uint8_t moveType = 0;                   // 操作类型（MoveType）
+    uint16_t data = 0;                      // 换底牌：原来在底牌堆中的下标；匹配：原顶部牌 点数 | 花色<<4
+
+    bool isValid() const { return cardId != kInvalidCardId; }
+};
+
+/**
+ * UndoRecord - 完整的回退记录
  * 
- * 每次操作时，都会创建一个UndoRecord记录这次操作的所有信息
- * 回退时，根据这些信息恢复到操作前的状态
+ * 由GameLogic根据UndoDelta和当前模型展开，传给GameObserver播放动画；
+ * 它只在通知期间存在，不保存在回退日志里
  */
 struct UndoRecord {
     int cardId;                    // 被操作的卡牌ID（比如被点击的卡牌）
     MoveType moveType;              // 操作类型（是换底牌还是匹配）
-    cocos2d::Vec2 originalPos;     // 卡牌的原始位置（回退时要移回这里）
-    int originalParent;             // 卡牌原来在哪个区域：0=主牌区, 1=底牌堆
+    float originalPosX;            // 卡牌的原始位置X（回退时要移回这里）
+    float originalPosY;            // 卡牌的原始位置Y
     int targetCardId;               // 目标卡牌ID（比如匹配时目标底牌，换底牌时原来的顶部牌）
     int cardFace;                   // 卡牌点数（回退时需要重新创建卡牌，所以要保存点数）
     int cardSuit;                   // 卡牌花色（回退时需要重新创建卡牌，所以要保存花色）
@@ -0,0 +1,330 @@
+/**
+ * atlas_packer - 把卡牌图片打包成图集（PNG + cocos2d plist）
+ *
+ * 读入一组PNG，裁掉四周全透明的部分，用MaxRects（core/RectPacker.h）装进一页或多页图集，
+ * 每页输出一张PNG和一个plist（cocos2d的精灵帧格式2，SpriteFrameCache::addSpriteFramesWithFile可以直接加载）。
+ * 精灵帧的名字是图片路径去掉-r指定的根目录，比如res1/number/big_red_A.png，
+ * 和CardView查找精灵帧用的名字一致，加载图集后卡牌直接使用图集里的帧。
+ *
+ * 用法：atlas_packer [选项] -o <输出前缀> <PNG文件|@列表文件>...
+ *   -o <前缀>      输出<前缀>.png/.plist，多页时后面几页是<前缀>-1.png/.plist、<前缀>-2...
+ *   -r <目录>      资源根目录，精灵帧名字去掉这个前缀（默认不去掉）
+ *   -s <大小>      一页的最大宽高（默认2048）
+ *   -p <像素>      图片之间的间隔（默认2）
+ *   --pot          每页的宽高取2的幂
+ *   --no-trim      不裁剪透明边
+ *   @列表文件      每行一个PNG路径
+ *
+ * 例：atlas_packer -r Resources -o Resources/cards Resources/res1/card_general.png
+ *         Resources/res1/number/<图片>.png... Resources/res1/suits/<图片>.png...（一般用shell通配符传入整个目录）
+ */
+#include "core/RectPacker.h"
+#include "PngImage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * 一张输入图片
+ */
+struct AtlasImage {
+    std::string path;               // 文件路径
+    std::string name;               // 精灵帧名字
+    PngImage source;                // 原图
+    int trimX = 0;                  // 裁剪后的范围（原图坐标，左上角为原点）
+    int trimY = 0;
+    int trimWidth = 0;
+    int trimHeight = 0;
+    int page = -1;                  // 放在第几页
+    int x = 0;                      // 在这一页中的位置
+    int y = 0;
+};
+
+/**
+ * 计算去掉四周全透明像素后的范围（全透明的图片保留一个像素）
+ */
+static void trimImage(AtlasImage& image, bool trim) {
+    image.trimX = 0;
+    image.trimY = 0;
+    image.trimWidth = image.source.width;
+    image.trimHeight = image.source.height;
+    if (!trim) return;
+
+    int minX = image.source.width, minY = image.source.height, maxX = -1, maxY = -1;
+    for (int y = 0; y < image.source.height; y++) {
+        const uint8_t* row = image.source.pixel(0, y);
+        for (int x = 0; x < image.source.width; x++) {
+            if (row[x * 4 + 3] == 0) continue;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+    if (maxX < 0) {
+        image.trimWidth = 1;
+        image.trimHeight = 1;
+        return;
+    }
+    image.trimX = minX;
+    image.trimY = minY;
+    image.trimWidth = maxX - minX + 1;
+    image.trimHeight = maxY - minY + 1;
+}
+
+static std::string frameName(const std::string& path, const std::string& root) {
+    std::string name = path;
+    for (char& c : name) {
+        if (c == '\\') c = '/';
+    }
+    if (!root.empty()) {
+        std::string prefix = root;
+        for (char& c : prefix) {
+            if (c == '\\') c = '/';
+        }
+        if (prefix.back() != '/') prefix += '/';
+        if (name.compare(0, prefix.size(), prefix) == 0) name = name.substr(prefix.size());
+    }
+    return name;
+}
+
+static std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+static std::string xmlEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        switch (c) {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            default: escaped += c; break;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * 写一页的plist（cocos2d精灵帧格式2）
+ * offset是裁剪后的中心相对原图中心的偏移（y轴向上），sourceColorRect是裁剪范围（y轴向下）
+ */
+static bool writePlist(const std::string& path, const std::string& textureName, int width, int height,
+                       const std::vector<const AtlasImage*>& images) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) return false;
+    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+                  "<plist version=\"1.0\">\n<dict>\n    <key>frames</key>\n    <dict>\n");
+    for (const AtlasImage* image : images) {
+        double offsetX = image->trimX + image->trimWidth / 2.0 - image->source.width / 2.0;
+        double offsetY = image->source.height / 2.0 - (image->trimY + image->trimHeight / 2.0);
+        fprintf(file, "        <key>%s</key>\n        <dict>\n", xmlEscape(image->name).c_str());
+        fprintf(file, "            <key>frame</key>\n            <string>{{%d,%d},{%d,%d}}</string>\n",
+                image->x, image->y, image->trimWidth, image->trimHeight);
+        fprintf(file, "            <key>offset</key>\n            <string>{%g,%g}</string>\n", offsetX, offsetY);
+        fprintf(file, "            <key>rotated</key>\n            <false/>\n");
+        fprintf(file, "            <key>sourceColorRect</key>\n            <string>{{%d,%d},{%d,%d}}</string>\n",
+                image->trimX, image->trimY, image->trimWidth, image->trimHeight);
+        fprintf(file, "            <key>sourceSize</key>\n            <string>{%d,%d}</string>\n",
+                image->source.width, image->source.height);
+        fprintf(file, "        </dict>\n");
+    }
+    fprintf(file, "    </dict>\n    <key>metadata</key>\n    <dict>\n"
+                  "        <key>format</key>\n        <integer>2</integer>\n"
+                  "        <key>realTextureFileName</key>\n        <string>%s</string>\n"
+                  "        <key>size</key>\n        <string>{%d,%d}</string>\n"
+                  "        <key>textureFileName</key>\n        <string>%s</string>\n"
+                  "    </dict>\n</dict>\n</plist>\n",
+            xmlEscape(textureName).c_str(), width, height, xmlEscape(textureName).c_str());
+    return fclose(file) == 0;
+}
+
+static int nextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+static bool collectInputs(const char* argument, std::vector<std::string>& paths) {
+    if (argument[0] != '@') {
+        paths.push_back(argument);
+        return true;
+    }
+    FILE* file = fopen(argument + 1, "r");
+    if (!file) return false;
+    char line[4096];
+    while (fgets(line, sizeof(line), file)) {
+        std::string path = line;
+        while (!path.empty() && (path.back() == '\n' || path.back() == '\r' || path.back() == ' ')) path.pop_back();
+        if (!path.empty()) paths.push_back(path);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string outputPrefix;
+    std::string root;
+    int maxSize = 2048;
+    int padding = 2;
+    bool powerOfTwo = false;
+    bool trim = true;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPrefix = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            root = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            maxSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            padding = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pot") == 0) {
+            powerOfTwo = true;
+        } else if (strcmp(argv[i], "--no-trim") == 0) {
+            trim = false;
+        } else if (!collectInputs(argv[i], paths)) {
+            printf("cannot read list %s\n", argv[i] + 1);
+            return 2;
+        }
+    }
+    if (outputPrefix.empty() || paths.empty() || maxSize <= 0 || padding < 0) {
+        printf("usage: atlas_packer [-r root] [-s max_size] [-p padding] [--pot] [--no-trim] "
+               "-o out_prefix <png files | @listfile>...\n");
+        return 2;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // 1. 读图片、裁剪，检查重名
+    std::vector<AtlasImage> images(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        AtlasImage& image = images[i];
+        image.path = paths[i];
+        image.name = frameName(paths[i], root);
+        if (!image.source.read(image.path)) {
+            printf("%s: cannot read png\n", image.path.c_str());
+            return 1;
+        }
+        trimImage(image, trim);
+        if (image.trimWidth + padding > maxSize || image.trimHeight + padding > maxSize) {
+            printf("%s: %dx%d does not fit in %dx%d\n", image.path.c_str(), image.trimWidth, image.trimHeight,
+                   maxSize, maxSize);
+            return 1;
+        }
+    }
+
+    // 2. 从大到小装箱（先按高、再按宽，名字保证结果稳定），当前所有页都放不下时开新的一页
+    std::vector<AtlasImage*> order;
+    for (auto& image : images) order.push_back(&image);
+    std::sort(order.begin(), order.end(), [](const AtlasImage* a, const AtlasImage* b) {
+        if (a->trimHeight != b->trimHeight) return a->trimHeight > b->trimHeight;
+        if (a->trimWidth != b->trimWidth) return a->trimWidth > b->trimWidth;
+        return a->name < b->name;
+    });
+    for (size_t i = 1; i < order.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            if (order[i]->name == order[j]->name) {
+                printf("%s: duplicate frame name %s\n", order[i]->path.c_str(), order[i]->name.c_str());
+                return 1;
+            }
+        }
+    }
+
+    // 一页放得下时，按面积从小到大找能放下全部图片的页面大小（避免细长的图集）：
+    // 普通模式试边长按16递增的正方形，--pot模式试宽高比不超过2的2的幂；最大尺寸也放不下才分成多页
+    long long totalArea = 0;
+    for (const AtlasImage* image : order) {
+        totalArea += (long long)(image->trimWidth + padding) * (image->trimHeight + padding);
+    }
+    std::vector<std::pair<int, int>> candidates;
+    if (powerOfTwo) {
+        for (int height = 16; height <= maxSize; height <<= 1) {
+            candidates.push_back(std::make_pair(height, height));
+            if (height * 2 <= maxSize) candidates.push_back(std::make_pair(height * 2, height));
+        }
+    } else {
+        for (int size = std::max(16, (int)std::sqrt((double)totalArea) / 16 * 16); size < maxSize; size += 16) {
+            candidates.push_back(std::make_pair(size, size));
+        }
+    }
+    int binWidth = maxSize, binHeight = maxSize;
+    for (const auto& candidate : candidates) {
+        if ((long long)candidate.first * candidate.second < totalArea) continue;
+        RectPacker packer(candidate.first, candidate.second);
+        bool fits = true;
+        int x, y;
+        for (const AtlasImage* image : order) {
+            if (!packer.insert(image->trimWidth + padding, image->trimHeight + padding, x, y)) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits) {
+            binWidth = candidate.first;
+            binHeight = candidate.second;
+            break;
+        }
+    }
+
+    std::vector<RectPacker> pages;
+    for (AtlasImage* image : order) {
+        int width = image->trimWidth + padding;
+        int height = image->trimHeight + padding;
+        for (size_t page = 0; page < pages.size() && image->page < 0; page++) {
+            if (pages[page].insert(width, height, image->x, image->y)) image->page = (int)page;
+        }
+        if (image->page < 0) {
+            pages.push_back(RectPacker(binWidth, binHeight));
+            pages.back().insert(width, height, image->x, image->y);
+            image->page = (int)pages.size() - 1;
+        }
+    }
+
+    // 3. 每页输出PNG和plist
+    for (size_t page = 0; page < pages.size(); page++) {
+        std::string prefix = page == 0 ? outputPrefix : outputPrefix + "-" + std::to_string(page);
+        int width = pages[page].getUsedWidth();
+        int height = pages[page].getUsedHeight();
+        if (powerOfTwo) {
+            width = nextPowerOfTwo(width);
+            height = nextPowerOfTwo(height);
+        }
+
+        PngImage atlas;
+        atlas.resize(width, height);
+        std::vector<const AtlasImage*> pageImages;
+        for (const AtlasImage* image : order) {
+            if (image->page != (int)page) continue;
+            pageImages.push_back(image);
+            for (int row = 0; row < image->trimHeight; row++) {
+                const uint8_t* source = image->source.pixel(image->trimX, image->trimY + row);
+                uint8_t* target = atlas.pixel(image->x, image->y + row);
+                memcpy(target, source, (size_t)image->trimWidth * 4);
+            }
+        }
+
+        if (!atlas.write(prefix + ".png")) {
+            printf("cannot write %s.png\n", prefix.c_str());
+            return 1;
+        }
+        if (!writePlist(prefix + ".plist", baseName(prefix + ".png"), width, height, pageImages)) {
+            printf("cannot write %s.plist\n", prefix.c_str());
+            return 1;
+        }
+        printf("%s.png: %dx%d, %zu frames, %.1f%% used\n", prefix.c_str(), width, height, pageImages.size(),
+               100.0 * pages[page].getOccupancy() * binWidth * binHeight / ((double)width * height));
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("%zu images, %zu pages, %.3f s\n", images.size(), pages.size(), seconds);
+    return 0;
+}
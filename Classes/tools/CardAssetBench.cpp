@@ -0,0 +1,107 @@
+/**
+ * card_asset_bench - 创建卡牌时取图片的开销：按路径 vs 按资源编号
+ *
+ * 按路径（原来的做法）：每张牌拼出底图、小数字、花色、大数字四个路径字符串，
+ * 每个路径像Sprite::create(path)那样查两次字符串哈希表——FileUtils的完整路径缓存、TextureCache。
+ * 按编号（CardView::resolveAssets之后）：由点数、花色算出四个资源编号，直接查精灵帧表。
+ *
+ * 两种做法之后创建精灵节点的开销一样，这里只测取图片的部分，不依赖cocos2d。
+ *
+ * 用法：card_asset_bench [轮数=200000]（每轮创建一整副52张牌）
+ */
+#include "core/CardAssets.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+
+static const std::string kSearchPath = "/data/app/com.example.cardgame/assets/";
+
+/**
+ * 原来的路径拼接（CardView::getBigNumberImagePath等）
+ */
+static std::string buildNumberPath(const char* size, int cardFace, int cardSuit) {
+    return std::string("res1/number/") + size + "_" + CardAssets::getColorName(cardSuit) + "_" +
+           CardAssets::getFaceName(cardFace) + ".png";
+}
+
+static std::string buildSuitPath(int cardSuit) {
+    return "res1/suits/" + CardAssets::getSuitName(cardSuit) + ".png";
+}
+
+/**
+ * 模拟FileUtils::fullPathForFilename + TextureCache::addImage（都命中缓存）
+ */
+struct PathLookup {
+    std::unordered_map<std::string, std::string> fullPaths;     // 相对路径 -> 完整路径
+    std::unordered_map<std::string, const void*> textures;      // 完整路径 -> 纹理
+
+    const void* find(const std::string& path) const {
+        auto fullPath = fullPaths.find(path);
+        if (fullPath == fullPaths.end()) return nullptr;
+        auto texture = textures.find(fullPath->second);
+        return texture == textures.end() ? nullptr : texture->second;
+    }
+};
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 200000;
+    if (rounds <= 0) {
+        printf("usage: card_asset_bench [rounds]\n");
+        return 2;
+    }
+
+    // 两种做法查到的是同一批“纹理”（这里用路径表里的地址代替）
+    static int textures[CardAssets::kAssetCount];
+    const void* frames[CardAssets::kAssetCount];
+    PathLookup lookup;
+    for (int id = 0; id < CardAssets::kAssetCount; id++) {
+        std::string path = CardAssets::getPath(id);
+        lookup.fullPaths[path] = kSearchPath + path;
+        lookup.textures[kSearchPath + path] = &textures[id];
+        frames[id] = &textures[id];
+    }
+
+    const int cards = rounds * 52;
+    uintptr_t checksumByPath = 0, checksumById = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int suit = 0; suit < 4; suit++) {
+            for (int face = 1; face <= 13; face++) {
+                checksumByPath += (uintptr_t)lookup.find(CardAssets::getBackgroundPath());
+                checksumByPath += (uintptr_t)lookup.find(buildNumberPath("small", face, suit));
+                checksumByPath += (uintptr_t)lookup.find(buildSuitPath(suit));
+                checksumByPath += (uintptr_t)lookup.find(buildNumberPath("big", face, suit));
+            }
+        }
+    }
+    double pathSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    startTime = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int suit = 0; suit < 4; suit++) {
+            for (int face = 1; face <= 13; face++) {
+                checksumById += (uintptr_t)frames[CardAssets::kBackgroundId];
+                checksumById += (uintptr_t)frames[CardAssets::getSmallNumberId(face, suit)];
+                checksumById += (uintptr_t)frames[CardAssets::getSuitId(suit)];
+                checksumById += (uintptr_t)frames[CardAssets::getBigNumberId(face, suit)];
+            }
+        }
+    }
+    double idSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (checksumByPath != checksumById) {
+        printf("mismatch: path lookup and id lookup resolved different textures\n");
+        return 1;
+    }
+
+    double pathNanos = pathSeconds * 1e9 / cards;
+    double idNanos = idSeconds * 1e9 / cards;
+    printf("%d cards (4 images each)\n", cards);
+    printf("by path: %8.2f ns/card\n", pathNanos);
+    printf("by id:   %8.2f ns/card\n", idNanos);
+    printf("speedup: %8.1fx\n", idNanos > 0 ? pathNanos / idNanos : 0.0);
+    return 0;
+}
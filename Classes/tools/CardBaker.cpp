@@ -0,0 +1,283 @@
+/**
+ * card_baker - 预合成卡面：每张牌（52种点数、花色组合）和背面各合成一张图片
+ *
+ * 运行时CardView的分开模式是底图 + 小数字 + 花色 + 大数字四个精灵；
+ * 这里按同样的布局（core/CardAssets.h）离线合成整张卡面，CardView的预合成模式每张牌只用一个精灵。
+ * 先在原图分辨率下合成（和运行时子精灵跟着底图一起缩放的效果一样），再缩小到每个目标宽度
+ * （按面积平均，预乘alpha，边缘不发黑；放大时用双线性插值）。
+ *
+ * 用法：card_baker [-w 宽度,宽度...] -r <资源根目录> -o <输出目录>
+ *   -w <宽度列表>  输出卡面的像素宽度，逗号分隔（默认120,240，对应1倍、2倍分辨率）
+ *   -r <目录>      资源根目录（读取res1/card_general.png和res1/number/、res1/suits/下的图片）
+ *   -o <目录>      输出到<输出目录>/<宽度>/res1/baked/，比如out/120/res1/baked/heart_A.png
+ *
+ * 输出的图片可以再用atlas_packer打包（-r <输出目录>/<宽度>），精灵帧名字就是CardView使用的路径：
+ *   atlas_packer -r out/120 -o Resources/cards-baked out/120/res1/baked/<卡面>.png...（整个目录）
+ */
+#include "core/CardAssets.h"
+#include "PngImage.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+/**
+ * 逐级创建目录（已经存在不算失败）
+ */
+static bool makeDirectories(const std::string& path) {
+    for (size_t i = 1; i <= path.size(); i++) {
+        if (i < path.size() && path[i] != '/' && path[i] != '\\') continue;
+        std::string part = path.substr(0, i);
+#ifdef _WIN32
+        _mkdir(part.c_str());
+#else
+        mkdir(part.c_str(), 0755);
+#endif
+    }
+    FILE* probe = fopen((path + "/.probe").c_str(), "w");
+    if (!probe) return false;
+    fclose(probe);
+    remove((path + "/.probe").c_str());
+    return true;
+}
+
+/**
+ * 把图片以(centerX, centerY)为中心画到画布上（左上角为原点，alpha混合）
+ * 中心点不在整数像素上时四舍五入，和运行时精灵的位置最多差半个像素
+ */
+static void drawCentered(PngImage& canvas, const PngImage& image, double centerX, double centerY) {
+    int left = (int)std::lround(centerX - image.width / 2.0);
+    int top = (int)std::lround(centerY - image.height / 2.0);
+    for (int y = 0; y < image.height; y++) {
+        int canvasY = top + y;
+        if (canvasY < 0 || canvasY >= canvas.height) continue;
+        for (int x = 0; x < image.width; x++) {
+            int canvasX = left + x;
+            if (canvasX < 0 || canvasX >= canvas.width) continue;
+            const uint8_t* source = image.pixel(x, y);
+            uint8_t* target = canvas.pixel(canvasX, canvasY);
+            float sourceAlpha = source[3] / 255.0f;
+            if (sourceAlpha <= 0) continue;
+            float targetAlpha = target[3] / 255.0f;
+            float alpha = sourceAlpha + targetAlpha * (1 - sourceAlpha);
+            for (int c = 0; c < 3; c++) {
+                float color = (source[c] * sourceAlpha + target[c] * targetAlpha * (1 - sourceAlpha)) / alpha;
+                target[c] = (uint8_t)std::lround(color);
+            }
+            target[3] = (uint8_t)std::lround(alpha * 255.0f);
+        }
+    }
+}
+
+/**
+ * 一个方向上的缩放权重：目标像素i由源像素first[i]开始的若干个像素加权得到
+ */
+struct ResampleAxis {
+    std::vector<int> first;
+    std::vector<std::vector<float>> weights;
+};
+
+/**
+ * 缩小：目标像素覆盖的源像素范围按面积平均；放大：双线性插值
+ */
+static ResampleAxis buildAxis(int sourceSize, int targetSize) {
+    ResampleAxis axis;
+    axis.first.resize(targetSize);
+    axis.weights.resize(targetSize);
+    double scale = (double)sourceSize / targetSize;
+    for (int i = 0; i < targetSize; i++) {
+        std::vector<float>& weights = axis.weights[i];
+        if (scale >= 1.0) {
+            double begin = i * scale, end = (i + 1) * scale;
+            int first = (int)std::floor(begin);
+            int last = std::min(sourceSize - 1, (int)std::ceil(end) - 1);
+            axis.first[i] = first;
+            for (int s = first; s <= last; s++) {
+                double coverage = std::min(end, (double)s + 1) - std::max(begin, (double)s);
+                weights.push_back((float)(coverage / scale));
+            }
+        } else {
+            double center = (i + 0.5) * scale - 0.5;
+            int first = (int)std::floor(center);
+            float fraction = (float)(center - first);
+            if (first < 0) {
+                first = 0;
+                fraction = 0;
+            }
+            if (first >= sourceSize - 1) {
+                first = sourceSize - 1;
+                fraction = 0;
+            }
+            axis.first[i] = first;
+            weights.push_back(1 - fraction);
+            if (fraction > 0) weights.push_back(fraction);
+        }
+    }
+    return axis;
+}
+
+/**
+ * 缩放到目标大小（在预乘alpha的浮点数据上先横向、再纵向）
+ */
+static PngImage resample(const PngImage& source, int targetWidth, int targetHeight) {
+    std::vector<float> premultiplied((size_t)source.width * source.height * 4);
+    for (size_t i = 0; i < (size_t)source.width * source.height; i++) {
+        float alpha = source.pixels[i * 4 + 3] / 255.0f;
+        for (int c = 0; c < 3; c++) premultiplied[i * 4 + c] = source.pixels[i * 4 + c] / 255.0f * alpha;
+        premultiplied[i * 4 + 3] = alpha;
+    }
+
+    ResampleAxis axisX = buildAxis(source.width, targetWidth);
+    ResampleAxis axisY = buildAxis(source.height, targetHeight);
+
+    std::vector<float> horizontal((size_t)targetWidth * source.height * 4, 0.0f);
+    for (int y = 0; y < source.height; y++) {
+        for (int x = 0; x < targetWidth; x++) {
+            float* target = &horizontal[((size_t)y * targetWidth + x) * 4];
+            const std::vector<float>& weights = axisX.weights[x];
+            for (size_t k = 0; k < weights.size(); k++) {
+                const float* from = &premultiplied[((size_t)y * source.width + axisX.first[x] + k) * 4];
+                for (int c = 0; c < 4; c++) target[c] += from[c] * weights[k];
+            }
+        }
+    }
+
+    PngImage result;
+    result.resize(targetWidth, targetHeight);
+    for (int y = 0; y < targetHeight; y++) {
+        const std::vector<float>& weights = axisY.weights[y];
+        for (int x = 0; x < targetWidth; x++) {
+            float sum[4] = { 0, 0, 0, 0 };
+            for (size_t k = 0; k < weights.size(); k++) {
+                const float* from = &horizontal[((size_t)(axisY.first[y] + k) * targetWidth + x) * 4];
+                for (int c = 0; c < 4; c++) sum[c] += from[c] * weights[k];
+            }
+            uint8_t* target = result.pixel(x, y);
+            float alpha = std::min(1.0f, sum[3]);
+            for (int c = 0; c < 3; c++) {
+                float color = alpha > 0 ? sum[c] / alpha : 0.0f;
+                target[c] = (uint8_t)std::lround(std::min(1.0f, color) * 255.0f);
+            }
+            target[3] = (uint8_t)std::lround(alpha * 255.0f);
+        }
+    }
+    return result;
+}
+
+/**
+ * 按CardView的布局合成一张卡面（原图分辨率）
+ * 运行时子精灵的位置是y轴向上的，这里换算成左上角为原点
+ */
+static PngImage composeFace(const PngImage& background, const PngImage& smallNumber, const PngImage& suit,
+                            const PngImage& bigNumber) {
+    PngImage canvas = background;
+    double width = background.width;
+    double height = background.height;
+    drawCentered(canvas, smallNumber, CardAssets::kCornerInsetX, CardAssets::kCornerInsetY);
+    drawCentered(canvas, suit, width - CardAssets::kCornerInsetX, CardAssets::kCornerInsetY);
+    drawCentered(canvas, bigNumber, width / 2, height / 2);
+    return canvas;
+}
+
+static bool loadAsset(const std::string& root, const std::string& path, PngImage& image) {
+    if (image.read(root + "/" + path)) return true;
+    printf("cannot read %s/%s\n", root.c_str(), path.c_str());
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::string root;
+    std::string outputDir;
+    std::vector<int> widths = { 120, 240 };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            root = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            widths.clear();
+            for (const char* p = argv[++i]; *p;) {
+                char* end = nullptr;
+                long width = strtol(p, &end, 10);
+                if (end == p || width <= 0 || width > 8192) {
+                    widths.clear();
+                    break;
+                }
+                widths.push_back((int)width);
+                p = *end == ',' ? end + 1 : end;
+            }
+        } else {
+            outputDir.clear();
+            break;
+        }
+    }
+    if (root.empty() || outputDir.empty() || widths.empty()) {
+        printf("usage: card_baker [-w width,width...] -r resource_root -o output_dir\n");
+        return 2;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // 1. 读取底图、数字、花色
+    PngImage background;
+    if (!loadAsset(root, CardAssets::getBackgroundPath(), background)) return 1;
+    PngImage suits[4];
+    for (int suit = 0; suit < 4; suit++) {
+        if (!loadAsset(root, CardAssets::getSuitPath(suit), suits[suit])) return 1;
+    }
+    PngImage smallNumbers[2][14], bigNumbers[2][14];    // [0=红(方块) 1=黑(梅花)][点数]
+    for (int color = 0; color < 2; color++) {
+        int suit = color == 0 ? 1 : 0;
+        for (int face = 1; face <= 13; face++) {
+            if (!loadAsset(root, CardAssets::getSmallNumberPath(face, suit), smallNumbers[color][face])) return 1;
+            if (!loadAsset(root, CardAssets::getBigNumberPath(face, suit), bigNumbers[color][face])) return 1;
+        }
+    }
+
+    // 2. 原图分辨率下合成52张卡面，背面就是底图
+    std::vector<std::string> names;
+    std::vector<PngImage> faces;
+    for (int suit = 0; suit < 4; suit++) {
+        int color = (suit == 1 || suit == 2) ? 0 : 1;
+        for (int face = 1; face <= 13; face++) {
+            names.push_back(CardAssets::getBakedFacePath(face, suit));
+            faces.push_back(composeFace(background, smallNumbers[color][face], suits[suit], bigNumbers[color][face]));
+        }
+    }
+    names.push_back(CardAssets::getBakedBackPath());
+    faces.push_back(background);
+
+    // 3. 缩放到每个目标宽度并写文件
+    int files = 0;
+    for (int width : widths) {
+        int height = std::max(1, (int)std::lround((double)background.height * width / background.width));
+        std::string directory = outputDir + "/" + std::to_string(width);
+        for (size_t i = 0; i < faces.size(); i++) {
+            std::string path = directory + "/" + names[i];
+            if (!makeDirectories(path.substr(0, path.find_last_of('/')))) {
+                printf("cannot create directory for %s\n", path.c_str());
+                return 1;
+            }
+            PngImage scaled = resample(faces[i], width, height);
+            if (!scaled.write(path)) {
+                printf("cannot write %s\n", path.c_str());
+                return 1;
+            }
+            files++;
+        }
+        printf("%s: %zu images at %dx%d\n", directory.c_str(), faces.size(), width, height);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("%d files, %.3f s\n", files, seconds);
+    return 0;
+}
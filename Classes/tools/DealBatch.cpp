@@ -0,0 +1,45 @@
+/**
+ * deal_batch - 批量生成牌局种子
+ *
+ * 多线程检查一段连续的种子，留下满足筛选条件的种子，输出生成速度，
+ * 可选把种子写到文件（每行一个，十进制）。
+ * 关卡只需要保存种子，游戏里用GameController::startGameWithSeed还原。
+ *
+ * 用法：deal_batch [种子数=1000000] [线程数=CPU核数] [输出文件]
+ */
+#include "core/DealGenerator.h"
+#include "core/WorkStealingPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    uint64_t seedCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000ULL;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    const char* outputPath = argc > 3 ? argv[3] : nullptr;
+
+    WorkStealingPool pool(threads);
+    DealOptions options;
+    std::vector<uint64_t> seeds;
+
+    auto startTime = std::chrono::steady_clock::now();
+    DealGenerator::generateBatch(pool, 1, seedCount, options, seeds);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    printf("%llu seeds, %zu accepted, %d threads, %.3f s, %.0f deals/min\n",
+           (unsigned long long)seedCount, seeds.size(), pool.getThreadCount(), seconds,
+           seconds > 0 ? seedCount / seconds * 60.0 : 0.0);
+
+    if (outputPath) {
+        FILE* file = fopen(outputPath, "w");
+        if (!file) {
+            printf("cannot open %s\n", outputPath);
+            return 1;
+        }
+        for (uint64_t seed : seeds) {
+            fprintf(file, "%llu\n", (unsigned long long)seed);
+        }
+        fclose(file);
+    }
+    return 0;
+}
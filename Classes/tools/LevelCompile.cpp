@@ -0,0 +1,219 @@
+/**
+ * level_compiler - 把文本关卡编译成关卡包
+ *
+ * 多线程读取、解析、检查关卡文件（CSV或JSON，格式见core/LevelCompiler.h），
+ * 通过检查的关卡按输入顺序写入关卡包（core/LevelPack.h），有错误的关卡跳过。
+ * 每一关的检查结果可以写到CSV报告里，有关卡出错时返回1（构建失败）。
+ *
+ * 用法：level_compiler [选项] -o <输出关卡包> <关卡文件|@列表文件>...
+ *   -o <文件>      输出的关卡包
+ *   -r <文件>      每一关的检查报告（CSV）
+ *   -j <线程数>    默认CPU核数
+ *   -n <节点数>    检查能否获胜时求解器最多展开的节点数，0表示不检查（默认200000）
+ *   --strict       警告（卡牌重叠、超出范围、赢不了）也当作错误
+ *   @列表文件      每行一个关卡文件路径（关卡文件很多时避免命令行过长）
+ *
+ * .json结尾的文件按JSON解析，其余按CSV解析。
+ */
+#include "core/LevelCompiler.h"
+#include "core/LevelPack.h"
+#include "core/WorkStealingPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * LevelResult - 一个关卡文件的处理结果
+ */
+struct LevelResult {
+    bool parsed = false;        // 是否解析成功
+    bool accepted = false;      // 是否写入关卡包
+    int packIndex = -1;         // 在关卡包中的下标
+    std::string error;          // 读取/解析失败的原因
+    Deal deal;
+    LevelCheck check;
+};
+
+static bool readText(const std::string& path, std::string& text) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    text.clear();
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, count);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+static const char* solveName(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::SOLVED: return "solvable";
+        case SolveStatus::UNSOLVABLE: return "unsolvable";
+        case SolveStatus::LIMIT_REACHED: return "unknown";
+        default: return "unchecked";
+    }
+}
+
+/**
+ * 一关的问题描述（报告和错误输出用）
+ */
+static std::string describe(const LevelResult& result) {
+    if (!result.parsed) return result.error;
+    const LevelCheck& check = result.check;
+    std::string text;
+    if (check.invalidCards) text += std::to_string(check.invalidCards) + " invalid cards; ";
+    if (check.duplicates) text += std::to_string(check.duplicates) + " duplicate cards; ";
+    if (check.unreachable) text += std::to_string(check.unreachable) + " unreachable cards; ";
+    if (check.overlaps) text += std::to_string(check.overlaps) + " overlapping pairs; ";
+    if (check.outOfBounds) text += std::to_string(check.outOfBounds) + " cards out of bounds; ";
+    if (check.solve == SolveStatus::UNSOLVABLE) text += "unsolvable; ";
+    if (text.size() >= 2) text.resize(text.size() - 2);
+    return text;
+}
+
+static bool collectInputs(const char* argument, std::vector<std::string>& paths) {
+    if (argument[0] != '@') {
+        paths.push_back(argument);
+        return true;
+    }
+    std::string list;
+    if (!readText(argument + 1, list)) return false;
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t end = list.find('\n', start);
+        if (end == std::string::npos) end = list.size();
+        std::string line = list.substr(start, end - start);
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (!line.empty()) paths.push_back(line);
+        start = end + 1;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* outputPath = nullptr;
+    const char* reportPath = nullptr;
+    int threads = 0;
+    bool strict = false;
+    LevelCheckOptions options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            options.solverMaxNodes = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
+        } else if (!collectInputs(argv[i], paths)) {
+            printf("cannot read list %s\n", argv[i] + 1);
+            return 2;
+        }
+    }
+    if (!outputPath || paths.empty()) {
+        printf("usage: level_compiler [-r report.csv] [-j threads] [-n solver_nodes] [--strict] "
+               "-o out.pack <level files | @listfile>...\n");
+        return 2;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // 1. 并行读取、解析、检查（每个文件一个任务，结果按输入顺序保存）
+    std::vector<LevelResult> results(paths.size());
+    WorkStealingPool pool(threads);
+    pool.run((int)paths.size(), [&](int task, int) {
+        LevelResult& result = results[task];
+        std::string text;
+        if (!readText(paths[task], text)) {
+            result.error = "cannot open";
+            return;
+        }
+        result.parsed = LevelCompiler::parse(text, endsWith(paths[task], ".json"), result.deal, result.error);
+        if (result.parsed) {
+            LevelCompiler::check(result.deal, options, result.check);
+        }
+    });
+    double checkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // 2. 按输入顺序写关卡包
+    LevelPackWriter writer;
+    if (!writer.open(outputPath)) {
+        printf("cannot create %s\n", outputPath);
+        return 1;
+    }
+    int errors = 0, warnings = 0;
+    int solveCounts[4] = {};
+    for (size_t i = 0; i < results.size(); i++) {
+        LevelResult& result = results[i];
+        bool failed = !result.parsed || result.check.hasErrors() || (strict && result.check.hasWarnings());
+        if (result.parsed) {
+            solveCounts[(int)result.check.solve]++;
+            if (result.check.hasWarnings()) warnings++;
+        }
+        if (failed) {
+            errors++;
+            printf("%s: error: %s\n", paths[i].c_str(), describe(result).c_str());
+            continue;
+        }
+        result.packIndex = writer.getLevelCount();
+        result.accepted = writer.addLevel(result.deal);
+        if (!result.accepted) {
+            result.packIndex = -1;
+            printf("%s: cannot write level\n", paths[i].c_str());
+            errors++;
+        }
+    }
+    int levelCount = writer.getLevelCount();
+    bool written = writer.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // 3. 每一关的检查报告
+    if (reportPath) {
+        FILE* report = fopen(reportPath, "w");
+        if (!report) {
+            printf("cannot create %s\n", reportPath);
+            return 1;
+        }
+        fprintf(report, "file,status,pack_index,cards,invalid,duplicates,unreachable,overlaps,out_of_bounds,solve,solver_nodes,message\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const LevelResult& result = results[i];
+            const LevelCheck& check = result.check;
+            const char* status = result.accepted ? (check.hasWarnings() ? "warning" : "ok") : "error";
+            std::string message = describe(result);
+            for (char& c : message) {
+                if (c == ',' || c == '"') c = ' ';
+            }
+            fprintf(report, "%s,%s,%d,%d,%d,%d,%d,%d,%d,%s,%llu,%s\n", paths[i].c_str(), status, result.packIndex,
+                    check.cards, check.invalidCards, check.duplicates, check.unreachable, check.overlaps,
+                    check.outOfBounds, result.parsed ? solveName(check.solve) : "", (unsigned long long)check.solverNodes,
+                    message.c_str());
+        }
+        fclose(report);
+    }
+
+    printf("%zu files, %d levels written, %d errors, %d warnings; solvable %d, unsolvable %d, unknown %d\n",
+           paths.size(), levelCount, errors, warnings, solveCounts[(int)SolveStatus::SOLVED],
+           solveCounts[(int)SolveStatus::UNSOLVABLE], solveCounts[(int)SolveStatus::LIMIT_REACHED]);
+    printf("%d threads, check %.3f s, total %.3f s, %.0f files/s\n", pool.getThreadCount(), checkSeconds, seconds,
+           seconds > 0 ? paths.size() / seconds : 0.0);
+
+    if (!written) {
+        printf("cannot write %s\n", outputPath);
+        return 1;
+    }
+    return errors == 0 ? 0 : 1;
+}
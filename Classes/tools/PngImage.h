@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * PngImage - 命令行工具读写PNG用的RGBA图片（非预乘alpha，左上角为原点）
+ */
+struct PngImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;    // width * height * 4
+
+    /**
+     * 创建全透明的图片
+     */
+    void resize(int newWidth, int newHeight);
+
+    uint8_t* pixel(int x, int y) { return pixels.data() + ((size_t)y * width + x) * 4; }
+    const uint8_t* pixel(int x, int y) const { return pixels.data() + ((size_t)y * width + x) * 4; }
+
+    /**
+     * 读PNG（任何颜色格式都转成RGBA）
+     */
+    bool read(const std::string& path);
+
+    /**
+     * 写PNG（RGBA）
+     */
+    bool write(const std::string& path) const;
+};
@@ -0,0 +1,125 @@
+/**
+ * replay_tool - 回放文件的命令行工具
+ *
+ * play：无界面全速执行回放文件，检查结束局面和录制时是否一致，输出每秒执行的事件数。
+ *       用来复现玩家反馈的bug，也用来批量跑性能语料。
+ * record：用随机玩家（随机点击、偶尔回退/重做）生成回放文件，补充性能语料。
+ *
+ * 用法：replay_tool play [--trace <追踪文件>] <回放文件>...
+ *       replay_tool record <种子> <点击次数> <输出文件>
+ *
+ * --trace：执行完后把追踪记录导出成Chrome追踪格式（需要用CARDGAME_TRACE=ON编译，否则文件里没有记录）
+ */
+#include "core/Replay.h"
+#include "core/GameLogic.h"
+#include "core/Random.h"
+#include "core/Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static int playFiles(int count, char** paths) {
+    GameLogic logic;
+    std::vector<uint8_t> data;
+    int failures = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (!ReplayFormat::loadFile(paths[i], data)) {
+            printf("%s: cannot open\n", paths[i]);
+            failures++;
+            continue;
+        }
+
+        TRACE_ZONE("replay_tool::play");
+        ReplayStats stats;
+        auto startTime = std::chrono::steady_clock::now();
+        bool ok = ReplayPlayer::playHeadless(data.data(), data.size(), logic, &stats);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        const char* result = !ok ? "corrupt" : !stats.finished ? "unfinished" : stats.stateMatches ? "ok" : "MISMATCH";
+        printf("%s: %s, %zu bytes, %d events (%d clicks, %d moves, %d undo, %d redo, %d seek), "
+               "recorded %.1f s, replayed %.3f ms, %.0f events/s\n",
+               paths[i], result, data.size(), stats.events, stats.clicks, stats.appliedMoves,
+               stats.undos, stats.redos, stats.seeks, stats.durationMs / 1000.0, seconds * 1000.0,
+               seconds > 0 ? stats.events / seconds : 0.0);
+        if (!ok || (stats.finished && !stats.stateMatches)) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * 随机玩家：大部分时候从合法操作里随机选一张牌点击，偶尔点一张不合法的牌、回退或者重做，
+ * 没有合法操作时回退。点击间隔在100-900毫秒之间随机
+ */
+static int recordRandom(uint64_t seed, int clickCount, const char* outputPath) {
+    GameLogic logic;
+    Random random(seed);
+    DealOptions options;
+    Deal deal;
+    DealGenerator::generate(seed, options, deal);
+    deal.applyTo(logic.getModel());
+
+    ReplayRecorder recorder;
+    recorder.beginWithSeed(seed, options);
+
+    std::vector<Move> moves;
+    uint32_t timeMs = 0;
+    for (int i = 0; i < clickCount; i++) {
+        timeMs += (uint32_t)random.nextInt(100, 900);
+        int roll = random.nextInt(100);
+        if (logic.legalMoves(moves) == 0 || roll < 10) {
+            recorder.recordUndo(timeMs);
+            logic.undo();
+        } else if (roll < 15) {
+            recorder.recordRedo(timeMs);
+            logic.redo();
+        } else if (roll < 20) {
+            int cardId = random.nextInt(logic.getModel().peekNextCardId());
+            recorder.recordClick(cardId, timeMs);
+            Move move = logic.getMoveForCard(cardId);
+            if (move.isValid()) logic.applyMove(move);
+        } else {
+            const Move& move = moves[random.nextInt((int)moves.size())];
+            recorder.recordClick(move.cardId, timeMs);
+            logic.applyMove(move);
+        }
+    }
+    recorder.finish(logic.getModel(), timeMs);
+
+    if (!ReplayFormat::saveFile(outputPath, recorder.getData())) {
+        printf("cannot write %s\n", outputPath);
+        return 1;
+    }
+    printf("%s: seed %llu, %d clicks, %zu bytes\n", outputPath, (unsigned long long)seed, clickCount,
+           recorder.getData().size());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "play") == 0) {
+        const char* tracePath = nullptr;
+        int first = 2;
+        if (argc >= 5 && strcmp(argv[2], "--trace") == 0) {
+            tracePath = argv[3];
+            first = 4;
+        }
+        TRACE_THREAD_NAME("replay_tool");
+        int result = playFiles(argc - first, argv + first);
+        if (tracePath) {
+            int events = Trace::exportChromeJson(tracePath);
+            if (events < 0) {
+                printf("cannot write %s\n", tracePath);
+                return 1;
+            }
+            printf("%s: %d trace events%s\n", tracePath, events, CARDGAME_TRACE ? "" : " (built without CARDGAME_TRACE)");
+        }
+        return result;
+    }
+    if (argc == 5 && strcmp(argv[1], "record") == 0) {
+        return recordRandom(strtoull(argv[2], nullptr, 10), atoi(argv[3]), argv[4]);
+    }
+    printf("usage: replay_tool play [--trace out.json] <file>...\n"
+           "       replay_tool record <seed> <clicks> <outfile>\n");
+    return 2;
+}
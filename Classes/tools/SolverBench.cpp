@@ -0,0 +1,128 @@
+/**
+ * solver_bench - 求解器性能测试
+ *
+ * 用DealGenerator生成一批牌局（种子1~N，每次运行都一样），分别用单线程GameSolver和
+ * 1、2、4...N线程的ParallelGameSolver求解，输出耗时、每秒节点数和相对单线程的加速比，
+ * 并检查所有线程数得到的操作序列都一样。
+ *
+ * 用法：solver_bench [牌局数=20] [最大线程数=CPU核数] [每局节点上限=20000000]
+ */
+#include "core/GameSolver.h"
+#include "core/ParallelGameSolver.h"
+#include "core/GameLogic.h"
+#include "core/DealGenerator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * 测试用的牌局：整副52张，28张主牌区，24张底牌堆
+ */
+static DealOptions benchDealOptions() {
+    DealOptions options;
+    options.minCards = 52;
+    options.maxCards = 52;
+    options.minPlayfieldPercent = 54;
+    options.maxPlayfieldPercent = 54;
+    options.requireFirstMove = false;
+    return options;
+}
+
+/**
+ * 检查操作序列能在GameLogic上重放并获胜
+ */
+static bool replayWins(const GameModel& model, const std::vector<Move>& moves) {
+    GameLogic logic;
+    logic.getModel() = model;
+    for (const auto& move : moves) {
+        if (!logic.applyMove(move)) return false;
+    }
+    return logic.isWon();
+}
+
+static bool sameMoves(const std::vector<Move>& a, const std::vector<Move>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].type != b[i].type || a[i].cardId != b[i].cardId) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int gameCount = argc > 1 ? atoi(argv[1]) : 20;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : WorkStealingPool::getHardwareThreads();
+    SolverOptions options;
+    options.maxNodes = argc > 3 ? strtoull(argv[3], nullptr, 10) : 20000000ULL;
+    if (gameCount <= 0 || maxThreads <= 0) {
+        printf("usage: solver_bench [games] [maxThreads] [maxNodesPerGame]\n");
+        return 1;
+    }
+
+    std::vector<GameModel> games(gameCount);
+    DealOptions dealOptions = benchDealOptions();
+    for (int i = 0; i < gameCount; i++) {
+        Deal deal;
+        DealGenerator::generate((uint64_t)i + 1, dealOptions, deal);
+        deal.applyTo(games[i]);
+    }
+
+    // 单线程基准
+    std::vector<SolverResult> baseline(gameCount);
+    double baselineSeconds = 0.0;
+    uint64_t baselineNodes = 0;
+    int solved = 0;
+    int unsolvable = 0;
+    {
+        GameSolver solver(options);
+        for (int i = 0; i < gameCount; i++) {
+            baseline[i] = solver.solve(games[i]);
+            baselineSeconds += baseline[i].seconds;
+            baselineNodes += baseline[i].nodes;
+            if (baseline[i].status == SolveStatus::SOLVED) {
+                solved++;
+                if (!replayWins(games[i], baseline[i].moves)) {
+                    printf("game %d: solution does not replay\n", i);
+                    return 1;
+                }
+            } else if (baseline[i].status == SolveStatus::UNSOLVABLE) {
+                unsolvable++;
+            }
+        }
+    }
+    printf("%d games: %d solved, %d unsolvable, %d over node limit\n",
+           gameCount, solved, unsolvable, gameCount - solved - unsolvable);
+    printf("%-16s %10s %14s %12s %8s\n", "solver", "seconds", "nodes", "nodes/sec", "speedup");
+    printf("%-16s %10.3f %14llu %12.0f %8s\n", "GameSolver", baselineSeconds,
+           (unsigned long long)baselineNodes, baselineSeconds > 0 ? baselineNodes / baselineSeconds : 0.0, "1.00");
+
+    // 多线程：1, 2, 4, ... maxThreads
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    bool consistent = true;
+    for (int threads : threadCounts) {
+        ParallelGameSolver solver(threads, options);
+        double seconds = 0.0;
+        uint64_t nodes = 0;
+        for (int i = 0; i < gameCount; i++) {
+            SolverResult result = solver.solve(games[i]);
+            seconds += result.seconds;
+            nodes += result.nodes;
+            // 没有达到节点上限时，结果必须和单线程完全一样
+            bool comparable = baseline[i].status != SolveStatus::LIMIT_REACHED && result.status != SolveStatus::LIMIT_REACHED;
+            if (comparable && (result.status != baseline[i].status || !sameMoves(result.moves, baseline[i].moves))) {
+                printf("game %d: %d threads gave a different result\n", i, threads);
+                consistent = false;
+            }
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "Parallel x%d", threads);
+        printf("%-16s %10.3f %14llu %12.0f %8.2f\n", name, seconds, (unsigned long long)nodes,
+               seconds > 0 ? nodes / seconds : 0.0, seconds > 0 ? baselineSeconds / seconds : 0.0);
+    }
+
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/**
+ * tween_bench - 补间引擎的压力测试：不依赖cocos2d，用手动时钟推进
+ *
+ * 每轮开始一批补间（一部分中途改目标、交换完成回调、取消），再按60帧推进到全部结束，检查：
+ * - 没有取消的补间都停在终点，并且完成回调正好调用一次
+ * - 第一轮（容量扩到够用）之后，开始、改目标、取消、推进都不分配内存
+ * 最后输出每个补间每帧的更新耗时。
+ *
+ * 用法：tween_bench [轮数=1000] [每轮补间数=200]
+ */
+#include "core/TweenEngine.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// 统计内存分配次数（替换全局operator new）
+static std::atomic<long> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+struct Target {
+    float x = 0;
+    float y = 0;
+    int completions = 0;
+};
+
+static void applyPosition(void* target, float x, float y) {
+    Target* t = static_cast<Target*>(target);
+    t->x = x;
+    t->y = y;
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 1000;
+    int tweens = argc > 2 ? atoi(argv[2]) : 200;
+    if (rounds <= 1 || tweens <= 0) {
+        printf("usage: tween_bench [rounds>1] [tweens per round]\n");
+        return 2;
+    }
+
+    const float frame = 1.0f / 60;
+    const float duration = 0.3f;
+    TweenEngine engine(applyPosition);
+    std::vector<Target> targets(tweens);
+    std::vector<TweenEngine::TweenId> ids(tweens);
+
+    long steadyAllocations = 0;
+    long frames = 0;
+    long tweenUpdates = 0;
+    int errors = 0;
+    double updateSeconds = 0;
+
+    for (int round = 0; round < rounds; round++) {
+        long allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+
+        for (int i = 0; i < tweens; i++) {
+            Target* target = &targets[i];
+            target->completions = 0;
+            ids[i] = engine.start(target, 0, 0, (float)i, (float)round, duration, (TweenEase)(i % 5),
+                                  [target] { target->completions++; });
+        }
+        // 一部分改目标、交换完成回调（交换回来的旧回调放回去，保证只调用一次），一部分取消
+        for (int i = 0; i < tweens; i += 3) {
+            engine.retarget(ids[i], (float)i + 1, (float)round, duration);
+        }
+        std::function<void()> callback;
+        for (int i = 1; i < tweens; i += 5) {
+            engine.swapOnComplete(ids[i], callback);
+            engine.swapOnComplete(ids[i], callback);
+        }
+        for (int i = 0; i < tweens; i += 7) {
+            engine.cancel(ids[i]);
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        while (engine.getActiveCount() > 0) {
+            tweenUpdates += engine.getActiveCount();
+            engine.update(frame);
+            frames++;
+        }
+        updateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (round > 0) {
+            steadyAllocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+        }
+
+        for (int i = 0; i < tweens; i++) {
+            const Target& target = targets[i];
+            bool cancelled = i % 7 == 0;
+            float endX = i % 3 == 0 ? (float)i + 1 : (float)i;
+            if (cancelled ? target.completions != 0
+                          : (target.completions != 1 || target.x != endX || target.y != (float)round)) {
+                errors++;
+            }
+        }
+    }
+
+    printf("%d rounds x %d tweens, %ld frames\n", rounds, tweens, frames);
+    printf("update: %8.2f ns/tween/frame\n", tweenUpdates > 0 ? updateSeconds * 1e9 / tweenUpdates : 0.0);
+    printf("allocations after first round: %ld\n", steadyAllocations);
+    if (errors > 0) {
+        printf("errors: %d tweens ended at the wrong position or completed the wrong number of times\n", errors);
+    }
+    return errors == 0 && steadyAllocations == 0 ? 0 : 1;
+}
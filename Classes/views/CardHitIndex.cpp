@@ -0,0 +1,67 @@
+#include "CardHitIndex.h"
+#include "CardView.h"
+
+USING_NS_CC;
+
+static const float kHitCellSize = 64.0f;  // 网格大小：卡牌宽度（120）的一半左右
+
+CardHitIndex::CardHitIndex() : _grid(kHitCellSize), _arrival(0) {
+}
+
+CardView* CardHitIndex::hitTest(const Vec2& worldPos) const {
+    int handle = _grid.hitTest(worldPos.x, worldPos.y);
+    return handle >= 0 ? _cards[handle] : nullptr;
+}
+
+void CardHitIndex::addCard(CardView* cardView) {
+    if (cardView->_hitHandle >= 0) return;
+    cardView->_hitArrival = ++_arrival;
+    writeCard(cardView, true);
+}
+
+void CardHitIndex::removeCard(CardView* cardView) {
+    int handle = cardView->_hitHandle;
+    if (handle < 0) return;
+    _grid.remove(handle);
+    _cards[handle] = nullptr;
+    cardView->_hitHandle = -1;
+}
+
+void CardHitIndex::updateCard(CardView* cardView, bool reordered) {
+    if (cardView->_hitHandle < 0) return;
+    if (reordered) {
+        cardView->_hitArrival = ++_arrival;
+    }
+    writeCard(cardView, false);
+}
+
+/**
+ * 层级：区域(8位) | localZOrder(24位) | 加入的先后(32位)
+ * 隐藏的卡牌写成空矩形（点不到）
+ */
+void CardHitIndex::writeCard(CardView* cardView, bool insert) {
+    float minX = 1, minY = 1, maxX = 0, maxY = 0;
+    Node* parent = cardView->getParent();
+    if (parent && cardView->isVisible()) {
+        Vec2 center = parent->convertToWorldSpace(cardView->getPosition());
+        Size size = cardView->getCardSize();
+        minX = center.x - size.width / 2;
+        minY = center.y - size.height / 2;
+        maxX = minX + size.width;
+        maxY = minY + size.height;
+    }
+    
+    int zOrder = cardView->getLocalZOrder() + (1 << 23);
+    if (zOrder < 0) zOrder = 0;
+    if (zOrder > 0xFFFFFF) zOrder = 0xFFFFFF;
+    uint64_t order = (uint64_t)(cardView->_hitLayer & 0xFF) << 56 | (uint64_t)zOrder << 32 | cardView->_hitArrival;
+    
+    if (insert) {
+        int handle = _grid.insert(minX, minY, maxX, maxY, order);
+        if (handle >= (int)_cards.size()) _cards.resize(handle + 1, nullptr);
+        _cards[handle] = cardView;
+        cardView->_hitHandle = handle;
+    } else {
+        _grid.update(cardView->_hitHandle, minX, minY, maxX, maxY, order);
+    }
+}
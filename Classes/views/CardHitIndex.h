@@ -0,0 +1,58 @@
+#pragma once
+#include "cocos2d.h"
+#include "core/SpatialGrid.h"
+#include <vector>
+
+class CardView;
+
+/**
+ * @brief CardHitIndex - 卡牌点击检测的空间索引
+ * 
+ * GameView只注册一个触摸监听器，通过这个索引找到被点击的卡牌，
+ * 不再给每张卡牌注册监听器（每次触摸事件分发器都要排序、逐个检测所有卡牌的监听器）。
+ * 
+ * 索引里是卡牌在世界坐标中的矩形（SpatialGrid均匀网格），由卡牌自己增量维护：
+ * - 卡牌进入场景（onEnter）时登记，离开场景（onExit）时移除
+ * - 卡牌移动（包括动画的每一帧）、显示/隐藏、修改层级时更新
+ * 
+ * 层级和绘制顺序一致：先比较区域（后添加的区域在上面），再比较localZOrder，最后比较加入的先后
+ * （和cocos2d的orderOfArrival一样，修改localZOrder也算重新加入）。
+ * 区域（主牌区、底牌堆）本身不移动、不缩放。
+ */
+class CardHitIndex {
+public:
+    CardHitIndex();
+    
+    /**
+     * 点击检测
+     * @param worldPos 世界坐标
+     * @return 点到的最上层的卡牌，没有返回nullptr
+     */
+    CardView* hitTest(const cocos2d::Vec2& worldPos) const;
+    
+    /**
+     * 卡牌进入场景
+     */
+    void addCard(CardView* cardView);
+    
+    /**
+     * 卡牌离开场景
+     */
+    void removeCard(CardView* cardView);
+    
+    /**
+     * 卡牌的位置、显示状态变化
+     * @param reordered localZOrder是否变了（变了算重新加入）
+     */
+    void updateCard(CardView* cardView, bool reordered);
+
+private:
+    SpatialGrid _grid;
+    std::vector<CardView*> _cards;  // 句柄 -> 卡牌
+    uint32_t _arrival;              // 加入的计数
+    
+    /**
+     * 计算卡牌在世界坐标中的矩形和层级，写入网格
+     */
+    void writeCard(CardView* cardView, bool insert);
+};
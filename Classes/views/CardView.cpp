@@ -1,4 +1,8 @@
 #include "CardView.h"
+#include "CardHitIndex.h"
+#include "core/CardAssets.h"
+#include "core/Log.h"
+#include "core/Trace.h"
 #include "cocos2d.h"
 
 USING_NS_CC;
@@ -21,6 +25,124 @@ CardView* CardView::create(int cardFace, int cardSuit, bool isFaceUp) {
     return nullptr;
 }
 
+/**
+ * 按资源编号排列的卡牌精灵帧（resolveAssets取到并retain，一直保留到下一次resolveAssets）
+ * 创建、重置卡牌时直接按编号查表，不用拼图片路径、查SpriteFrameCache
+ */
+static SpriteFrame* s_assetFrames[CardAssets::kAssetCount] = {};
+static bool s_assetsResolved = false;
+
+static bool s_useBakedFaces = false;  // 新创建的卡牌视图是否使用预合成的卡面
+
+/**
+ * 释放查表用的精灵帧，之后重新从SpriteFrameCache取
+ */
+static void releaseCachedFrames() {
+    for (auto& frame : s_assetFrames) {
+        CC_SAFE_RELEASE_NULL(frame);
+    }
+    s_assetsResolved = false;
+}
+
+static const char* kBakedAtlasPrefix = "cards-baked";   // 预合成卡面图集
+static const char* kAtlasPrefix = "cards";              // 分开的精灵图集
+
+/**
+ * 图集第page页的文件名（不带扩展名）：<prefix>、<prefix>-1、<prefix>-2……
+ */
+static std::string getAtlasPage(const std::string& prefix, int page) {
+    return prefix + (page == 0 ? "" : "-" + std::to_string(page));
+}
+
+bool CardView::loadAtlas(const std::string& prefix) {
+    auto fileUtils = FileUtils::getInstance();
+    auto frameCache = SpriteFrameCache::getInstance();
+    int pages = 0;
+    while (true) {
+        std::string plist = getAtlasPage(prefix, pages) + ".plist";
+        if (!fileUtils->isFileExist(plist)) break;
+        frameCache->addSpriteFramesWithFile(plist);
+        pages++;
+    }
+    if (pages > 0) {
+        // 之前按单独图片取到的帧作废，改用图集里的同名帧
+        resolveAssets();
+    }
+    return pages > 0;
+}
+
+void CardView::loadCardImages() {
+    loadAtlas(kBakedAtlasPrefix);
+    if (!setUseBakedFaces(true)) {
+        loadAtlas(kAtlasPrefix);
+    }
+}
+
+/**
+ * 图集的纹理和plist同名（tools/AtlasPacker.cpp输出的textureFileName）
+ * 两种图集都预加载（loadCardImages用哪一种要加载plist之后才知道，两种都在时多加载的一份很小）
+ */
+void CardView::collectPreloadImages(std::vector<std::string>& paths) {
+    auto fileUtils = FileUtils::getInstance();
+    bool hasAtlas = false;
+    for (const char* prefix : { kBakedAtlasPrefix, kAtlasPrefix }) {
+        for (int page = 0; fileUtils->isFileExist(getAtlasPage(prefix, page) + ".plist"); page++) {
+            paths.push_back(getAtlasPage(prefix, page) + ".png");
+            hasAtlas = true;
+        }
+    }
+    if (hasAtlas) return;
+    for (int id = 0; id < CardAssets::kAssetCount; id++) {
+        const char* path = CardAssets::getPath(id);
+        if (fileUtils->isFileExist(path)) paths.push_back(path);
+    }
+}
+
+int CardView::resolveAssets() {
+    releaseCachedFrames();
+    int resolved = 0;
+    for (int id = 0; id < CardAssets::kAssetCount; id++) {
+        s_assetFrames[id] = getCardFrame(CardAssets::getPath(id));
+        if (s_assetFrames[id]) resolved++;
+    }
+    s_assetsResolved = true;
+    return resolved;
+}
+
+/**
+ * 预合成的背面能取到才切换（卡面缺的时候那张牌显示成空白，不会崩溃）
+ */
+bool CardView::setUseBakedFaces(bool useBakedFaces) {
+    if (useBakedFaces) {
+        if (!s_assetsResolved) resolveAssets();
+        if (!s_assetFrames[CardAssets::kBakedBackId]) return false;
+    }
+    s_useBakedFaces = useBakedFaces;
+    return true;
+}
+
+bool CardView::isUsingBakedFaces() {
+    return s_useBakedFaces;
+}
+
+/**
+ * 用精灵帧创建精灵（Sprite::create()会按名字查一次白色纹理，有帧时不走这条路）
+ */
+static Sprite* createFrameSprite(SpriteFrame* frame) {
+    return frame ? Sprite::createWithSpriteFrame(frame) : Sprite::create();
+}
+
+/**
+ * 设置精灵帧，图片不存在时让精灵什么都不画
+ */
+static void setFrameOrEmpty(Sprite* sprite, SpriteFrame* frame) {
+    if (frame) {
+        sprite->setSpriteFrame(frame);
+    } else {
+        sprite->setTextureRect(Rect(0, 0, 0, 0));
+    }
+}
+
 bool CardView::init(int cardFace, int cardSuit, bool isFaceUp) {
     if (!Node::init()) return false;
     
@@ -29,73 +151,105 @@ bool CardView::init(int cardFace, int cardSuit, bool isFaceUp) {
     _isFaceUp = isFaceUp;
     _cardId = -1;
     
-    // 卡牌底图
-    _bgSprite = Sprite::create("res1/card_general.png");
-    if (!_bgSprite) {
-        CCLOG("无法加载 card_general.png");
-        return false;
-    }
-    this->addChild(_bgSprite);
-    
-    // 获取卡牌尺寸（未缩放前）
-    Size cardSize = _bgSprite->getContentSize();
+    _baked = s_useBakedFaces;
+    if (!s_assetsResolved) resolveAssets();
     
-    // 左上角：小数字
-    std::string smallNumberPath = getSmallNumberImagePath(cardFace, cardSuit);
-    _smallNumberSprite = Sprite::create(smallNumberPath);
-    if (_smallNumberSprite) {
-        // 左上角位置：距离左边和顶部一定距离
-        _smallNumberSprite->setPosition(Vec2(50, cardSize.height - 60));
+    if (_baked) {
+        // 预合成模式：一个精灵显示整张卡面（或背面），没有子精灵
+        _bgSprite = createFrameSprite(s_assetFrames[CardAssets::kBakedBackId]);
+        _smallNumberSprite = nullptr;
+        _suitSprite = nullptr;
+        _bigNumberSprite = nullptr;
+        applyCardFrames();
+        this->addChild(_bgSprite);
+    } else {
+        // 卡牌底图
+        SpriteFrame* backgroundFrame = s_assetFrames[CardAssets::kBackgroundId];
+        if (!backgroundFrame) {
+            GAME_LOG_ERROR("无法加载 card_general.png");
+            return false;
+        }
+        _bgSprite = Sprite::createWithSpriteFrame(backgroundFrame);
+        this->addChild(_bgSprite);
+        
+        // 获取卡牌尺寸（未缩放前）
+        Size cardSize = _bgSprite->getContentSize();
+        
+        // 数字和花色精灵总是创建，精灵帧由applyCardFrames设置（重置时只换精灵帧）
+        _smallNumberSprite = createFrameSprite(s_assetFrames[CardAssets::getSmallNumberId(cardFace, cardSuit)]);
+        _suitSprite = createFrameSprite(s_assetFrames[CardAssets::getSuitId(cardSuit)]);
+        _bigNumberSprite = createFrameSprite(s_assetFrames[CardAssets::getBigNumberId(cardFace, cardSuit)]);
+        applyCardFrames();
+        
+        // 左上角：小数字，距离左边和顶部一定距离
+        _smallNumberSprite->setPosition(Vec2(CardAssets::kCornerInsetX, cardSize.height - CardAssets::kCornerInsetY));
         _bgSprite->addChild(_smallNumberSprite);
-    }
-    
-    // 右上角：花色
-    std::string suitPath = getSuitImagePath(_cardSuit);
-    _suitSprite = Sprite::create(suitPath);
-    if (_suitSprite) {
-        // 右上角位置：距离右边和顶部一定距离
-        _suitSprite->setPosition(Vec2(cardSize.width - 50, cardSize.height - 60));
+        
+        // 右上角：花色，距离右边和顶部一定距离
+        _suitSprite->setPosition(Vec2(cardSize.width - CardAssets::kCornerInsetX, cardSize.height - CardAssets::kCornerInsetY));
         _bgSprite->addChild(_suitSprite);
-    }
-    
-    // 中间：大数字
-    std::string bigNumberPath = getBigNumberImagePath(cardFace, cardSuit);
-    _bigNumberSprite = Sprite::create(bigNumberPath);
-    if (_bigNumberSprite) {
-        // 中间位置：卡牌中心
+        
+        // 中间：大数字，卡牌中心
         _bigNumberSprite->setPosition(Vec2(cardSize.width / 2, cardSize.height / 2));
         _bgSprite->addChild(_bigNumberSprite);
     }
     
-    // 缩放适配 - 调整卡牌大小使其更合理
-    float targetCardWidth = 120;  // 减小卡牌宽度，使其更合理
-    float scale = targetCardWidth / _bgSprite->getContentSize().width;
-    _bgSprite->setScale(scale);
-    
-    // 点击事件
-    auto listener = EventListenerTouchOneByOne::create();
-    listener->setSwallowTouches(true);  // 拦截触摸，确保点击的是正确的卡牌
-    listener->onTouchBegan = [this](Touch* touch, Event* event) {
-        if (!this->isVisible()) return false;
-        Vec2 worldPos = touch->getLocation();
-        Vec2 locationInNode = this->convertToNodeSpace(worldPos);
-        
-        // 获取卡牌的实际大小（考虑缩放）
-        Size s = _bgSprite->getContentSize() * _bgSprite->getScale();
-        Rect rect(-s.width / 2, -s.height / 2, s.width, s.height);
-        
-        if (rect.containsPoint(locationInNode)) {
-            onCardClicked();
-            return true;
-        }
-        return false;
-    };
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+    // 缩放适配：底图（预合成模式下是整张卡面）缩放到卡牌显示宽度
+    float width = _bgSprite->getContentSize().width;
+    if (width > 0) {
+        _bgSprite->setScale(CardAssets::kCardWidth / width);
+    }
     
     setFaceUp(isFaceUp);
     return true;
 }
 
+void CardView::reset(int cardFace, int cardSuit, bool isFaceUp) {
+    TRACE_ZONE("CardView::reset");
+    stopMoveAnimation();
+    if (cardFace != _cardFace || cardSuit != _cardSuit) {
+        _cardFace = cardFace;
+        _cardSuit = cardSuit;
+        applyCardFrames();
+    }
+    setFaceUp(isFaceUp);
+    setVisible(true);
+    setScale(1.0f);
+    setLocalZOrder(0);
+}
+
+/**
+ * 按点数、花色算出资源编号，查表设置精灵帧（点数、花色超出范围时按A、梅花处理）
+ * 预合成模式下只设置底图：正面用这张牌的卡面，背面用统一的背面
+ */
+void CardView::applyCardFrames() {
+    if (_baked) {
+        int id = _isFaceUp ? CardAssets::getBakedFaceId(_cardFace, _cardSuit) : CardAssets::kBakedBackId;
+        setFrameOrEmpty(_bgSprite, s_assetFrames[id]);
+        return;
+    }
+    
+    setFrameOrEmpty(_smallNumberSprite, s_assetFrames[CardAssets::getSmallNumberId(_cardFace, _cardSuit)]);
+    setFrameOrEmpty(_bigNumberSprite, s_assetFrames[CardAssets::getBigNumberId(_cardFace, _cardSuit)]);
+    setFrameOrEmpty(_suitSprite, s_assetFrames[CardAssets::getSuitId(_cardSuit)]);
+}
+
+SpriteFrame* CardView::getCardFrame(const std::string& path) {
+    auto frameCache = SpriteFrameCache::getInstance();
+    SpriteFrame* frame = frameCache->getSpriteFrameByName(path);
+    if (!frame) {
+        // 图片不存在时不交给TextureCache（避免每张缺少的图片都打印加载失败）
+        if (!FileUtils::getInstance()->isFileExist(path)) return nullptr;
+        Texture2D* texture = Director::getInstance()->getTextureCache()->addImage(path);
+        if (!texture) return nullptr;
+        Size size = texture->getContentSize();
+        frame = SpriteFrame::createWithTexture(texture, Rect(0, 0, size.width, size.height));
+        frameCache->addSpriteFrame(frame, path);
+    }
+    frame->retain();  // 清理SpriteFrameCache中没有使用的帧时不会被移除
+    return frame;
+}
+
 void CardView::setCardId(int cardId) {
     _cardId = cardId;
 }
@@ -109,85 +263,145 @@ void CardView::setOnClickCallback(const std::function<void(int)>& callback) {
 }
 
 void CardView::setFaceUp(bool isFaceUp) {
+    bool changed = isFaceUp != _isFaceUp;
     _isFaceUp = isFaceUp;
-    if (_suitSprite) {
-        _suitSprite->setVisible(isFaceUp);
+    if (_baked) {
+        // 预合成模式：换底图的精灵帧
+        if (changed) applyCardFrames();
+        return;
+    }
+    _suitSprite->setVisible(isFaceUp);
+    _bigNumberSprite->setVisible(isFaceUp);
+    _smallNumberSprite->setVisible(isFaceUp);
+}
+
+Size CardView::getCardSize() const {
+    return _bgSprite->getContentSize() * _bgSprite->getScale();
+}
+
+void CardView::setHitIndex(CardHitIndex* hitIndex, int layer) {
+    if (_hitIndex && _hitIndex != hitIndex) {
+        _hitIndex->removeCard(this);
+    }
+    _hitIndex = hitIndex;
+    _hitLayer = layer;
+    if (_hitIndex && isRunning()) {
+        // 已经在场景中：登记过的更新层级，没登记过的登记
+        if (_hitHandle >= 0) {
+            _hitIndex->updateCard(this, false);
+        } else {
+            _hitIndex->addCard(this);
+        }
+    }
+}
+
+void CardView::setPosition(float x, float y) {
+    Node::setPosition(x, y);
+    if (_hitHandle >= 0) {
+        _hitIndex->updateCard(this, false);
+    }
+}
+
+void CardView::setVisible(bool visible) {
+    bool changed = visible != isVisible();
+    Node::setVisible(visible);
+    if (changed && _hitHandle >= 0) {
+        _hitIndex->updateCard(this, false);
     }
-    if (_bigNumberSprite) {
-        _bigNumberSprite->setVisible(isFaceUp);
+}
+
+/**
+ * 修改localZOrder时cocos2d会重新计算加入的先后，索引里也一样
+ */
+void CardView::setLocalZOrder(int localZOrder) {
+    bool changed = localZOrder != getLocalZOrder();
+    Node::setLocalZOrder(localZOrder);
+    if (changed && _hitHandle >= 0) {
+        _hitIndex->updateCard(this, true);
     }
-    if (_smallNumberSprite) {
-        _smallNumberSprite->setVisible(isFaceUp);
+}
+
+void CardView::onEnter() {
+    Node::onEnter();
+    if (_hitIndex) {
+        _hitIndex->addCard(this);
     }
 }
 
+void CardView::onExit() {
+    if (_hitIndex) {
+        _hitIndex->removeCard(this);
+    }
+    Node::onExit();
+}
+
 void CardView::onCardClicked() {
     if (_onClickCallback) {
         _onClickCallback(_cardId);
     }
 }
 
-void CardView::playMoveAnimation(const cocos2d::Vec2& targetPos, std::function<void()> callback) {
-    auto moveAction = MoveTo::create(0.3f, targetPos);
-    if (callback) {
-        auto callbackAction = CallFunc::create(callback);
-        this->runAction(Sequence::create(moveAction, callbackAction, nullptr));
-    } else {
-        this->runAction(moveAction);
-    }
-}
-
-std::string CardView::getBigNumberImagePath(int cardFace, int cardSuit) {
-    std::string color = (cardSuit == 1 || cardSuit == 2) ? "red" : "black";
-    std::string faceStr;
-    switch (cardFace) {
-        case 1: faceStr = "A"; break;
-        case 2: faceStr = "2"; break;
-        case 3: faceStr = "3"; break;
-        case 4: faceStr = "4"; break;
-        case 5: faceStr = "5"; break;
-        case 6: faceStr = "6"; break;
-        case 7: faceStr = "7"; break;
-        case 8: faceStr = "8"; break;
-        case 9: faceStr = "9"; break;
-        case 10: faceStr = "10"; break;
-        case 11: faceStr = "J"; break;
-        case 12: faceStr = "Q"; break;
-        case 13: faceStr = "K"; break;
-        default: faceStr = "A"; break;
-    }
-    return "res1/number/big_" + color + "_" + faceStr + ".png";
-}
-
-std::string CardView::getSmallNumberImagePath(int cardFace, int cardSuit) {
-    std::string color = (cardSuit == 1 || cardSuit == 2) ? "red" : "black";
-    std::string faceStr;
-    switch (cardFace) {
-        case 1: faceStr = "A"; break;
-        case 2: faceStr = "2"; break;
-        case 3: faceStr = "3"; break;
-        case 4: faceStr = "4"; break;
-        case 5: faceStr = "5"; break;
-        case 6: faceStr = "6"; break;
-        case 7: faceStr = "7"; break;
-        case 8: faceStr = "8"; break;
-        case 9: faceStr = "9"; break;
-        case 10: faceStr = "10"; break;
-        case 11: faceStr = "J"; break;
-        case 12: faceStr = "Q"; break;
-        case 13: faceStr = "K"; break;
-        default: faceStr = "A"; break;
-    }
-    return "res1/number/small_" + color + "_" + faceStr + ".png";
-}
-
-std::string CardView::getSuitImagePath(int cardSuit) {
-    switch (cardSuit) {
-        case 0: return "res1/suits/club.png";
-        case 1: return "res1/suits/diamond.png";
-        case 2: return "res1/suits/heart.png";
-        case 3: return "res1/suits/spade.png";
-        default: return "res1/suits/club.png";
+static const float kMoveSeconds = 0.3f;                 // 移动动画时长
+static const int kTweenCapacity = 64;                   // 预先分配的补间数（一局最多52张牌同时移动）
+static const char* kTweenScheduleKey = "CardView::tweens";
+
+/**
+ * 补间引擎写回位置：走CardView::setPosition，同时更新点击检测的索引
+ */
+static void applyTweenPosition(void* target, float x, float y) {
+    static_cast<CardView*>(target)->setPosition(x, y);
+}
+
+TweenEngine& CardView::getTweenEngine() {
+    static TweenEngine engine(applyTweenPosition, kTweenCapacity);
+    static bool scheduled = false;
+    if (!scheduled) {
+        scheduled = true;
+        Director::getInstance()->getScheduler()->schedule([](float dt) {
+            TRACE_ZONE("CardView::updateTweens");
+            TweenEngine& tweens = getTweenEngine();
+            tweens.update(dt);
+            TRACE_COUNTER("tweens.active", tweens.getActiveCount());
+        }, &engine, 0, false, kTweenScheduleKey);
+    }
+    return engine;
+}
+
+CardView::~CardView() {
+    // 补间引用着这个视图，视图释放前必须取消
+    if (_moveTween != TweenEngine::kInvalidId) {
+        getTweenEngine().cancel(_moveTween);
     }
 }
 
+void CardView::playMoveAnimation(const cocos2d::Vec2& targetPos, std::function<void()> callback, TweenEase ease) {
+    TRACE_ZONE("CardView::playMoveAnimation");
+    TweenEngine& tweens = getTweenEngine();
+    // 正在移动：停下来从视图现在的位置重新开始（补间里的坐标可能是换区域前的）
+    // 上一次的移动没有播完，它的回调和stopMoveAnimation一样不调用（不能当成播放完成）
+    tweens.cancel(_moveTween);
+    const Vec2& position = getPosition();
+    _moveTween = tweens.start(this, position.x, position.y, targetPos.x, targetPos.y, kMoveSeconds,
+                              ease, std::move(callback));
+}
+
+bool CardView::retargetMoveAnimation(const cocos2d::Vec2& targetPos) {
+    TweenEngine& tweens = getTweenEngine();
+    float x, y;
+    if (!tweens.getTarget(_moveTween, x, y)) return false;
+    if (x != targetPos.x || y != targetPos.y) {
+        tweens.retarget(_moveTween, targetPos.x, targetPos.y, kMoveSeconds);
+    }
+    return true;
+}
+
+void CardView::stopMoveAnimation() {
+    if (_moveTween != TweenEngine::kInvalidId) {
+        getTweenEngine().cancel(_moveTween);
+        _moveTween = TweenEngine::kInvalidId;
+    }
+}
+
+bool CardView::isMoving() const {
+    return _moveTween != TweenEngine::kInvalidId && getTweenEngine().isActive(_moveTween);
+}
@@ -1,6 +1,11 @@
 #pragma once
 #include "cocos2d.h"
+#include "core/TweenEngine.h"
 #include <functional>
+#include <string>
+#include <vector>
+
+class CardHitIndex;
 
 /**
  * @brief CardView - 单张卡牌视图类
@@ -10,8 +15,8 @@
  * 
  * 职责：
  * - 显示卡牌的视觉元素（底图、数字、花色）
- * - 处理卡牌的点击事件
- * - 播放卡牌移动动画
+ * - 处理卡牌的点击事件（点击检测由GameView通过CardHitIndex统一处理）
+ * - 播放卡牌移动动画（所有卡牌的移动由一个TweenEngine统一更新）
  * - 管理卡牌的正反面状态
  * 
  * 使用场景：
@@ -41,6 +46,48 @@ public:
      */
     static CardView* create(int cardFace, int cardSuit, bool isFaceUp = true);
     
+    /**
+     * 加载卡牌图集（tools/AtlasPacker.cpp生成），要在创建卡牌视图之前调用
+     * 依次加载<prefix>.plist、<prefix>-1.plist……图集里的精灵帧以图片路径命名，
+     * 加载后所有卡牌精灵都使用图集里的帧，整桌卡牌共用纹理，绘制时自动合批
+     * @param prefix 图集文件前缀，比如"cards"
+     * @return false=没有找到图集（卡牌继续使用单独的图片）
+     */
+    static bool loadAtlas(const std::string& prefix);
+    
+    /**
+     * 加载卡牌图片：优先使用预合成卡面图集（cards-baked），没有时使用分开的精灵图集（cards），
+     * 都没有时使用单独的图片；要在创建卡牌视图之前调用
+     */
+    static void loadCardImages();
+    
+    /**
+     * loadCardImages会用到的图片（图集的每一页，没有图集时是单独的卡牌图片），用来预加载
+     * @param paths 输出：追加图片路径
+     */
+    static void collectPreloadImages(std::vector<std::string>& paths);
+    
+    /**
+     * 按资源编号（core/CardAssets.h）取到所有卡牌图片的精灵帧，保存在按编号排列的表里
+     * 启动时调用一次（loadAtlas之后会自动重新取），之后创建、重置卡牌只按编号查表，
+     * 不拼接路径、不查SpriteFrameCache/TextureCache；没有调用过时第一次创建卡牌视图会调用
+     * @return 取到的图片数（不存在的图片对应的帧为nullptr，比如没有预合成卡面时）
+     */
+    static int resolveAssets();
+    
+    /**
+     * 切换预合成卡面模式（tools/CardBaker.cpp生成卡面），之后新创建的卡牌视图都使用这个模式
+     * 预合成模式下每张卡牌只有一个精灵（整张卡面或背面），节点数和每帧的变换计算是分开模式的1/4
+     * @param useBakedFaces true=预合成卡面，false=底图+数字+花色分开的精灵
+     * @return false=取不到预合成的图片（模式不变）
+     */
+    static bool setUseBakedFaces(bool useBakedFaces);
+    
+    /**
+     * 是否使用预合成卡面
+     */
+    static bool isUsingBakedFaces();
+    
     /**
      * 初始化卡牌视图
      * @param cardFace 卡牌点数
@@ -50,6 +97,16 @@ public:
      */
     bool init(int cardFace, int cardSuit, bool isFaceUp);
     
+    /**
+     * 原地重置成另一张牌（对象池复用、重新开局时使用）
+     * 只替换数字、花色精灵的精灵帧，不重新创建节点、不读文件；
+     * 同时停止动画，恢复可见、缩放和层级。ID和点击回调不变
+     * @param cardFace 卡牌点数
+     * @param cardSuit 卡牌花色
+     * @param isFaceUp 是否正面朝上
+     */
+    void reset(int cardFace, int cardSuit, bool isFaceUp);
+    
     /**
      * 设置卡牌的唯一ID
      * @param cardId 卡牌ID，用于区分不同的卡牌
@@ -62,6 +119,12 @@ public:
      */
     int getCardId() const;
     
+    /**
+     * 获取卡牌的点数、花色（对比模型时判断是不是同一张牌）
+     */
+    int getCardFace() const { return _cardFace; }
+    int getCardSuit() const { return _cardSuit; }
+    
     /**
      * 设置卡牌被点击时的回调函数
      * @param callback 回调函数，参数是卡牌的ID
@@ -75,55 +138,111 @@ public:
      */
     void setFaceUp(bool isFaceUp);
     
+    /**
+     * 是否正面朝上
+     */
+    bool isFaceUp() const { return _isFaceUp; }
+    
+    /**
+     * 这个视图是否是预合成卡面模式（创建时决定，reset不会改变）
+     */
+    bool isBakedFaces() const { return _baked; }
+    
+    /**
+     * 卡牌缩放后的大小（点击检测使用）
+     */
+    cocos2d::Size getCardSize() const;
+    
+    /**
+     * 设置点击检测的空间索引（由所在的区域在添加卡牌时设置）
+     * 卡牌进入场景时登记到索引，离开场景时移除；移动、显示/隐藏、修改层级时更新索引
+     * @param hitIndex 空间索引
+     * @param layer 区域的层级，后添加的区域显示在上面，层级更高
+     */
+    void setHitIndex(CardHitIndex* hitIndex, int layer);
+    
+    /**
+     * 卡牌被点击（由GameView的触摸监听器调用）
+     * 会触发_onClickCallback回调，通知外部有卡牌被点击了
+     */
+    void onCardClicked();
+    
+    // 以下Node方法会改变点击区域，重写后同步更新点击检测的空间索引
+    using cocos2d::Node::setPosition;
+    virtual void setPosition(float x, float y) override;
+    virtual void setVisible(bool visible) override;
+    virtual void setLocalZOrder(int localZOrder) override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    
     /**
      * 播放卡牌移动动画
      * @param targetPos 目标位置，卡牌会平滑移动到这里
      * @param callback 动画完成后的回调函数（可选）
-     * 动画时长固定为0.3秒
+     * @param ease 缓动曲线，默认匀速
+     * 动画时长固定为0.3秒。卡牌正在移动时从现在的位置重新开始（卡牌可能刚换到另一个区域，坐标系变了），
+     * 上一次移动被打断，它的回调不再调用（和stopMoveAnimation一样）
+     */
+    void playMoveAnimation(const cocos2d::Vec2& targetPos, std::function<void()> callback = nullptr,
+                           TweenEase ease = TweenEase::LINEAR);
+    
+    /**
+     * 正在移动时改去新的目标（回调不变，目标没变时什么也不做），布局变化时使用
+     * @return false=没有在移动
+     */
+    bool retargetMoveAnimation(const cocos2d::Vec2& targetPos);
+    
+    /**
+     * 停止移动动画（停在当前位置，不调用回调）
      */
-    void playMoveAnimation(const cocos2d::Vec2& targetPos, std::function<void()> callback = nullptr);
+    void stopMoveAnimation();
+    
+    /**
+     * 是否正在播放移动动画
+     */
+    bool isMoving() const;
+    
+    /**
+     * 所有卡牌共用的补间引擎（第一次调用时创建，并注册到Director的Scheduler每帧更新）
+     */
+    static TweenEngine& getTweenEngine();
+    
+    virtual ~CardView();
 
 private:
     int _cardFace;      // 卡牌点数（1-13）
     int _cardSuit;      // 卡牌花色（0-3）
     int _cardId;        // 卡牌唯一ID，用于标识这张卡牌
     bool _isFaceUp;     // 是否正面朝上
+    bool _baked;        // 是否是预合成卡面模式（创建时决定）
     
-    // 卡牌的UI元素（都是Sprite精灵）
+    // 卡牌的UI元素（都是Sprite精灵），预合成模式下只有_bgSprite，显示整张卡面
     cocos2d::Sprite* _bgSprite;          // 卡牌底图（白色卡牌背景）
     cocos2d::Sprite* _suitSprite;        // 花色精灵（右上角，显示♣♦♥♠）
     cocos2d::Sprite* _bigNumberSprite;    // 大数字精灵（中间，显示A/2-10/J/Q/K）
     cocos2d::Sprite* _smallNumberSprite;  // 小数字精灵（左上角，显示A/2-10/J/Q/K）
     
     std::function<void(int)> _onClickCallback;  // 点击回调函数
+    TweenEngine::TweenId _moveTween = TweenEngine::kInvalidId;  // 正在播放的移动动画
     
-    /**
-     * 卡牌被点击时调用
-     * 会触发_onClickCallback回调，通知外部有卡牌被点击了
-     */
-    void onCardClicked();
-    
-    /**
-     * 获取大数字图片路径
-     * @param cardFace 卡牌点数
-     * @param cardSuit 卡牌花色（用于判断是红色还是黑色）
-     * @return 图片路径，如"res1/number/big_red_A.png"
-     */
-    std::string getBigNumberImagePath(int cardFace, int cardSuit);
+    // 点击检测（由CardHitIndex维护）
+    friend class CardHitIndex;
+    CardHitIndex* _hitIndex = nullptr;  // 空间索引
+    int _hitLayer = 0;                  // 所在区域的层级
+    int _hitHandle = -1;                // 在索引中的句柄，-1表示没有登记
+    uint32_t _hitArrival = 0;           // 加入索引的先后
     
     /**
-     * 获取小数字图片路径
-     * @param cardFace 卡牌点数
-     * @param cardSuit 卡牌花色（用于判断是红色还是黑色）
-     * @return 图片路径，如"res1/number/small_red_A.png"
+     * 按当前的点数、花色设置数字和花色精灵的精灵帧（预合成模式下设置整张卡面或背面）
      */
-    std::string getSmallNumberImagePath(int cardFace, int cardSuit);
+    void applyCardFrames();
     
     /**
-     * 获取花色图片路径
-     * @param cardSuit 卡牌花色
-     * @return 图片路径，如"res1/suits/heart.png"
+     * 获取一张卡牌图片的精灵帧（retain，由resolveAssets的表持有）
+     * 精灵帧以图片路径为名字放在SpriteFrameCache里，图集里有同名的帧时直接用图集的
+     * @param path 图片路径
+     * @return 精灵帧，图片不存在时返回nullptr
      */
-    std::string getSuitImagePath(int cardSuit);
+    static cocos2d::SpriteFrame* getCardFrame(const std::string& path);
 };
 
@@ -0,0 +1,68 @@
+#include "CardViewPool.h"
+#include "core/Trace.h"
+
+USING_NS_CC;
+
+CardViewPool::CardViewPool() : _hits(0), _misses(0) {
+}
+
+CardViewPool::~CardViewPool() {
+    clear();
+}
+
+void CardViewPool::prewarm(int count) {
+    _idle.reserve(count);
+    while ((int)_idle.size() < count) {
+        CardView* cardView = CardView::create(1, 0, true);
+        if (!cardView) return;
+        cardView->retain();
+        _idle.push_back(cardView);
+    }
+}
+
+CardView* CardViewPool::acquire(int cardFace, int cardSuit, bool isFaceUp, int cardId) {
+    TRACE_ZONE("CardViewPool::acquire");
+    CardView* cardView = nullptr;
+    bool useBakedFaces = CardView::isUsingBakedFaces();
+    while (!_idle.empty() && !cardView) {
+        cardView = _idle.back();
+        _idle.pop_back();
+        if (cardView->isBakedFaces() != useBakedFaces) {
+            // 预热之后切换了卡面模式：旧模式的视图不能reset成新模式，直接释放
+            cardView->release();
+            cardView = nullptr;
+        }
+    }
+    if (cardView) {
+        cardView->reset(cardFace, cardSuit, isFaceUp);
+        cardView->autorelease();  // 交出池子的引用，和CardView::create返回的一样
+        _hits++;
+    } else {
+        cardView = CardView::create(cardFace, cardSuit, isFaceUp);
+        if (!cardView) return nullptr;
+        _misses++;
+    }
+    cardView->setCardId(cardId);
+    return cardView;
+}
+
+void CardViewPool::release(CardView* cardView) {
+    if (!cardView) return;
+    cardView->retain();
+    cardView->stopMoveAnimation();
+    cardView->setCardId(-1);
+    cardView->setOnClickCallback(nullptr);
+    _idle.push_back(cardView);
+}
+
+void CardViewPool::clear() {
+    for (auto* cardView : _idle) {
+        cardView->release();
+    }
+    _idle.clear();
+}
+
+void CardViewPool::resetCounters() {
+    _hits = 0;
+    _misses = 0;
+}
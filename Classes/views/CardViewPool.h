@@ -0,0 +1,78 @@
+#pragma once
+#include "CardView.h"
+#include <vector>
+
+/**
+ * @brief CardViewPool - 卡牌视图对象池
+ * 
+ * 卡牌视图包含节点和精灵（分开模式是底图加三个子精灵，预合成模式一个精灵），每次创建、销毁的代价不小；
+ * 触摸由GameView统一的监听器处理，视图本身不带监听器。
+ * 对象池保存不再使用的视图，需要新视图时取出一个，用CardView::reset原地改成要显示的牌
+ * （只换精灵帧），池子空了才创建新的。
+ * 预热之后，重新开局、回退都不需要再创建节点。
+ * 
+ * 卡面模式：视图的预合成/分开模式在创建时决定，CardView::setUseBakedFaces应该在预热之前调用；
+ * 之后切换模式时，池子里模式不同的旧视图在acquire时丢掉，换成新创建的视图。
+ * 
+ * 引用计数：空闲的视图由池子持有一个引用；acquire返回的视图和CardView::create一样是autorelease的，
+ * 需要在本帧添加到父节点。归还时先release给池子，再从区域里移除。
+ * 
+ * 使用示例：
+ * CardView* cardView = pool.acquire(face, suit, true, cardId);
+ * playfieldView->addCard(cardView);
+ * ...
+ * pool.release(cardView);
+ * playfieldView->removeCard(cardView);
+ */
+class CardViewPool {
+public:
+    CardViewPool();
+    ~CardViewPool();
+    
+    /**
+     * 预先创建视图，让池子里至少有count个空闲视图
+     */
+    void prewarm(int count);
+    
+    /**
+     * 取出一个视图并重置成指定的牌（跳过并释放卡面模式和当前模式不同的空闲视图）
+     * @param cardFace 卡牌点数
+     * @param cardSuit 卡牌花色
+     * @param isFaceUp 是否正面朝上
+     * @param cardId 卡牌ID
+     * @return 视图（autorelease），创建失败返回nullptr
+     */
+    CardView* acquire(int cardFace, int cardSuit, bool isFaceUp, int cardId);
+    
+    /**
+     * 归还视图：池子持有一个引用，停止动画、清除ID和点击回调
+     * 调用者之后要把它从父节点移除
+     */
+    void release(CardView* cardView);
+    
+    /**
+     * 释放所有空闲视图
+     */
+    void clear();
+    
+    /**
+     * 命中：从池子里取出；未命中：池子空了，创建了新视图
+     */
+    int getHits() const { return _hits; }
+    int getMisses() const { return _misses; }
+    
+    /**
+     * 池子里空闲的视图数
+     */
+    int getIdleCount() const { return (int)_idle.size(); }
+    
+    /**
+     * 清零命中、未命中计数
+     */
+    void resetCounters();
+
+private:
+    std::vector<CardView*> _idle;   // 空闲的视图（池子持有引用）
+    int _hits;
+    int _misses;
+};
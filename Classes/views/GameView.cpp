@@ -1,6 +1,7 @@
 #include "GameView.h"
 #include "cocos2d.h"
 #include "ui/CocosGUI.h"
+#include "core/Trace.h"
 
 USING_NS_CC;  // 使用cocos2d命名空间
 using namespace ui;  // 使用UI命名空间（按钮等UI控件）
@@ -30,6 +31,7 @@ GameView* GameView::create() {
  * 2. 主牌区视图（显示桌面上的卡牌）
  * 3. 底牌堆视图（显示手牌区的卡牌）
  * 4. 回退按钮
+ * 5. 卡牌的触摸监听器
  * 
  * @return true=初始化成功, false=初始化失败
  */
@@ -44,21 +46,37 @@ bool GameView::init() {
     // 主牌区显示桌面上的卡牌，玩家可以点击这些卡牌与底牌匹配
     _playfieldView = PlayfieldView::create();
     _playfieldView->setPosition(Vec2(0, 580)); // 主牌区在上方（y=580，屏幕总高度2080）
+    _playfieldView->setHitIndex(&_cardHitIndex, 0);
     this->addChild(_playfieldView);
     
     // 创建底牌堆视图
     // 底牌堆显示手牌区的卡牌，包括备用底牌和当前使用的顶部底牌
     _stackView = StackView::create();
     _stackView->setPosition(Vec2(0, 0)); // 底牌堆在下方（y=0）
+    _stackView->setHitIndex(&_cardHitIndex, 1);  // 底牌堆后添加，显示在主牌区上面
     this->addChild(_stackView);
     
     // 创建回退按钮
     // 玩家点击这个按钮可以撤销上一步操作
     createUndoButton();
     
+    // 创建重做按钮
+    // 回退之后，玩家点击这个按钮可以重新执行被回退的操作
+    createRedoButton();
+    
+    // 所有卡牌共用一个触摸监听器
+    createCardTouchListener();
+    
     return true;
 }
 
+static const char* kBackgroundImage = "res1/back_ground.jpg";
+
+void GameView::collectPreloadImages(std::vector<std::string>& paths) {
+    paths.push_back(kBackgroundImage);
+    CardView::collectPreloadImages(paths);
+}
+
 /**
  * 创建背景图片
  * 
@@ -66,7 +84,7 @@ bool GameView::init() {
  */
 void GameView::createBackground() {
     // 创建背景精灵（Sprite）
-    auto bg = Sprite::create("res1/back_ground.jpg");
+    auto bg = Sprite::create(kBackgroundImage);
     if (bg) {
         // 设置背景位置为屏幕中心（1080x2080的中心点是540,1040）
         bg->setPosition(Vec2(540, 1040));
@@ -116,6 +134,60 @@ void GameView::createUndoButton() {
     this->addChild(_undoButton);
 }
 
+/**
+ * 创建重做按钮
+ * 
+ * 和回退按钮一样，放在回退按钮右边，默认隐藏，只有当有操作可以重做时才显示
+ */
+void GameView::createRedoButton() {
+    _redoButton = Button::create();
+    _redoButton->setTitleText("重做");
+    _redoButton->setTitleFontSize(30);
+    _redoButton->setPosition(Vec2(250, 2000));
+    _redoButton->setVisible(false);
+    
+    _redoButton->addTouchEventListener([this](Ref* sender, Widget::TouchEventType type) {
+        if (type == Widget::TouchEventType::ENDED) {
+            if (_onRedoClickCallback) {
+                _onRedoClickCallback();
+            }
+        }
+    });
+    
+    this->addChild(_redoButton);
+}
+
+/**
+ * 创建卡牌的触摸监听器
+ * 
+ * 整个场景只有这一个卡牌监听器（注册在场景上，按钮的监听器优先）。
+ * 按下时在空间索引里找最上层的卡牌，找到就通知这张卡牌被点击并吞掉这次触摸。
+ */
+void GameView::createCardTouchListener() {
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->setSwallowTouches(true);
+    listener->onTouchBegan = [this](Touch* touch, Event* event) {
+        TRACE_ZONE("GameView::onTouchBegan");
+        uint64_t touchTime = InputLatencyTracker::now();
+        CardView* cardView = _cardHitIndex.hitTest(touch->getLocation());
+        if (!cardView) return false;
+        if (_latencyTracker) {
+            _latencyTracker->beginInput(touchTime);
+        }
+        cardView->onCardClicked();
+        return true;
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+}
+
+/**
+ * 遍历场景树、生成绘制命令（追踪点：一帧里绘制前的耗时）
+ */
+void GameView::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) {
+    TRACE_ZONE("GameView::visit");
+    Scene::visit(renderer, parentTransform, parentFlags);
+}
+
 /**
  * 设置卡牌点击回调函数
  * 
@@ -162,3 +234,23 @@ void GameView::showUndoButton(bool visible) {
     }
 }
 
+
+/**
+ * 设置重做按钮点击回调函数
+ * 
+ * @param callback 回调函数，无参数
+ */
+void GameView::setOnRedoClickCallback(const std::function<void()>& callback) {
+    _onRedoClickCallback = callback;
+}
+
+/**
+ * 显示或隐藏重做按钮
+ * 
+ * @param visible true=显示按钮, false=隐藏按钮
+ */
+void GameView::showRedoButton(bool visible) {
+    if (_redoButton) {
+        _redoButton->setVisible(visible);
+    }
+}
@@ -3,19 +3,24 @@
 #include "ui/CocosGUI.h"
 #include "PlayfieldView.h"
 #include "StackView.h"
+#include "CardHitIndex.h"
+#include "core/InputLatencyTracker.h"
 #include <functional>
+#include <string>
+#include <vector>
 
 /**
  * @brief GameView - 游戏主视图类
  * 
  * 这是游戏的主视图，负责显示整个游戏界面。
  * 它包含主牌区视图（PlayfieldView）和底牌堆视图（StackView），
- * 以及回退按钮等UI元素。
+ * 以及回退、重做按钮等UI元素。
  * 
  * 职责：
  * - 创建和管理游戏的所有UI元素
  * - 协调主牌区和底牌堆的显示
  * - 处理用户交互事件（卡牌点击、回退按钮点击）
+ * - 卡牌点击统一由一个触摸监听器处理，通过CardHitIndex空间索引找到被点到的卡牌
  * - 管理回退按钮的显示/隐藏状态
  * 
  * 使用场景：
@@ -33,27 +38,51 @@ public:
     static GameView* create();
     virtual bool init();
     
+    /**
+     * 游戏界面用到的所有图片（背景、卡牌图集或卡牌图片），加载场景用来预加载
+     * @param paths 输出：追加图片路径
+     */
+    static void collectPreloadImages(std::vector<std::string>& paths);
+    
     // 设置卡牌点击回调
     void setOnCardClickCallback(const std::function<void(int)>& callback);
     
     // 设置回退按钮点击回调
     void setOnUndoClickCallback(const std::function<void()>& callback);
     
+    // 设置重做按钮点击回调
+    void setOnRedoClickCallback(const std::function<void()>& callback);
+    
     // 显示/隐藏回退按钮
     void showUndoButton(bool visible);
     
+    // 显示/隐藏重做按钮
+    void showRedoButton(bool visible);
+    
     // 获取视图
     PlayfieldView* getPlayfieldView() { return _playfieldView; }
     StackView* getStackView() { return _stackView; }
+    
+    // 设置输入延迟统计：触摸到卡牌时开始一次输入（nullptr表示不统计）
+    void setLatencyTracker(InputLatencyTracker* tracker) { _latencyTracker = tracker; }
+    
+    // 遍历场景树（加了追踪点，看绘制前遍历的耗时）
+    virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
 
 private:
     PlayfieldView* _playfieldView;              // 主牌区视图
     StackView* _stackView;                      // 底牌堆视图
+    CardHitIndex _cardHitIndex;                 // 所有卡牌的点击检测索引
+    InputLatencyTracker* _latencyTracker = nullptr;  // 输入延迟统计（控制器持有）
     cocos2d::ui::Button* _undoButton;          // 回退按钮
+    cocos2d::ui::Button* _redoButton;          // 重做按钮
     std::function<void(int)> _onCardClickCallback;   // 卡牌点击回调函数
     std::function<void()> _onUndoClickCallback;      // 回退按钮点击回调函数
+    std::function<void()> _onRedoClickCallback;      // 重做按钮点击回调函数
     
     void createBackground();
     void createUndoButton();
+    void createRedoButton();
+    void createCardTouchListener();
 };
 
@@ -1,5 +1,7 @@
 #include "PlayfieldView.h"
+#include "core/Trace.h"
 #include "cocos2d.h"
+#include <algorithm>
 
 USING_NS_CC;  // 使用cocos2d命名空间
 
@@ -41,16 +43,21 @@ bool PlayfieldView::init() {
  * 
  * 当需要显示一张新卡牌时，调用这个方法
  * 会将卡牌添加到主牌区的卡牌列表中，并添加到场景中显示
+ * 布局位置先用卡牌当前的位置，需要时再调用setCardPosition
  * 
  * @param cardView 要添加的卡牌视图
  */
 void PlayfieldView::addCard(CardView* cardView) {
+    TRACE_ZONE("PlayfieldView::addCard");
     if (!cardView) return;  // 如果卡牌为空，直接返回
     
     // 将卡牌添加到卡牌列表（vector）
     _cards.push_back(cardView);
+    _layoutPositions.push_back(cardView->getPosition());
     
     // 将卡牌添加到场景中，这样卡牌才能显示出来
+    // 先设置空间索引，卡牌进入场景时登记到索引里
+    cardView->setHitIndex(_hitIndex, _hitLayer);
     this->addChild(cardView);
     
     // 设置卡牌点击回调
@@ -71,18 +78,34 @@ void PlayfieldView::addCard(CardView* cardView) {
  * @param cardView 要移除的卡牌视图
  */
 void PlayfieldView::removeCard(CardView* cardView) {
+    TRACE_ZONE("PlayfieldView::removeCard");
     if (!cardView) return;  // 如果卡牌为空，直接返回
     
     // 在卡牌列表中找到这张卡牌
     auto it = std::find(_cards.begin(), _cards.end(), cardView);
     if (it != _cards.end()) {
         // 从列表中移除
+        _layoutPositions.erase(_layoutPositions.begin() + (it - _cards.begin()));
         _cards.erase(it);
         // 从场景中移除（这样卡牌就不会显示了）
         this->removeChild(cardView);
     }
 }
 
+/**
+ * 设置点击检测的空间索引
+ * 
+ * @param hitIndex 空间索引（GameView持有）
+ * @param layer 区域的层级，重叠时层级高的区域里的卡牌被点到
+ */
+void PlayfieldView::setHitIndex(CardHitIndex* hitIndex, int layer) {
+    _hitIndex = hitIndex;
+    _hitLayer = layer;
+    for (auto* cardView : _cards) {
+        cardView->setHitIndex(hitIndex, layer);
+    }
+}
+
 /**
  * 设置卡牌点击回调函数
  * 
@@ -113,3 +136,53 @@ CardView* PlayfieldView::findCardById(int cardId) const {
     return nullptr;  // 没找到，返回nullptr
 }
 
+/**
+ * 设置卡牌布局后的位置
+ * 
+ * 只记录位置并标记需要布局，同一帧多次设置时绘制前只设置一次
+ * 
+ * @param cardView 主牌区的卡牌视图（不在主牌区时忽略）
+ * @param position 布局后的位置
+ */
+void PlayfieldView::setCardPosition(CardView* cardView, const Vec2& position) {
+    auto it = std::find(_cards.begin(), _cards.end(), cardView);
+    if (it == _cards.end()) return;
+    Vec2& layoutPosition = _layoutPositions[it - _cards.begin()];
+    if (layoutPosition != position) {
+        layoutPosition = position;
+        setNeedsLayout();
+    }
+}
+
+/**
+ * 布局主牌区的卡牌：位置和布局位置不同时才设置（每次setPosition都要更新点击检测索引）
+ * 正在移动的卡牌改去布局位置，动画播完时正好停在那里
+ */
+void PlayfieldView::layoutCards() {
+    TRACE_ZONE("PlayfieldView::layoutCards");
+    _layoutDirty = false;
+    int updates = 0;
+    for (size_t i = 0; i < _cards.size(); i++) {
+        CardView* cardView = _cards[i];
+        const Vec2& position = _layoutPositions[i];
+        if (!cardView->retargetMoveAnimation(position) && cardView->getPosition() != position) {
+            cardView->setPosition(position);
+            ++updates;
+        }
+    }
+    _layoutUpdates = updates;
+    TRACE_COUNTER("playfield.layoutUpdates", updates);
+}
+
+/**
+ * 绘制前的统一布局（规则和StackView::visit一样）
+ */
+void PlayfieldView::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) {
+    if (_layoutDirty) {
+        layoutCards();
+    } else if (_layoutUpdates != 0) {
+        _layoutUpdates = 0;
+        TRACE_COUNTER("playfield.layoutUpdates", 0);
+    }
+    Node::visit(renderer, parentTransform, parentFlags);
+}
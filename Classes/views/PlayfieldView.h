@@ -15,6 +15,7 @@
  * - 处理卡牌的添加和移除
  * - 处理卡牌点击事件并传递给外部
  * - 提供根据ID查找卡牌的功能
+ * - 记录每张卡牌的布局位置（模型中的坐标），绘制前统一设置，只设置位置有变化的卡牌
  * 
  * 使用场景：
  * - 显示游戏开始时桌面上的卡牌
@@ -40,17 +41,40 @@ public:
     // 设置点击回调
     void setOnCardClickCallback(const std::function<void(int)>& callback);
     
+    // 设置点击检测的空间索引和这个区域的层级（添加的卡牌会登记到索引）
+    void setHitIndex(CardHitIndex* hitIndex, int layer);
+    
     // 获取所有卡牌
     const std::vector<CardView*>& getCards() const { return _cards; }
     
     // 根据ID查找卡牌
     CardView* findCardById(int cardId) const;
     
+    // 设置卡牌布局后的位置，会标记需要重新布局（正在移动的卡牌改去这个位置）
+    void setCardPosition(CardView* cardView, const cocos2d::Vec2& position);
+    
+    // 标记需要重新布局，在这一帧绘制前统一布局一次
+    void setNeedsLayout() { _layoutDirty = true; }
+    
+    // 最近一帧绘制前的布局设置了位置的卡牌数（那一帧没有布局时是0），不打开性能追踪也能读取
+    int getLastLayoutUpdateCount() const { return _layoutUpdates; }
+    
+    // 绘制前如果需要重新布局，先布局
+    virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
+    
     static const int kPlayfieldWidth = 1080;   // 主牌区宽度
     static const int kPlayfieldHeight = 1500;   // 主牌区高度
 
 private:
     std::vector<CardView*> _cards;
+    std::vector<cocos2d::Vec2> _layoutPositions;    // 每张卡牌布局后的位置（和_cards一一对应）
     std::function<void(int)> _onCardClickCallback;
+    CardHitIndex* _hitIndex = nullptr;  // 点击检测的空间索引（GameView持有）
+    int _hitLayer = 0;                  // 区域的层级
+    bool _layoutDirty = false;  // 是否需要在绘制前重新布局
+    int _layoutUpdates = 0;     // 最近一帧布局设置了位置的卡牌数
+    
+    // 布局卡牌（绘制前执行）
+    void layoutCards();
 };
 
@@ -1,4 +1,5 @@
 #include "StackView.h"
+#include "core/Trace.h"
 #include "cocos2d.h"
 #include <algorithm>
 
@@ -42,11 +43,12 @@ bool StackView::init() {
  * 
  * 当需要显示一张新卡牌时，调用这个方法
  * 会将卡牌添加到底牌堆的卡牌列表中，并添加到场景中显示
- * 添加后会自动重新布局所有卡牌
+ * 添加后会在这一帧绘制前重新布局所有卡牌
  * 
  * @param cardView 要添加的卡牌视图
  */
 void StackView::addCard(CardView* cardView) {
+    TRACE_ZONE("StackView::addCard");
     if (!cardView) return;  // 如果卡牌为空，直接返回
     
     // 将卡牌添加到卡牌列表（vector）
@@ -54,6 +56,8 @@ void StackView::addCard(CardView* cardView) {
     _cards.push_back(cardView);
     
     // 将卡牌添加到场景中，这样卡牌才能显示出来
+    // 先设置空间索引，卡牌进入场景时登记到索引里
+    cardView->setHitIndex(_hitIndex, _hitLayer);
     this->addChild(cardView);
     
     // 设置卡牌点击回调
@@ -65,9 +69,9 @@ void StackView::addCard(CardView* cardView) {
         }
     });
     
-    // 重新布局所有卡牌
-    // 因为添加了新卡牌，需要重新计算每张卡牌的位置
-    layoutCards();
+    // 标记需要重新布局
+    // 因为添加了新卡牌，需要重新计算每张卡牌的位置；一次添加多张牌时，绘制前只布局一次
+    setNeedsLayout();
 }
 
 /**
@@ -79,6 +83,7 @@ void StackView::addCard(CardView* cardView) {
  * @param cardView 要移除的卡牌视图
  */
 void StackView::removeCard(CardView* cardView) {
+    TRACE_ZONE("StackView::removeCard");
     if (!cardView) return;  // 如果卡牌为空，直接返回
     
     // 在卡牌列表中找到这张卡牌
@@ -91,6 +96,20 @@ void StackView::removeCard(CardView* cardView) {
     }
 }
 
+/**
+ * 设置点击检测的空间索引
+ * 
+ * @param hitIndex 空间索引（GameView持有）
+ * @param layer 区域的层级，重叠时层级高的区域里的卡牌被点到
+ */
+void StackView::setHitIndex(CardHitIndex* hitIndex, int layer) {
+    _hitIndex = hitIndex;
+    _hitLayer = layer;
+    for (auto* cardView : _cards) {
+        cardView->setHitIndex(hitIndex, layer);
+    }
+}
+
 /**
  * 设置卡牌点击回调函数
  * 
@@ -137,7 +156,7 @@ CardView* StackView::findCardById(int cardId) const {
 /**
  * 布局底牌堆中的所有卡牌
  * 
- * 这个方法会计算每张卡牌的位置并设置：
+ * 这个方法会计算每张卡牌的位置，位置或层级和现在不同时才设置：
  * - 主底牌（最后一张，顶部卡牌）：放在右边
  * - 备用底牌（前面的卡牌）：放在左边，垂直排列，不重叠以便点击
  * 
@@ -145,17 +164,66 @@ CardView* StackView::findCardById(int cardId) const {
  * 1. 最后一张卡牌是主底牌，放在右边固定位置
  * 2. 前面的卡牌是备用底牌，放在左边，垂直排列
  * 3. 卡牌之间不重叠，方便玩家点击
+ * 
+ * 没有变化的卡牌不设置：每次setPosition都要更新点击检测索引，setLocalZOrder还会让父节点重新排序子节点
  */
 void StackView::layoutCards() {
-    if (_cards.empty()) return;  // 如果没有卡牌，直接返回
+    TRACE_ZONE("StackView::layoutCards");
+    _layoutDirty = false;
+    int updates = 0;
     
+    // 遍历所有卡牌，设置每张卡牌的位置
+    for (size_t i = 0; i < _cards.size(); i++) {
+        CardView* cardView = _cards[i];
+        // 设置卡牌位置（正在移动的卡牌改去新的位置，动画播完时正好停在布局的位置）
+        Vec2 position = getLayoutPosition((int)i);
+        if (!cardView->retargetMoveAnimation(position) && cardView->getPosition() != position) {
+            cardView->setPosition(position);
+            ++updates;
+        }
+        
+        // 设置层级（z-order），确保主底牌在最上层（显示在最前面）
+        // 索引越大，层级越高，显示越靠前
+        if (cardView->getLocalZOrder() != (int)i) {
+            cardView->setLocalZOrder((int)i);
+            ++updates;
+        }
+    }
+    _layoutUpdates = updates;
+    TRACE_COUNTER("stack.layoutUpdates", updates);
+}
+
+/**
+ * 绘制前的统一布局
+ * 这一帧里所有的添加、调整顺序只标记了需要布局，在这里统一布局一次
+ * 不需要布局的帧计数归零（只在上一次不为0时记录一次）
+ */
+void StackView::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) {
+    if (_layoutDirty) {
+        layoutCards();
+    } else if (_layoutUpdates != 0) {
+        _layoutUpdates = 0;
+        TRACE_COUNTER("stack.layoutUpdates", 0);
+    }
+    Node::visit(renderer, parentTransform, parentFlags);
+}
+
+/**
+ * 计算第index张卡牌布局后的位置
+ * 
+ * 布局规则见layoutCards()：
+ * - 最后一张是主底牌，放在右边固定位置
+ * - 前面的备用底牌放在左边，垂直排列并整体居中
+ * 
+ * @param index 卡牌在底牌堆中的索引
+ * @return 卡牌的位置坐标
+ */
+cocos2d::Vec2 StackView::getLayoutPosition(int index) const {
     // 主底牌在右边，备用底牌在左边
     // 最后一张卡牌是主底牌（顶部），放在右边
     // 前面的卡牌是备用底牌，放在左边，不重叠以便点击
     
     float centerY = kStackHeight / 2;  // 底牌区垂直中心
-    float cardWidth = 120.0f;  // 卡牌宽度（缩放后）
-    float cardSpacing = 130.0f;  // 卡牌间距（未使用，但保留以备后用）
     
     // 主底牌位置（右边，距离右边缘200像素）
     Vec2 mainCardPos = Vec2(kStackWidth - 200, centerY);
@@ -173,76 +241,57 @@ void StackView::layoutCards() {
     // 起始Y坐标：从中心向上偏移，让卡牌垂直居中
     float startY = centerY - totalHeight / 2 + cardHeight / 2;
     
-    // 遍历所有卡牌，设置每张卡牌的位置
-    for (size_t i = 0; i < _cards.size(); i++) {
-        Vec2 pos;
-        
-        if (i == _cards.size() - 1) {
-            // 最后一张是主底牌，放在右边固定位置
-            pos = mainCardPos;
-        } else {
-            // 备用底牌放在左边，垂直排列
-            // 每张卡牌的Y坐标 = 起始Y + 索引 * 垂直间距
-            float offsetY = verticalSpacing * (float)i;
-            pos = Vec2(leftStartX, startY + offsetY);
-        }
-        
-        // 设置卡牌位置
-        _cards[i]->setPosition(pos);
-        
-        // 设置层级（z-order），确保主底牌在最上层（显示在最前面）
-        // 索引越大，层级越高，显示越靠前
-        _cards[i]->setLocalZOrder((int)i);
+    if (index >= reserveCardCount) {
+        // 最后一张是主底牌，放在右边固定位置
+        return mainCardPos;
     }
+    
+    // 备用底牌放在左边，垂直排列
+    // 每张卡牌的Y坐标 = 起始Y + 索引 * 垂直间距
+    float offsetY = verticalSpacing * (float)index;
+    return Vec2(leftStartX, startY + offsetY);
 }
 
 /**
- * 获取顶部卡牌的位置
+ * 调整卡牌在底牌堆中的顺序
  * 
- * 返回顶部卡牌应该显示的位置（底牌区中心）
+ * 只修改卡牌列表的顺序，不会重新布局，调用者在合适的时候调用setNeedsLayout()
  * 
- * @return 顶部卡牌的位置坐标
+ * @param cardView 要调整的卡牌视图
+ * @param index 新的索引，超出范围时放到顶部
  */
-cocos2d::Vec2 StackView::getTopCardPosition() const {
-    // 顶部卡牌位置在底牌区中心
-    return cocos2d::Vec2(kStackWidth / 2, kStackHeight / 2);
+void StackView::moveCardToIndex(CardView* cardView, int index) {
+    auto it = std::find(_cards.begin(), _cards.end(), cardView);
+    if (it == _cards.end()) return;
+    
+    _cards.erase(it);
+    if (index < 0 || index > (int)_cards.size()) {
+        index = (int)_cards.size();
+    }
+    _cards.insert(_cards.begin() + index, cardView);
+}
+
+/**
+ * 按新的顺序排列卡牌
+ * 视图同步时一次给出整个底牌堆的顺序，避免逐张调用moveCardToIndex
+ *
+ * @param order 新的顺序（必须和当前的卡牌是同一组）
+ */
+void StackView::setCardOrder(const std::vector<CardView*>& order) {
+    if (order.size() != _cards.size() || order == _cards) return;
+    _cards = order;
+    setNeedsLayout();
 }
 
 /**
- * 根据世界坐标查找被点击的卡牌
+ * 获取顶部卡牌的位置
  * 
- * 当玩家点击屏幕时，传入世界坐标（屏幕坐标）
- * 这个方法会检查哪张卡牌被点击了
- * 从最上层（最后添加的卡牌）开始检查，这样点击重叠的卡牌时会选中最上层的
+ * 返回顶部卡牌应该显示的位置（底牌区中心）
  * 
- * @param worldPos 世界坐标（屏幕坐标）
- * @return 被点击的卡牌视图，如果没点击到任何卡牌返回nullptr
+ * @return 顶部卡牌的位置坐标
  */
-CardView* StackView::findCardAtPosition(const cocos2d::Vec2& worldPos) const {
-    // 从最上层（最后添加的卡牌）开始检查
-    // rbegin()和rend()是反向迭代器，从后往前遍历
-    for (auto it = _cards.rbegin(); it != _cards.rend(); ++it) {
-        CardView* card = *it;
-        // 如果卡牌不存在或不可见，跳过
-        if (!card || !card->isVisible()) continue;
-        
-        // 将世界坐标转换为卡牌的本地坐标
-        // 因为卡牌的位置是相对于父节点的，需要转换坐标系统
-        Vec2 locationInCard = card->convertToNodeSpace(worldPos);
-        
-        // 获取卡牌的实际大小（考虑缩放）
-        // 注意：这里简化处理，假设卡牌大小固定
-        // 实际应该从CardView获取真实大小
-        float cardWidth = 120.0f;  // 卡牌宽度（缩放后）
-        float cardHeight = 170.0f;  // 卡牌高度（缩放后）
-        // 创建卡牌的矩形区域（以卡牌中心为原点）
-        Rect cardRect(-cardWidth / 2, -cardHeight / 2, cardWidth, cardHeight);
-        
-        // 检查点击位置是否在卡牌矩形内
-        if (cardRect.containsPoint(locationInCard)) {
-            return card;  // 找到了，返回这张卡牌
-        }
-    }
-    return nullptr;  // 没找到，返回nullptr
+cocos2d::Vec2 StackView::getTopCardPosition() const {
+    // 顶部卡牌位置在底牌区中心
+    return cocos2d::Vec2(kStackWidth / 2, kStackHeight / 2);
 }
 
@@ -26,7 +26,7 @@
  * - 继承自cocos2d::Node，可以添加到场景中
  * - 通过回调函数与GameController通信
  * - 使用vector存储所有卡牌视图的指针，最后一张是顶部卡牌
- * - 自动管理卡牌的布局和层级
+ * - 自动管理卡牌的布局和层级：修改只标记需要布局，绘制前统一布局一次，只设置位置、层级有变化的卡牌
  */
 class StackView : public cocos2d::Node {
 public:
@@ -42,6 +42,9 @@ public:
     // 设置点击回调
     void setOnCardClickCallback(const std::function<void(int)>& callback);
     
+    // 设置点击检测的空间索引和这个区域的层级（添加的卡牌会登记到索引）
+    void setHitIndex(CardHitIndex* hitIndex, int layer);
+    
     // 获取顶部卡牌
     CardView* getTopCard() const;
     
@@ -52,11 +55,23 @@ public:
     // 根据ID查找卡牌
     CardView* findCardById(int cardId) const;
     
-    // 布局卡牌
-    void layoutCards();
+    // 标记需要重新布局，在这一帧绘制前统一布局一次（同一帧多次修改只布局一次）
+    void setNeedsLayout() { _layoutDirty = true; }
+    
+    // 按新的顺序排列卡牌（order必须和当前的卡牌是同一组），会标记需要重新布局
+    void setCardOrder(const std::vector<CardView*>& order);
+    
+    // 绘制前如果需要重新布局，先布局
+    virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
     
-    // 根据点击位置找到被点击的卡牌（从最上层开始检查）
-    CardView* findCardAtPosition(const cocos2d::Vec2& worldPos) const;
+    // 最近一帧绘制前的布局设置了位置、层级的卡牌数（那一帧没有布局时是0），不打开性能追踪也能读取
+    int getLastLayoutUpdateCount() const { return _layoutUpdates; }
+    
+    // 获取第index张卡牌布局后的位置（和layoutCards的规则一致）
+    cocos2d::Vec2 getLayoutPosition(int index) const;
+    
+    // 调整卡牌在底牌堆中的顺序（index超出范围时放到顶部）
+    void moveCardToIndex(CardView* cardView, int index);
     
     static const int kStackWidth = 1080;   // 底牌堆宽度
     static const int kStackHeight = 580;   // 底牌堆高度
@@ -64,6 +79,13 @@ public:
 private:
     std::vector<CardView*> _cards;
     std::function<void(int)> _onCardClickCallback;
+    CardHitIndex* _hitIndex = nullptr;  // 点击检测的空间索引（GameView持有）
+    int _hitLayer = 0;                  // 区域的层级
+    bool _layoutDirty = false;  // 是否需要在绘制前重新布局
+    int _layoutUpdates = 0;     // 最近一帧布局设置了位置、层级的卡牌数
+    
+    // 布局卡牌（绘制前执行）
+    void layoutCards();
     
     // 顶部卡牌位置
     cocos2d::Vec2 getTopCardPosition() const;